@@ -0,0 +1,110 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// parse, semantic pass and teardown time of the AST, and the peak RSS of the process,
+// on a generated corpus of functions, variables, prints, ifs and loops
+// usage: bench_ast [functions (default 100000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/log.hpp"
+#include "../src/includes/semantic_visitor.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generateCorpus(std::size_t functions)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        code += "def function_" + id + ":func(first:int32, second:float64) -> [\n";
+        code += "    def total_" + id + ":int32 := 20 * 3 / 2 * 7\n";
+        code += "    def ratio_" + id + ":float64 := 1.5 * 2.25 / 3.0\n";
+        code += "    def label_" + id + ":charseq := \"label \" + \"number\"\n";
+        code += "    printnl(\"generated function\")\n";
+        code += "    if (first == 3) -> [\n";
+        code += "        print(\"three\")\n";
+        code += "    ]\n";
+        code += "    loop (true) -> [\n";
+        code += "        printnl(\"again\")\n";
+        code += "    ]\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+static double peakRssMb()
+{
+#if defined(__linux__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0; // KB on linux
+#else
+    return 0;
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    std::string code = generateCorpus(functions);
+
+    Lexer lexer(code);
+    TokenStream tokens(code);
+    lexer.tokenize(tokens);
+    double rss_tokens = peakRssMb();
+
+    Bench::Timer parse_timer;
+    auto arena = std::make_unique<AstArena>();
+    Parser parser(tokens, *arena);
+    std::vector<ASTPtr> nodes = parser.Parse();
+    double parse_time = parse_timer.seconds();
+
+    Bench::Timer semantic_timer;
+    SemanticAnalyzer analyzer;
+    for (ASTPtr stmts : nodes)
+        analyzer.VisitNode(stmts);
+    double semantic_time = semantic_timer.seconds();
+    double rss_peak = peakRssMb();
+
+    Bench::Timer free_timer;
+    nodes.clear();
+    arena.reset();
+    double free_time = free_timer.seconds();
+
+    if (Log::LogErrors::getInstance().getErrSize() != 0)
+        Log::LogErrors::getInstance().printAll();
+
+    std::printf("source: %.1f MB, %zu functions, %zu top level nodes\n", Bench::megabytes(code.size()), functions, functions);
+    std::printf("parse:    %9.2f ms\n", parse_time * 1e3);
+    std::printf("semantic: %9.2f ms\n", semantic_time * 1e3);
+    std::printf("teardown: %9.2f ms\n", free_time * 1e3);
+    std::printf("peak RSS: %9.2f MB (%.2f MB after lexing)\n", rss_peak, rss_tokens);
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// cold vs warm startup of a run: lex, parse, fold, check and store the entry of the AST cache,
+// against loading the entry (mapped) and expanding the tree on the arena
+// usage: bench_ast_cache [functions (default 50000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/ast_cache.hpp"
+#include "../src/includes/const_folder.hpp"
+#include "../src/includes/flat_ast.hpp"
+#include "../src/includes/semantic_visitor.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generated(std::size_t functions)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        code += "def function_" + id + ":func(first:int32, second:float64) -> [\n";
+        code += "    def total_" + id + ":int32 := 20 * 3 - 7\n";
+        code += "    def label_" + id + ":charseq := \"label $[first]\"\n";
+        code += "    if (first != 23) -> [\n";
+        code += "        printnl(\"not twenty three\")\n";
+        code += "    ]\n";
+        code += "    loop (true) -> [\n";
+        code += "        print(\"again\")\n";
+        code += "    ]\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    std::string code = generated(functions);
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "rhythin_bench_cache";
+    std::filesystem::remove_all(dir);
+    AstCache cache(dir);
+
+    std::size_t cold_nodes = 0, warm_nodes = 0;
+    double cold = Bench::bestOf(3, [&] {
+        TokenStream tokens(code);
+        Lexer(code).tokenize(tokens);
+        AstArena arena;
+        Parser parser(tokens, arena);
+        std::vector<ASTPtr> nodes = parser.Parse();
+        ConstantFolder folder(arena);
+        for (ASTPtr &node : nodes)
+            node = folder.fold(node);
+        SemanticAnalyzer analyzer;
+        for (ASTPtr node : nodes)
+            analyzer.VisitNode(node);
+
+        FlatAst flat;
+        for (ASTPtr node : nodes)
+            flat.append(node);
+        cache.store(code, flat, {});
+        cold_nodes = flat.size();
+    });
+
+    bool hit = true;
+    double warm = Bench::bestOf(3, [&] {
+        FlatAst flat;
+        std::vector<Log::LogErrors::Held> warnings;
+        hit = hit && cache.load(code, flat, warnings);
+        AstArena arena;
+        for (uint32_t root : flat.roots)
+            flat.expand(root, arena);
+        warm_nodes = hit ? arena.size() : 0;
+    });
+    std::uintmax_t entry = 0;
+    for (const auto &e : std::filesystem::directory_iterator(dir))
+        entry += e.file_size();
+    std::filesystem::remove_all(dir);
+
+    if (!hit || warm_nodes != cold_nodes)
+    {
+        std::fprintf(stderr, "the cache missed or gave another tree (%zu nodes vs %zu)\n", warm_nodes, cold_nodes);
+        return 1;
+    }
+    std::printf("source: %.1f MB, cache entry: %.1f MB, %zu nodes\n", Bench::megabytes(code.size()), Bench::megabytes(entry), cold_nodes);
+    std::printf("%-36s %10s\n", "startup", "ms");
+    std::printf("%-36s %10.2f\n", "cold (lex, parse, passes, store)", cold * 1e3);
+    std::printf("%-36s %10.2f\n", "warm (load, expand)", warm * 1e3);
+    std::printf("speedup: %.2fx\n", cold / warm);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// parser on block nesting: throughput of ordinary code (a few levels per function, which must
+// not pay for the explicit block stack), of deep chains of if/loop blocks under the nesting
+// limit, and a chain far over it, which must end with one diagnostic instead of a stack overflow
+// usage: bench_deep_nesting [functions (default 50000)] [depth (default 1000)] [over the limit (default 1000000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/log.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+using namespace Log;
+
+static std::string ordinary(std::size_t functions)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        code += "def function_" + id + ":func(first:int32, second:float64) -> [\n";
+        code += "    def total_" + id + ":int32 := first + 20 * 3 - 7\n";
+        code += "    if (total_" + id + " != 23) -> [\n";
+        code += "        loop (true) -> [\n";
+        code += "            printnl(\"not twenty three\")\n";
+        code += "        ]\n";
+        code += "    ]\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+// chains of if and loop blocks, each depth levels deep, up to about the size of the ordinary code
+static std::string nested(std::size_t depth, std::size_t chains)
+{
+    std::string code;
+    for (std::size_t c = 0; c < chains; c++)
+    {
+        code += "def chain_" + std::to_string(c) + ":func() -> [\n";
+        code += "def x:int32 := 1\n";
+        for (std::size_t d = 0; d < depth; d++)
+            code += (d % 2) ? "loop (true) -> [\n" : "if (x == 1) -> [\n";
+        code += "printnl(\"deep\")\n";
+        code += std::string(depth, ']');
+        code += "\n]\n";
+    }
+    return code;
+}
+
+struct Result
+{
+    double seconds = 0;
+    std::size_t tokens = 0;
+    std::size_t items = 0;
+    std::size_t errors = 0;
+};
+
+static Result parse(const std::string &code, std::size_t max_depth, int runs)
+{
+    Result result;
+    TokenStream tokens(code);
+    Lexer(code).tokenize(tokens);
+    result.tokens = tokens.size();
+    result.seconds = Bench::bestOf(runs, [&] {
+        std::vector<LogErrors::Held> diagnostics;
+        LogErrors::Hold hold(diagnostics);
+        AstArena arena;
+        Parser parser(tokens, arena);
+        parser.maxDepth(max_depth);
+        result.items = parser.Parse().size();
+        result.errors = diagnostics.size();
+    });
+    return result;
+}
+
+static void print(const char *name, const Result &r)
+{
+    std::printf("%-26s %10.2f %12zu %14.1f %8zu %8zu\n", name, r.seconds * 1e3, r.tokens, r.tokens / r.seconds / 1e6, r.items, r.errors);
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    std::size_t depth = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    std::size_t over = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 1000000;
+    if (depth == 0 || depth >= Parser::default_max_depth)
+        depth = Parser::default_max_depth - 1; // plus the body of the chain
+
+    std::string flat = ordinary(functions);
+    std::size_t chains = flat.size() / (depth * 18) + 1; // about 18 bytes per level
+    std::printf("%zu functions, %zu chains %zu deep, one chain %zu deep (limit %zu)\n", functions, chains, depth, over, Parser::default_max_depth);
+    std::printf("%-26s %10s %12s %14s %8s %8s\n", "source", "ms", "tokens", "Mtokens/s", "items", "errors");
+
+    print("ordinary code", parse(flat, Parser::default_max_depth, 5));
+    print("deep chains", parse(nested(depth, chains), Parser::default_max_depth, 5));
+
+    // nested over the limit: reported once, the chain is skipped and nothing else fails
+    Result deepest = parse(nested(over, 1), Parser::default_max_depth, 1);
+    print("over the limit", deepest);
+    if (deepest.errors != 1)
+    {
+        std::fprintf(stderr, "expected one nesting diagnostic, got %zu\n", deepest.errors);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// parse time per 'def' as the file grows: when the cost per def stays flat the parser is linear.
+// "broken" defs miss their ':=' and the only one of the file is at the end, the worst case of
+// the old scan ahead (every def scanned to the end of the file)
+// usage: bench_def_lookahead [defs of the biggest run (default 50000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string flat(std::size_t defs)
+{
+    std::string code;
+    for (std::size_t n = 0; n < defs; n++)
+        code += "def value_" + std::to_string(n) + ":float64 := 1.5\n";
+    return code;
+}
+
+// functions inside functions, a few levels deep and repeated
+static std::string nested(std::size_t defs)
+{
+    const std::size_t depth = 50;
+    std::string code;
+    for (std::size_t n = 0; n < defs; n += depth)
+    {
+        for (std::size_t d = 0; d < depth; d++)
+            code += "def inner_" + std::to_string(n + d) + ":func(arg:int32) -> [\n";
+        code += "def last:float64 := 2.5\n";
+        code.append(depth, ']');
+        code += "\n";
+    }
+    return code;
+}
+
+static std::string broken(std::size_t defs)
+{
+    std::string code;
+    for (std::size_t n = 0; n < defs; n++)
+        code += "def value_" + std::to_string(n) + ":int32 7\n";
+    return code + "def last:int32 := 1\n";
+}
+
+static void run(const char *name, std::string (*generate)(std::size_t), std::size_t max_defs)
+{
+    for (std::size_t defs = max_defs / 4; defs <= max_defs; defs *= 2)
+    {
+        std::string code = generate(defs);
+        Lexer lexer(code);
+        TokenStream tokens(code);
+        lexer.tokenize(tokens);
+
+        double time = Bench::bestOf(3, [&] {
+            AstArena arena;
+            Parser parser(tokens, arena);
+            parser.Parse();
+        });
+        std::printf("%-8s %8zu defs %10.2f ms %10.1f ns/def\n", name, defs, time * 1e3, time * 1e9 / defs);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t defs = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    run("flat", flat, defs);
+    run("nested", nested, defs);
+    run("broken", broken, defs);
+    // the broken defs leave their errors on LogErrors, they are not printed
+    return 0;
+}
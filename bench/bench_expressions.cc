@@ -0,0 +1,150 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// time of very long and very deep expressions through the whole pipeline (lexer, parser, folder,
+// semantic and type pass), one variable definition each in a function, so nothing is folded away:
+// a flat chain over the arithmetic and bitwise operators, nested parentheses and a run of prefix
+// operators (a chain of compares and && has nowhere to go yet, a bool definition takes a literal only)
+// usage: bench_expressions [terms (default 100000)]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/const_folder.hpp"
+#include "../src/includes/log.hpp"
+#include "../src/includes/semantic_visitor.hpp"
+#include "../src/includes/type_checker.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+// the arguments and literals, one of each in turn
+static std::string term(std::size_t n)
+{
+    if (n % 2)
+        return (n % 4 == 1) ? "first" : "second";
+    return std::to_string(n % 1000 + 1);
+}
+
+static std::string function(const char *type, const std::string &value)
+{
+    return std::string("def shape:func(first:int32, second:int32) -> [\n    def value:") + type + " := " + value + "\n]\n";
+}
+
+static std::string chain(std::size_t terms)
+{
+    const char *ops[] = {" + ", " * ", " - ", " / ", " % ", " << ", " >> ", " & ", " ^ ", " | "};
+    std::string code = term(0);
+    for (std::size_t n = 1; n < terms; n++)
+    {
+        code += ops[n % 10];
+        code += term(n);
+    }
+    return function("int32", code);
+}
+
+static std::string nested(std::size_t terms)
+{
+    std::string code;
+    for (std::size_t n = 1; n < terms; n++)
+        code += "(" + term(n) + " + ";
+    code += term(0);
+    code.append(terms - 1, ')');
+    return function("int32", code);
+}
+
+static std::string prefixed(std::size_t terms)
+{
+    std::string code;
+    for (std::size_t n = 1; n < terms; n++)
+        code += (n % 3 == 0) ? "~" : "-";
+    return function("int32", code + "first");
+}
+
+static std::size_t errors = 0;
+
+static void run(const char *name, const std::string &code, std::size_t terms)
+{
+    // the best time of each stage, over 5 runs of all of them
+    double lex = 1e300, parse = 1e300, fold = 1e300, semantic = 1e300, types = 1e300;
+    std::size_t tokens = 0, nodes = 0, failed = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        std::vector<Log::LogErrors::Held> diagnostics;
+        Log::LogErrors::Hold hold(diagnostics);
+        AstArena arena;
+
+        Bench::Timer t;
+        TokenStream stream(code);
+        Lexer(code).tokenize(stream);
+        lex = std::min(lex, t.seconds());
+
+        t = Bench::Timer();
+        Parser parser(stream, arena);
+        std::vector<ASTPtr> items = parser.Parse();
+        parse = std::min(parse, t.seconds());
+
+        t = Bench::Timer();
+        ConstantFolder folder(arena);
+        for (ASTPtr &item : items)
+            item = folder.fold(item);
+        fold = std::min(fold, t.seconds());
+
+        t = Bench::Timer();
+        SemanticAnalyzer analyzer;
+        for (ASTPtr item : items)
+            analyzer.VisitNode(item);
+        semantic = std::min(semantic, t.seconds());
+
+        t = Bench::Timer();
+        IrUnit ir;
+        TypeChecker checker(ir);
+        checker.check(items);
+        types = std::min(types, t.seconds());
+
+        tokens = stream.size();
+        nodes = arena.size();
+        failed = diagnostics.size();
+    }
+    errors += failed;
+    double total = lex + parse + fold + semantic + types;
+    std::printf("%-10s %9zu %9zu %9.2f %9.2f %9.2f %9.2f %9.2f %10.1f%s\n", name, tokens, nodes, lex * 1e3, parse * 1e3,
+                fold * 1e3, semantic * 1e3, types * 1e3, total * 1e9 / terms, failed ? "  (errors)" : "");
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t terms = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    std::printf("%zu terms per expression\n", terms);
+    std::printf("%-10s %9s %9s %9s %9s %9s %9s %9s %10s\n", "shape", "tokens", "nodes", "lex ms", "parse ms", "fold ms",
+                "sema ms", "types ms", "ns/term");
+    run("chain", chain(terms), terms);
+    run("nested", nested(terms), terms);
+    run("prefixed", prefixed(terms), terms);
+
+    if (errors != 0)
+    {
+        std::fprintf(stderr, "the expressions had %zu errors\n", errors);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// the pointer AST on the arena vs the FlatAst: parse time, memory of the tree,
+// and a pass over every node (a recursive walk of the pointers vs a scan of the records)
+// usage: bench_flat_ast [functions (default 50000)]
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/flat_ast.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+using Counts = std::array<std::size_t, 32>;
+
+static std::string generateCorpus(std::size_t functions)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        code += "def function_" + id + ":func(first:int32, second:float64) -> [\n";
+        code += "    def total_" + id + ":int32 := 20 * 3 / 2 * 7\n";
+        code += "    def ratio_" + id + ":float64 := 1.5 * 2.25 / 3.0\n";
+        code += "    def label_" + id + ":charseq := \"label \" + \"number\"\n";
+        code += "    printnl(\"generated function $[first]\")\n";
+        code += "    if (first == 3) -> [\n";
+        code += "        print(\"three\")\n";
+        code += "    ]\n";
+        code += "    loop (true) -> [\n";
+        code += "        printnl(\"again\")\n";
+        code += "    ]\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+// the same pass on the pointer tree: every node is reached through its parent
+static void walk(const ASTNode *node, Counts &counts)
+{
+    if (!node)
+        return;
+    counts[static_cast<std::size_t>(node->kind)]++;
+    switch (node->kind)
+    {
+    case NodeKind::IDENTIFIER:
+        for (ASTPtr arg : static_cast<const IdentifierNode *>(node)->args) walk(arg, counts);
+        break;
+    case NodeKind::BLOCK:
+        for (ASTPtr stmt : static_cast<const BlockNode *>(node)->statements) walk(stmt, counts);
+        break;
+    case NodeKind::LOOP_CONDITION:
+        walk(static_cast<const LoopConditionNode *>(node)->condition, counts);
+        walk(static_cast<const LoopConditionNode *>(node)->body, counts);
+        break;
+    case NodeKind::LOOP:
+        walk(static_cast<const LoopNode *>(node)->value, counts);
+        walk(static_cast<const LoopNode *>(node)->block, counts);
+        break;
+    case NodeKind::IF_STATEMENT:
+    {
+        auto n = static_cast<const IfStatement *>(node);
+        walk(n->ifCondition, counts);
+        walk(n->ifBranch, counts);
+        walk(n->butBranch, counts);
+        walk(n->butCondition, counts);
+        break;
+    }
+    case NodeKind::OBJECT: walk(static_cast<const ObjectNode *>(node)->val, counts); break;
+    case NodeKind::RETURN: walk(static_cast<const ReturnNode *>(node)->val, counts); break;
+    case NodeKind::FINISH: walk(static_cast<const FinishNode *>(node)->value, counts); break;
+    case NodeKind::UNARY_OP: walk(static_cast<const UnaryOp *>(node)->operand, counts); break;
+    case NodeKind::BIN_OP:
+        walk(static_cast<const BinOp *>(node)->left, counts);
+        walk(static_cast<const BinOp *>(node)->right, counts);
+        break;
+    case NodeKind::IF_EXPRESSION: walk(static_cast<const IfExpressionNode *>(node)->val, counts); break;
+    case NodeKind::FUNCTION_DEFINITION:
+    {
+        auto n = static_cast<const FunctionDefinitionNode *>(node);
+        for (ASTPtr arg : n->args) walk(arg, counts);
+        walk(n->block, counts);
+        break;
+    }
+    case NodeKind::VARIABLE_DEFINITION: walk(static_cast<const VariableDefinitionNode *>(node)->val, counts); break;
+    default:
+        break;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    std::string code = generateCorpus(functions);
+
+    Lexer lexer(code);
+    TokenStream tokens(code);
+    lexer.tokenize(tokens);
+
+    AstArena arena;
+    std::vector<ASTPtr> roots;
+    double tree_time = Bench::bestOf(3, [&] {
+        roots.clear();
+        arena.clear();
+        Parser parser(tokens, arena);
+        roots = parser.Parse();
+    });
+
+    FlatAst flat;
+    double flat_time = Bench::bestOf(3, [&] {
+        flat.clear();
+        AstArena scratch;
+        Parser parser(tokens, scratch);
+        parser.Parse(flat);
+    });
+
+    const int passes = 20;
+    Counts tree_counts{};
+    double walk_time = Bench::bestOf(3, [&] {
+        tree_counts.fill(0);
+        for (int pass = 0; pass < passes; pass++)
+            for (ASTPtr root : roots)
+                walk(root, tree_counts);
+    });
+
+    Counts flat_counts{};
+    double scan_time = Bench::bestOf(3, [&] {
+        flat_counts.fill(0);
+        for (int pass = 0; pass < passes; pass++)
+            for (const FlatNode &node : flat.nodes)
+                flat_counts[static_cast<std::size_t>(node.kind)]++;
+    });
+
+    if (tree_counts != flat_counts || flat.roots.size() != roots.size())
+    {
+        std::fprintf(stderr, "the flat tree doesn't have the nodes of the pointer tree\n");
+        return 1;
+    }
+
+    // round trip: expanding the records and flattening again gives the same records
+    AstArena expanded;
+    FlatAst again;
+    for (uint32_t root : flat.roots)
+        again.append(flat.expand(root, expanded));
+    if (again.nodes.size() != flat.nodes.size() || again.chars != flat.chars ||
+        std::memcmp(again.nodes.data(), flat.nodes.data(), flat.nodes.size() * sizeof(FlatNode)) != 0)
+    {
+        std::fprintf(stderr, "expand + append is not a round trip\n");
+        return 1;
+    }
+
+    double visits = static_cast<double>(flat.size()) * passes;
+    std::printf("source: %.1f MB, %zu functions, %zu nodes\n", Bench::megabytes(code.size()), functions, flat.size());
+    std::printf("%-16s %12s %12s %14s\n", "ast", "parse ms", "memory MB", "pass ns/node");
+    std::printf("%-16s %12.2f %12.2f %14.2f\n", "pointer (arena)", tree_time * 1e3, Bench::megabytes(arena.memoryUsage()), walk_time * 1e9 / visits);
+    std::printf("%-16s %12.2f %12.2f %14.2f\n", "flat", flat_time * 1e3, Bench::megabytes(flat.memoryUsage()), scan_time * 1e9 / visits);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// constant folding: time of the pass and the operator nodes left for run time,
+// on functions whose values come from constants defined before them
+// usage: bench_fold [functions (default 50000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/const_folder.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generateCorpus(std::size_t functions)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        code += "def function_" + id + ":func(arg:int32) -> [\n";
+        code += "    def val1_" + id + ":int32 := " + std::to_string(n % 1000) + "\n";
+        code += "    def val2_" + id + ":int32 := val1_" + id + " * 2 - 7\n";
+        code += "    def val3_" + id + ":int32 := val1_" + id + " + val2_" + id + " / 2\n";
+        code += "    def ratio_" + id + ":float64 := val3_" + id + " * 1.5 + -(2.25 / 3.0)\n";
+        code += "    def mask_" + id + ":int64 := (val3_" + id + " << 4) | 15 ^ 3\n";
+        code += "    def runtime_" + id + ":int32 := arg + val3_" + id + "\n";
+        code += "    if (val1_" + id + " == 3) -> [\n";
+        code += "        print(\"three\")\n";
+        code += "    ]\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+// operators (BinOp and UnaryOp) reachable from the items, what would be computed at run time
+static std::size_t operators(const std::vector<ASTPtr> &items)
+{
+    std::vector<const ASTNode *> stack(items.begin(), items.end());
+    std::size_t count = 0;
+    while (!stack.empty())
+    {
+        const ASTNode *node = stack.back();
+        stack.pop_back();
+        if (!node)
+            continue;
+        switch (node->kind)
+        {
+        case NodeKind::BIN_OP:
+            count++;
+            stack.push_back(static_cast<const BinOp *>(node)->left);
+            stack.push_back(static_cast<const BinOp *>(node)->right);
+            break;
+        case NodeKind::UNARY_OP:
+            count++;
+            stack.push_back(static_cast<const UnaryOp *>(node)->operand);
+            break;
+        case NodeKind::FUNCTION_DEFINITION:
+            stack.push_back(static_cast<const FunctionDefinitionNode *>(node)->block);
+            break;
+        case NodeKind::BLOCK:
+            for (ASTPtr stmt : static_cast<const BlockNode *>(node)->statements)
+                stack.push_back(stmt);
+            break;
+        case NodeKind::VARIABLE_DEFINITION:
+            stack.push_back(static_cast<const VariableDefinitionNode *>(node)->val);
+            break;
+        default:
+            break;
+        }
+    }
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    std::string code = generateCorpus(functions);
+
+    Lexer lexer(code);
+    TokenStream tokens(code);
+    lexer.tokenize(tokens);
+
+    double fold_time = 1e300;
+    std::size_t before = 0, after = 0, folded = 0;
+    for (int run = 0; run < 3; run++)
+    {
+        AstArena arena;
+        Parser parser(tokens, arena);
+        std::vector<ASTPtr> items = parser.Parse();
+        before = operators(items);
+
+        Bench::Timer timer;
+        ConstantFolder folder(arena);
+        for (ASTPtr &item : items)
+            item = folder.fold(item);
+        double time = timer.seconds();
+        fold_time = time < fold_time ? time : fold_time;
+
+        after = operators(items);
+        folded = folder.folded();
+    }
+
+    std::printf("%zu functions, %zu folds\n", functions, folded);
+    std::printf("operators left for run time: %zu before, %zu after\n", before, after);
+    std::printf("fold pass: %.2f ms (%.1f ns per function)\n", fold_time * 1e3, fold_time * 1e9 / functions);
+    return 0;
+}
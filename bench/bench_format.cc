@@ -0,0 +1,115 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// cost per formatted string of a "$[name]" literal: rescanning the flat literal for the holes
+// and concatenating (what the old single string token left to the runtime) vs the FormatPlan
+// the parser builds (one reserve, one append per piece)
+// usage: bench_format [iterations (default 2000000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast.hpp"
+#include "../src/includes/interner.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+// the old way: find each "$[", look the name up and build the string piece by piece
+static void rescan(std::string &out, const std::string &literal, const std::unordered_map<std::string, std::string> &values)
+{
+    out.clear();
+    std::size_t at = 0;
+    while (true)
+    {
+        std::size_t open = literal.find("$[", at);
+        if (open == std::string::npos)
+            break;
+        std::size_t close = literal.find(']', open);
+        out += literal.substr(at, open - at);
+        out += values.at(literal.substr(open + 2, close - open - 2));
+        at = close + 1;
+    }
+    out += literal.substr(at);
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    // the plan comes from the real lexer and parser
+    std::string code = "printnl(\"Hello $[user_name], you have $[unread_count] new messages in $[folder]!\")\n";
+    const std::string literal = "Hello $[user_name], you have $[unread_count] new messages in $[folder]!";
+    Lexer lexer(code);
+    TokenStream tokens(code);
+    lexer.tokenize(tokens);
+    AstArena arena;
+    Parser parser(tokens, arena);
+    std::vector<ASTPtr> nodes = parser.Parse();
+    auto print = nodes.empty() ? nullptr : nodeAs<PrintNl>(nodes[0]);
+    if (!print || print->format.slots.size() != 3)
+    {
+        std::fprintf(stderr, "the parser didn't build the format plan\n");
+        return 1;
+    }
+    const FormatPlan &plan = print->format;
+
+    std::unordered_map<std::string, std::string> by_name = {{"user_name", "rafael"}, {"unread_count", "42"}, {"folder", "inbox"}};
+    std::vector<std::string> by_symbol(Interner::getInstance().size());
+    for (const auto &value : by_name)
+        by_symbol[Interner::getInstance().intern(value.first)] = value.second;
+
+    std::string out;
+    std::size_t bytes = 0;
+    double old_time = Bench::bestOf(3, [&] {
+        bytes = 0;
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            rescan(out, literal, by_name);
+            bytes += out.size();
+        }
+    });
+    std::string expected = out;
+
+    double plan_time = Bench::bestOf(3, [&] {
+        bytes = 0;
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            out.clear();
+            plan.render(out, [&](Symbol name) -> std::string_view { return by_symbol[name]; });
+            bytes += out.size();
+        }
+    });
+    if (out != expected)
+    {
+        std::fprintf(stderr, "mismatch: '%s' vs '%s'\n", out.c_str(), expected.c_str());
+        return 1;
+    }
+
+    std::printf("\"%s\" -> \"%s\", %zu iterations\n", literal.c_str(), out.c_str(), iterations);
+    std::printf("%-32s %10s %12s\n", "format", "ms", "ns/string");
+    std::printf("%-32s %10.2f %12.2f\n", "rescan + concatenation", old_time * 1e3, old_time * 1e9 / iterations);
+    std::printf("%-32s %10.2f %12.2f\n", "format plan", plan_time * 1e3, plan_time * 1e9 / iterations);
+    Bench::keep(bytes);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// cost of the keyword lookup per identifier: the old substr + unordered_map (count and at)
+// vs the compile time perfect hash over a string_view
+// usage: bench_keywords [identifiers (default 2000000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/lexer/keywords.hpp"
+
+using namespace Rythin;
+
+int main(int argc, char *argv[])
+{
+    std::size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    // identifier heavy text: about one keyword for each two plain names
+    const char *names[] = {"value", "counter", "x", "main", "print_total", "fn_42", "interval", "defs", "loops", "tmp"};
+    std::string text;
+    std::vector<std::pair<std::size_t, std::size_t>> spans;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::string_view word = (i % 3 == 0) ? Keywords::list[i % Keywords::count].spelling : std::string_view(names[i % 10]);
+        spans.emplace_back(text.size(), word.size());
+        text.append(word);
+        text.push_back(' ');
+    }
+    std::string_view source = text;
+
+    std::unordered_map<std::string, TokensTypes> keywords;
+    for (const Keywords::Keyword &kw : Keywords::list)
+        keywords.emplace(std::string(kw.spelling), kw.type);
+
+    const int runs = 5;
+    std::size_t hits = 0;
+    double map_time = Bench::bestOf(runs, [&] {
+        hits = 0;
+        for (const auto &span : spans)
+        {
+            std::string value(source.substr(span.first, span.second));
+            TokensTypes type = keywords.count(value) ? keywords.at(value) : TokensTypes::TOKEN_IDENTIFIER;
+            hits += type != TokensTypes::TOKEN_IDENTIFIER;
+        }
+    });
+    std::size_t map_hits = hits;
+
+    double hash_time = Bench::bestOf(runs, [&] {
+        hits = 0;
+        for (const auto &span : spans)
+        {
+            TokensTypes type = Keywords::lookup(source.substr(span.first, span.second));
+            hits += type != TokensTypes::TOKEN_IDENTIFIER;
+        }
+    });
+
+    if (hits != map_hits)
+    {
+        std::fprintf(stderr, "mismatch: %zu keywords on the map vs %zu on the perfect hash\n", map_hits, hits);
+        return 1;
+    }
+
+    std::printf("%zu identifiers, %zu keywords\n", spans.size(), hits);
+    std::printf("%-34s %10s %12s\n", "lookup", "ms", "ns/ident");
+    std::printf("%-34s %10.2f %12.2f\n", "substr + unordered_map count/at", map_time * 1e3, map_time * 1e9 / spans.size());
+    std::printf("%-34s %10.2f %12.2f\n", "perfect hash (string_view)", hash_time * 1e3, hash_time * 1e9 / spans.size());
+    return 0;
+}
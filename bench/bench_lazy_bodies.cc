@@ -0,0 +1,104 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// startup of a script that calls a few functions of a big module: parse, fold and check
+// of every body vs the lazy parser (bodies skipped by bracket matching, loaded on the first call)
+// usage: bench_lazy_bodies [functions (default 50000)] [functions called (default 50)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/const_folder.hpp"
+#include "../src/includes/semantic_visitor.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generated(std::size_t functions, std::size_t called)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        code += "def function_" + id + ":func(first:int32, second:float64) -> [\n";
+        code += "    def total_" + id + ":int32 := first + 20 * 3 - 7\n";
+        code += "    def label_" + id + ":charseq := \"label $[first]\"\n";
+        code += "    if (total_" + id + " != 23) -> [\n";
+        code += "        printnl(\"not twenty three\")\n";
+        code += "    ]\n";
+        code += "    loop (true) -> [\n";
+        code += "        print(\"again\")\n";
+        code += "    ]\n";
+        code += "]\n";
+    }
+    code += "def main:func() -> [\n";
+    for (std::size_t k = 0; k < called; k++)
+        code += "    def result_" + std::to_string(k) + ":obj := function_" + std::to_string(k * functions / called) + "(1)\n";
+    code += "]\n";
+    return code;
+}
+
+// what a run does before executing: parse, fold, check. The bodies checked are counted
+static std::size_t startup(const TokenStream &tokens, bool lazy)
+{
+    AstArena arena;
+    Parser parser(tokens, arena);
+    parser.deferBodies(lazy);
+    std::vector<ASTPtr> nodes = parser.Parse();
+
+    ConstantFolder folder(arena);
+    for (ASTPtr &node : nodes)
+        node = folder.fold(node);
+
+    std::size_t loaded = 0;
+    SemanticAnalyzer analyzer([&](FunctionDefinitionNode &func) {
+        loaded++;
+        func.block = Parser::ParseBody(tokens, arena, func);
+        folder.fold(&func);
+        return func.block;
+    });
+    for (ASTPtr node : nodes)
+        analyzer.VisitNode(node);
+    analyzer.checkDeferred(false);
+    return lazy ? loaded : nodes.size();
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    std::size_t called = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 50;
+    if (called == 0 || called > functions)
+        called = functions;
+    std::string code = generated(functions, called);
+    TokenStream tokens(code);
+    Lexer(code).tokenize(tokens);
+    std::printf("%zu functions, %zu called from main, %zu tokens\n", functions, called, tokens.size());
+
+    std::size_t eager_bodies = 0, lazy_bodies = 0;
+    double eager = Bench::bestOf(3, [&] { eager_bodies = startup(tokens, false); });
+    double lazy = Bench::bestOf(3, [&] { lazy_bodies = startup(tokens, true); });
+
+    std::printf("%-8s %10s %12s\n", "parser", "ms", "bodies");
+    std::printf("%-8s %10.2f %12zu\n", "eager", eager * 1e3, eager_bodies);
+    std::printf("%-8s %10.2f %12zu\n", "lazy", lazy * 1e3, lazy_bodies);
+    std::printf("speedup: %.2fx\n", eager / lazy);
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// lexer throughput (MB/s) for each scanner level and for the default dispatch on a comment heavy and
+// on a code heavy source, and the time of each kernel alone on the runs of those sources (what the
+// default dispatch is chosen by)
+// usage: bench_lexer [size in MB (default 32)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/lexer/r_scan.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string commentHeavy(std::size_t target_bytes)
+{
+    std::string code;
+    code.reserve(target_bytes + 512);
+    int n = 0;
+    while (code.size() < target_bytes)
+    {
+        code += "; ------------------------------------------------------------------------\n";
+        code += "; generated_function_" + std::to_string(n) + ": documentation of the generated item,\n";
+        code += ";     with the long explanation that the generator writes for every one of them\n";
+        code += "#     and a second comment style, indented with spaces and tabs\t\t\n\n\n";
+        code += "def generated_function_" + std::to_string(n) + ":func() -> [\n";
+        code += "        def accumulated_value:int32 := " + std::to_string(n % 1000) + " ; trailing comment\n";
+        code += "]\n\n";
+        n++;
+    }
+    return code;
+}
+
+static std::string codeHeavy(std::size_t target_bytes)
+{
+    std::string code;
+    code.reserve(target_bytes + 512);
+    int n = 0;
+    while (code.size() < target_bytes)
+    {
+        code += "def generated_function_" + std::to_string(n) + ":func(first_argument:int32, second_argument:float64) -> [\n";
+        code += "    def accumulated_value:int32 := first_argument + 20 * 3 - counter_value\n";
+        code += "    if (accumulated_value != 23) -> [\n";
+        code += "        printnl(\"value is not twenty three\")\n";
+        code += "    ]\n";
+        code += "]\n";
+        n++;
+    }
+    return code;
+}
+
+static void run(const char *name, const std::string &code)
+{
+    double size = Bench::megabytes(code.size());
+    std::printf("%s source: %.1f MB\n", name, size);
+
+    const Scan::Level levels[] = {Scan::Level::SCALAR, Scan::Level::SSE2, Scan::Level::AVX2};
+    for (Scan::Level level : levels)
+    {
+        if (static_cast<int>(level) > static_cast<int>(Scan::detect()))
+            continue;
+        Scan::force(level);
+
+        std::size_t count = 0;
+        double time = Bench::bestOf(5, [&] {
+            Lexer lexer(code);
+            TokenStream tokens(code);
+            lexer.tokenize(tokens);
+            count = tokens.size();
+        });
+        std::printf("  %-8s %10.2f ms %10.1f MB/s %12zu tokens\n", Scan::levelName(level), time * 1e3, size / time, count);
+    }
+    Scan::reset();
+
+    std::size_t count = 0;
+    double time = Bench::bestOf(5, [&] {
+        Lexer lexer(code);
+        TokenStream tokens(code);
+        lexer.tokenize(tokens);
+        count = tokens.size();
+    });
+    std::printf("  %-8s %10.2f ms %10.1f MB/s %12zu tokens\n", "default", time * 1e3, size / time, count);
+}
+
+// where each kernel is called on the source: the starts of the whitespace runs,
+// of the identifiers and of the comment bodies
+struct Runs
+{
+    std::vector<std::size_t> whitespace, identifier, line_body;
+};
+
+static Runs runsOf(const std::string &code)
+{
+    Runs runs;
+    const Scan::Kernels &scalar = Scan::kernels();
+    std::size_t i = 0, n = code.size();
+    while (i < n)
+    {
+        unsigned char c = static_cast<unsigned char>(code[i]);
+        std::size_t len = 1;
+        if (scalar.whitespace(code.data() + i, n - i) > 0)
+        {
+            runs.whitespace.push_back(i);
+            len = scalar.whitespace(code.data() + i, n - i);
+        }
+        else if (c == ';' || c == '#')
+        {
+            runs.line_body.push_back(i + 1);
+            len = 1 + scalar.lineBody(code.data() + i + 1, n - i - 1);
+        }
+        else if (scalar.identifier(code.data() + i, n - i) > 0)
+        {
+            runs.identifier.push_back(i);
+            len = scalar.identifier(code.data() + i, n - i);
+        }
+        i += len;
+    }
+    return runs;
+}
+
+static double kernelTime(const std::string &code, const std::vector<std::size_t> &starts, std::size_t (*kernel)(const char *, std::size_t))
+{
+    std::size_t sum = 0;
+    double time = Bench::bestOf(7, [&] {
+        for (std::size_t at : starts)
+            sum += kernel(code.data() + at, code.size() - at);
+    });
+    if (sum == 1)
+        std::printf(" "); // keeps the calls
+    return time;
+}
+
+static void kernels(const std::string &code)
+{
+    Scan::force(Scan::Level::SCALAR);
+    Runs runs = runsOf(code);
+    std::printf("  %-8s %12s %12s %12s %12s   (ms, %zu/%zu/%zu runs)\n", "kernel", "whitespace", "identifier", "lineBody", "newlines",
+                runs.whitespace.size(), runs.identifier.size(), runs.line_body.size());
+
+    const Scan::Level levels[] = {Scan::Level::SCALAR, Scan::Level::SSE2, Scan::Level::AVX2};
+    for (Scan::Level level : levels)
+    {
+        if (static_cast<int>(level) > static_cast<int>(Scan::detect()))
+            continue;
+        const Scan::Kernels &k = Scan::kernelsOf(level);
+        std::vector<std::size_t> whole = {0};
+        std::printf("  %-8s %12.2f %12.2f %12.2f %12.2f\n", Scan::levelName(level),
+                    kernelTime(code, runs.whitespace, k.whitespace) * 1e3,
+                    kernelTime(code, runs.identifier, k.identifier) * 1e3,
+                    kernelTime(code, runs.line_body, k.lineBody) * 1e3,
+                    kernelTime(code, whole, k.newlines) * 1e3);
+    }
+    Scan::reset();
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t mb = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 32;
+    std::printf("cpu scanner level: %s (default: %s)\n", Scan::levelName(Scan::detect()), Scan::describe(Scan::kernels()).c_str());
+    std::string comments = commentHeavy(mb * 1024 * 1024);
+    std::string code = codeHeavy(mb * 1024 * 1024);
+    run("comment heavy", comments);
+    kernels(comments);
+    run("code heavy", code);
+    kernels(code);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// names through the pipeline: heap used by the AST and the time of the semantic pass
+// (name resolution) on a generated source with many functions and variables
+// usage: bench_names [functions (default 20000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/interner.hpp"
+#include "../src/includes/log.hpp"
+#include "../src/includes/semantic_visitor.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+// every allocation of the program goes through here, so the bench can tell the live heap
+static std::size_t live_bytes = 0;
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t size)
+{
+    std::size_t *p = static_cast<std::size_t *>(std::malloc(size + sizeof(std::size_t) * 2));
+    if (!p)
+        throw std::bad_alloc();
+    p[0] = size;
+    live_bytes += size;
+    allocations++;
+    return p + 2;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+    std::size_t *p = static_cast<std::size_t *>(ptr) - 2;
+    live_bytes -= p[0];
+    std::free(p);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+static std::string generateSource(std::size_t functions)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        code += "def generated_function_number_" + id + ":func(first_argument_of_function:int32) -> [\n";
+        code += "    def accumulated_value_of_" + id + ":int32 := 20 * 3\n";
+        code += "    def running_counter_for_" + id + ":int64 := 1\n";
+        code += "    def description_text_of_" + id + ":charseq := \"text\"\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    std::string code = generateSource(functions);
+
+    Lexer lexer(code);
+    TokenStream tokens(code);
+    lexer.tokenize(tokens);
+
+    std::size_t before = live_bytes;
+    std::size_t allocs_before = allocations;
+    Bench::Timer parse_timer;
+    AstArena arena;
+    Parser parser(tokens, arena);
+    std::vector<ASTPtr> nodes = parser.Parse();
+    double parse_time = parse_timer.seconds();
+    std::size_t ast_bytes = live_bytes - before;
+    std::size_t ast_allocs = allocations - allocs_before;
+
+    before = live_bytes;
+    Bench::Timer semantic_timer;
+    SemanticAnalyzer analyzer;
+    for (ASTPtr &stmts : nodes)
+        analyzer.VisitNode(stmts);
+    double semantic_time = semantic_timer.seconds();
+    std::size_t table_bytes = live_bytes - before;
+
+    if (Log::LogErrors::getInstance().getErrSize() != 0)
+        Log::LogErrors::getInstance().printAll();
+
+    std::printf("source: %.1f MB, %zu functions, %zu names declared\n", Bench::megabytes(code.size()), functions, functions * 4);
+    std::printf("parse:    %8.2f ms, AST heap %8.2f MB in %zu allocations\n", parse_time * 1e3, Bench::megabytes(ast_bytes), ast_allocs);
+    std::printf("semantic: %8.2f ms, symbol tables %8.2f MB\n", semantic_time * 1e3, Bench::megabytes(table_bytes));
+    std::printf("interner: %zu distinct names, %.2f MB\n", Interner::getInstance().size(), Bench::megabytes(Interner::getInstance().memoryUsage()));
+    return 0;
+}
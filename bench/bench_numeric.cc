@@ -0,0 +1,145 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// lex and lex + parse time of a numeric constant table (ints, int64s, floats and doubles),
+// and the cost per literal of the old decode in the parser (std::string + sto*) vs from_chars in the lexer
+// usage: bench_numeric [constants (default 200000)]
+
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/log.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generateTable(std::size_t constants)
+{
+    std::string code;
+    for (std::size_t i = 0; i < constants; i++)
+    {
+        std::string n = std::to_string(i);
+        switch (i % 4)
+        {
+        case 0:
+            code += "def k" + n + ":int32 := " + std::to_string(i * 7919 % 2000000000) + "\n";
+            break;
+        case 1:
+            code += "def k" + n + ":int64 := " + std::to_string(4000000000000ull + i * 104729) + "\n";
+            break;
+        case 2:
+            code += "def k" + n + ":float32 := " + std::to_string(i % 1000) + ".125f\n";
+            break;
+        default:
+            code += "def k" + n + ":float64 := " + std::to_string(i) + ".0078125\n";
+            break;
+        }
+    }
+    return code;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t constants = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::string code = generateTable(constants);
+    const int runs = 5;
+
+    std::size_t count = 0;
+    double lex_time = Bench::bestOf(runs, [&] {
+        Lexer lexer(code);
+        TokenStream tokens(code);
+        lexer.tokenize(tokens);
+        count = tokens.size();
+    });
+
+    std::size_t nodes = 0;
+    double parse_time = Bench::bestOf(runs, [&] {
+        Lexer lexer(code);
+        TokenStream tokens(code);
+        lexer.tokenize(tokens);
+        AstArena arena;
+        Parser parser(tokens, arena);
+        std::vector<ASTPtr> ast = parser.Parse();
+        nodes = ast.size();
+    });
+
+    // the literals alone, decoded the old way and the new way
+    Lexer lexer(code);
+    TokenStream tokens(code);
+    lexer.tokenize(tokens);
+    std::vector<TokenView> literals;
+    for (std::size_t i = 0; i < tokens.size(); i++)
+    {
+        TokenView tk = tokens.at(i);
+        if (TokenStream::isNumber(tk.type, tk.value.empty() ? '\0' : tk.value[0]))
+            literals.push_back(tk);
+    }
+
+    double sum = 0;
+    double sto_time = Bench::bestOf(runs, [&] {
+        for (const TokenView &tk : literals)
+        {
+            std::string text(tk.value);
+            if (tk.type == TokensTypes::TOKEN_INT_32)
+                sum += std::stoi(text);
+            else if (tk.type == TokensTypes::TOKEN_INT_64)
+                sum += static_cast<double>(std::stoll(text));
+            else if (tk.type == TokensTypes::TOKEN_FLOAT_32)
+                sum += std::stof(text);
+            else
+                sum += std::stod(text);
+        }
+    });
+    double chars_time = Bench::bestOf(runs, [&] {
+        for (const TokenView &tk : literals)
+        {
+            const char *first = tk.value.data();
+            const char *last = first + tk.value.size();
+            if (tk.type == TokensTypes::TOKEN_INT_32 || tk.type == TokensTypes::TOKEN_INT_64)
+            {
+                int64_t v = 0;
+                std::from_chars(first, last, v);
+                sum += static_cast<double>(v);
+            }
+            else
+            {
+                if (last[-1] == 'f')
+                    last--;
+                double v = 0;
+                std::from_chars(first, last, v);
+                sum += v;
+            }
+        }
+    });
+    Bench::keep(sum);
+
+    if (Log::LogErrors::getInstance().getErrSize() != 0)
+        Log::LogErrors::getInstance().printAll();
+
+    double size = Bench::megabytes(code.size());
+    std::printf("source: %.1f MB, %zu constants, %zu tokens, %zu nodes\n", size, constants, count, nodes);
+    std::printf("%-14s %10s %10s\n", "stage", "ms", "MB/s");
+    std::printf("%-14s %10.2f %10.1f\n", "lex", lex_time * 1e3, size / lex_time);
+    std::printf("%-14s %10.2f %10.1f\n", "lex + parse", parse_time * 1e3, size / parse_time);
+    std::printf("decode of %zu literals: std::string + sto* %.1f ns each, from_chars %.1f ns each\n", literals.size(),
+                sto_time * 1e9 / literals.size(), chars_time * 1e9 / literals.size());
+    return 0;
+}
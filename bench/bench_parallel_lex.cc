@@ -0,0 +1,113 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// scaling of the parallel lexer at 1, 2, 4 and 8 threads against the serial Lexer::tokenize,
+// on a generated source with string literals (with "$[name]" holes) that span lines (so some
+// chunk cuts fall inside a token and have to be lexed again). The tokens are checked too.
+// usage: bench_parallel_lex [size in MB (default 64)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "bench_util.hpp"
+#include "../src/lexer/parallel_lex.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generated(std::size_t target_bytes)
+{
+    std::string code;
+    code.reserve(target_bytes + 512);
+    int n = 0;
+    while (code.size() < target_bytes)
+    {
+        code += "; generated item " + std::to_string(n) + "\n";
+        code += "def generated_function_" + std::to_string(n) + ":func(first_argument:int32, second_argument:float64) -> [\n";
+        code += "    def accumulated_value:int32 := first_argument + 20 * 3 - counter_value\n";
+        code += "    def ratio:float64 := 3.25 * second_argument\n";
+        code += "    if (accumulated_value != 23) -> [\n";
+        code += "        printnl(\"value is not twenty three\")\n";
+        code += "    ]\n";
+        if (n % 7 == 0)
+        {
+            // spans lines: a cut here starts the chunk inside the literal
+            code += "    printnl(\"first line of the message\n";
+            code += "    def not_code:int32 := 12 \\\" and $[accumulated_value]\n";
+            code += "    still the same literal\")\n";
+        }
+        code += "]\n";
+        n++;
+    }
+    return code;
+}
+
+static bool same(const TokenStream &a, const TokenStream &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); i++)
+    {
+        TokenView x = a.at(i);
+        TokenView y = b.at(i);
+        if (x.type != y.type || x.where.offset != y.where.offset || x.value != y.value || x.symbol != y.symbol)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t mb = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 64;
+    std::string code = generated(mb * 1024 * 1024);
+    double size = Bench::megabytes(code.size());
+    std::printf("source: %.1f MB, %u hardware threads\n", size, std::thread::hardware_concurrency());
+
+    TokenStream serial(code);
+    double base = Bench::bestOf(3, [&] {
+        TokenStream tokens(code);
+        Lexer lexer(code);
+        lexer.tokenize(tokens);
+    });
+    Lexer(code).tokenize(serial);
+    std::printf("%-10s %10s %10s %8s %8s %8s %12s\n", "lexer", "ms", "MB/s", "speedup", "chunks", "relexed", "tokens");
+    std::printf("%-10s %10.2f %10.1f %8.2f %8s %8s %12zu\n", "serial", base * 1e3, size / base, 1.0, "-", "-", serial.size());
+
+    const unsigned threads[] = {1, 2, 4, 8};
+    for (unsigned t : threads)
+    {
+        ParallelLexer lexer(code, t);
+        double time = Bench::bestOf(3, [&] {
+            TokenStream tokens(code);
+            lexer.tokenize(tokens);
+        });
+
+        TokenStream tokens(code);
+        lexer.tokenize(tokens);
+        if (!same(serial, tokens))
+        {
+            std::fprintf(stderr, "%u threads: the tokens differ from the serial lexer\n", t);
+            return 1;
+        }
+        char name[16];
+        std::snprintf(name, sizeof(name), "%u threads", t);
+        std::printf("%-10s %10.2f %10.1f %8.2f %8zu %8zu %12zu\n", name, time * 1e3, size / time, base / time,
+                    lexer.chunks(), lexer.relexed(), tokens.size());
+    }
+    return 0;
+}
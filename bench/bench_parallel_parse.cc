@@ -0,0 +1,123 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// scaling of the parallel parser at 1, 2, 4 and 8 threads against the serial Parser::Parse,
+// on a generated module of functions and top level variables. The trees are checked too:
+// both are flattened and the FlatAst records must be the same.
+// usage: bench_parallel_parse [functions (default 100000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/flat_ast.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/parallel_parse.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generated(std::size_t functions)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        if (n % 5 == 0)
+            code += "def global_" + id + ":int32 := " + id + " * 2 + 1\n";
+        code += "def function_" + id + ":func(first:int32, second:float64) -> [\n";
+        code += "    def total_" + id + ":int32 := first + 20 * 3 - counter\n";
+        code += "    def label:charseq := \"label $[first]\"\n";
+        code += "    if (total_" + id + " != 23) -> [\n";
+        code += "        printnl(\"not twenty three\")\n";
+        code += "    ]\n";
+        code += "    loop (true) -> [\n";
+        code += "        print(\"again\")\n";
+        code += "    ]\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+static FlatAst flatten(const std::vector<ASTPtr> &items)
+{
+    FlatAst flat;
+    for (ASTPtr item : items)
+        flat.append(item);
+    return flat;
+}
+
+static bool same(const FlatAst &a, const FlatAst &b)
+{
+    if (a.nodes.size() != b.nodes.size() || a.lists != b.lists || a.chars != b.chars)
+        return false;
+    for (std::size_t i = 0; i < a.nodes.size(); i++)
+    {
+        const FlatNode &x = a.nodes[i];
+        const FlatNode &y = b.nodes[i];
+        if (x.kind != y.kind || x.present != y.present || x.type != y.type || x.type2 != y.type2 || x.token != y.token ||
+            x.first_child != y.first_child || x.next_sibling != y.next_sibling || x.payload != y.payload || x.extra != y.extra)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    std::string code = generated(functions);
+    TokenStream tokens(code);
+    Lexer(code).tokenize(tokens);
+    std::printf("%zu functions, %zu tokens, %u hardware threads\n", functions, tokens.size(), std::thread::hardware_concurrency());
+
+    AstArena serial_arena;
+    std::vector<ASTPtr> serial_items;
+    double base = Bench::bestOf(3, [&] {
+        serial_arena.clear();
+        Parser parser(tokens, serial_arena);
+        serial_items = parser.Parse();
+    });
+    FlatAst serial = flatten(serial_items);
+    std::printf("%-10s %10s %8s %8s %12s\n", "parser", "ms", "speedup", "chunks", "nodes");
+    std::printf("%-10s %10.2f %8.2f %8s %12zu\n", "serial", base * 1e3, 1.0, "-", serial.size());
+
+    const unsigned threads[] = {1, 2, 4, 8};
+    for (unsigned t : threads)
+    {
+        AstArena arena;
+        std::vector<ASTPtr> items;
+        ParallelParser parser(tokens, arena, t);
+        double time = Bench::bestOf(3, [&] {
+            arena.clear();
+            items = parser.Parse();
+        });
+
+        if (!same(serial, flatten(items)))
+        {
+            std::fprintf(stderr, "%u threads: the tree differs from the serial parser\n", t);
+            return 1;
+        }
+        char name[16];
+        std::snprintf(name, sizeof(name), "%u threads", t);
+        std::printf("%-10s %10.2f %8.2f %8zu %12zu\n", name, time * 1e3, base / time, parser.chunks(), serial.size());
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// startup benchmark: legacy getline loading vs the mapped and streamed SourceBuffer
+// usage: bench_source_load [size in MB (default 32)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "bench_util.hpp"
+#include "../src/includes/source_buffer.hpp"
+#include "../src/lexer/r_lex.hpp"
+
+using namespace Rythin;
+
+static std::string generateSource(std::size_t target_bytes)
+{
+    std::string code;
+    code.reserve(target_bytes + 256);
+    int n = 0;
+    while (code.size() < target_bytes)
+    {
+        code += "; generated function " + std::to_string(n) + "\n\n";
+        code += "def fn_" + std::to_string(n) + ":func() -> [\n";
+        code += "    def a:int32 := " + std::to_string(n % 1000) + "\n";
+        code += "    def b:int32 := a + 2 * 3\n\n";
+        code += "    printnl(\"value of a\")\n";
+        code += "]\n";
+        n++;
+    }
+    return code;
+}
+
+static std::size_t lexAll(std::string_view code)
+{
+    Lexer lexer(code);
+    std::size_t count = 0;
+    while (lexer.next_tk().type != TokensTypes::TOKEN_EOF)
+        count++;
+    return count;
+}
+
+// the loader used before SourceBuffer: line by line, then one more copy into the lexer
+static std::string legacyLoad(const std::string &path)
+{
+    std::fstream file(path, std::ios::in);
+    std::string code;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty())
+            code += line + '\n';
+    }
+    return code;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t mb = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 32;
+    std::string path = Bench::tempPath("rhythin_bench_source_load.ry");
+    std::string code = generateSource(mb * 1024 * 1024);
+    if (!Bench::writeFile(path, code))
+    {
+        std::fprintf(stderr, "could not write %s\n", path.c_str());
+        return 1;
+    }
+    const int runs = 5;
+
+    double legacy_load = Bench::bestOf(runs, [&] {
+        std::string loaded = legacyLoad(path);
+        std::string lexer_copy = loaded; // the old Lexer(std::string) took its input by value
+        Bench::keep(lexer_copy);
+    });
+    double mapped_load = Bench::bestOf(runs, [&] {
+        SourceBuffer buffer;
+        buffer.load(path);
+        Bench::keep(buffer.view());
+    });
+    double streamed_load = Bench::bestOf(runs, [&] {
+        SourceBuffer buffer;
+        buffer.loadStreamed(path);
+        Bench::keep(buffer.view());
+    });
+
+    std::size_t tokens = 0;
+    double legacy_lex = Bench::bestOf(runs, [&] {
+        std::string loaded = legacyLoad(path);
+        std::string lexer_copy = loaded;
+        tokens = lexAll(lexer_copy);
+    });
+    double mapped_lex = Bench::bestOf(runs, [&] {
+        SourceBuffer buffer;
+        buffer.load(path);
+        tokens = lexAll(buffer.view());
+    });
+
+    double size = Bench::megabytes(code.size());
+    std::printf("source: %.1f MB, %zu tokens\n", size, tokens);
+    std::printf("%-28s %10s %10s\n", "path", "ms", "MB/s");
+    std::printf("%-28s %10.2f %10.1f\n", "load: getline (legacy)", legacy_load * 1e3, size / legacy_load);
+    std::printf("%-28s %10.2f %10.1f\n", "load: mmap", mapped_load * 1e3, size / mapped_load);
+    std::printf("%-28s %10.2f %10.1f\n", "load: streamed", streamed_load * 1e3, size / streamed_load);
+    std::printf("%-28s %10.2f %10.1f\n", "load+lex: getline (legacy)", legacy_lex * 1e3, size / legacy_lex);
+    std::printf("%-28s %10.2f %10.1f\n", "load+lex: mmap", mapped_lex * 1e3, size / mapped_lex);
+
+    std::remove(path.c_str());
+    return 0;
+}
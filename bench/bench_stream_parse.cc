@@ -0,0 +1,93 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// lex + parse time and token memory: batch mode (whole TokenStream first) vs streaming mode (TokenWindow)
+// usage: bench_stream_parse [size in MB (default 8)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/log.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+#include "../src/tokens/token_window.hpp"
+
+using namespace Rythin;
+
+static std::string generateSource(std::size_t target_bytes)
+{
+    std::string code;
+    code.reserve(target_bytes + 512);
+    int n = 0;
+    while (code.size() < target_bytes)
+    {
+        code += "def generated_function_" + std::to_string(n) + ":func(first_argument:int32, second_argument:float64) -> [\n";
+        code += "    def accumulated_value:int32 := first_argument + 20 * 3\n";
+        code += "    def label:charseq := \"generated string literal number " + std::to_string(n) + "\"\n";
+        code += "    printnl(\"value is not twenty three\")\n";
+        code += "]\n";
+        n++;
+    }
+    return code;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t mb = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 8;
+    std::string code = generateSource(mb * 1024 * 1024);
+    const int runs = 3;
+
+    std::size_t nodes = 0;
+    std::size_t count = 0;
+    std::size_t batch_bytes = 0;
+    double batch_time = Bench::bestOf(runs, [&] {
+        Lexer lexer(code);
+        TokenStream tokens(code);
+        lexer.tokenize(tokens);
+        AstArena arena;
+        Parser parser(tokens, arena);
+        std::vector<ASTPtr> ast = parser.Parse();
+        batch_bytes = tokens.memoryUsage();
+        count = tokens.size();
+        nodes = ast.size();
+    });
+
+    std::size_t stream_bytes = 0;
+    std::size_t ring = 0;
+    double stream_time = Bench::bestOf(runs, [&] {
+        Lexer lexer(code);
+        TokenWindow window(lexer, code);
+        AstArena arena;
+        Parser parser(window, arena);
+        std::vector<ASTPtr> ast = parser.Parse();
+        stream_bytes = window.memoryUsage();
+        ring = window.capacity();
+        if (ast.size() != nodes || window.lexed() != count)
+            std::fprintf(stderr, "the modes disagree: %zu/%zu nodes, %zu/%zu tokens\n", ast.size(), nodes, window.lexed(), count);
+    });
+
+    if (Log::LogErrors::getInstance().getErrSize() != 0)
+        Log::LogErrors::getInstance().printAll();
+
+    std::printf("source: %.1f MB, %zu tokens, %zu top level nodes\n", Bench::megabytes(code.size()), count, nodes);
+    std::printf("%-22s %10s %10s %16s\n", "mode", "ms", "MB/s", "token memory");
+    std::printf("%-22s %10.2f %10.1f %13.2f MB\n", "batch (TokenStream)", batch_time * 1e3, Bench::megabytes(code.size()) / batch_time, Bench::megabytes(batch_bytes));
+    std::printf("%-22s %10.2f %10.1f %13zu B  (ring of %zu)\n", "streaming (window)", stream_time * 1e3, Bench::megabytes(code.size()) / stream_time, stream_bytes, ring);
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// memory and time of the token list: std::vector<Tokens> vs TokenStream
+// usage: bench_token_stream [tokens (default 1000000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/tokens/t_tokens.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generateSource(std::size_t target_tokens)
+{
+    std::string code;
+    std::size_t tokens = 0;
+    int n = 0;
+    while (tokens < target_tokens)
+    {
+        // 25 tokens per round
+        code += "def fn_" + std::to_string(n) + ":func() -> [\n";
+        code += "    def value_" + std::to_string(n) + ":int32 := 10 + 20 * 3\n";
+        code += "    printnl(\"generated string literal\")\n";
+        code += "]\n";
+        tokens += 25;
+        n++;
+    }
+    return code;
+}
+
+static std::size_t vectorMemory(const std::vector<Tokens> &tokens)
+{
+    std::size_t bytes = tokens.capacity() * sizeof(Tokens);
+    for (const Tokens &tk : tokens)
+    {
+        if (tk.value.capacity() > 15) // out of the small string buffer
+            bytes += tk.value.capacity() + 1;
+    }
+    return bytes;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t target = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::string code = generateSource(target);
+    const int runs = 3;
+
+    // the old layout: every token owns its value and is pushed by value
+    std::size_t legacy_bytes = 0;
+    std::size_t count = 0;
+    double legacy_time = Bench::bestOf(runs, [&] {
+        Lexer lexer(code);
+        std::vector<Tokens> tokens;
+        while (true)
+        {
+            RawToken tk = lexer.next_tk();
+            std::string value = TokenStream::hasPayload(tk.type) ? tk.text : std::string(code.substr(tk.offset, tk.length));
+            tokens.push_back(Tokens(tk.type, value, 0, 0));
+            if (tk.type == TokensTypes::TOKEN_EOF)
+                break;
+        }
+        // and the Parser constructor copied the vector once more
+        std::vector<Tokens> parser_copy = tokens;
+        legacy_bytes = vectorMemory(tokens) + vectorMemory(parser_copy);
+        count = tokens.size();
+    });
+
+    std::size_t stream_bytes = 0;
+    double stream_time = Bench::bestOf(runs, [&] {
+        Lexer lexer(code);
+        TokenStream tokens(code);
+        lexer.tokenize(tokens);
+        stream_bytes = tokens.memoryUsage();
+        count = tokens.size();
+    });
+
+    std::printf("source: %.1f MB, %zu tokens\n", Bench::megabytes(code.size()), count);
+    std::printf("%-26s %10s %12s %10s\n", "layout", "ms", "MB", "B/token");
+    std::printf("%-26s %10.2f %12.2f %10.1f\n", "std::vector<Tokens> (x2)", legacy_time * 1e3, Bench::megabytes(legacy_bytes), double(legacy_bytes) / count);
+    std::printf("%-26s %10.2f %12.2f %10.1f\n", "TokenStream", stream_time * 1e3, Bench::megabytes(stream_bytes), double(stream_bytes) / count);
+    return 0;
+}
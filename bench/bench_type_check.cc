@@ -0,0 +1,95 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// type pass on units of growing size (after the parser and the semantic pass): the time per
+// function must stay flat as the unit grows, and so must the IR made for each one
+// usage: bench_type_check [functions of the biggest unit (default 80000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/log.hpp"
+#include "../src/includes/semantic_visitor.hpp"
+#include "../src/includes/type_checker.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generated(std::size_t functions)
+{
+    // the arguments are not constants, so nothing is folded away before the pass
+    std::string code = "def offset:int64 := 40\n";
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        code += "def function_" + std::to_string(n) + ":func(first:int32, second:float64, small:byte) -> [\n";
+        code += "    def total:int64 := first * 3 + small - offset\n";
+        code += "    def ratio:float64 := second / first + total\n";
+        code += "    def label:charseq := \"total $[total] ratio $[ratio]\"\n";
+        code += "    if (total != 23) -> [\n";
+        code += "        printnl(label)\n";
+        code += "    ]\n";
+        code += "    loop (step:int32 in first) -> [\n";
+        code += "        def shifted:int32 := step << 2 | first\n";
+        code += "    ]\n";
+        if (n > 0)
+            code += "    def result:obj := function_" + std::to_string(n - 1) + "(first, second, small)\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t biggest = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 80000;
+
+    std::printf("%10s %10s %12s %14s %14s %12s %8s\n", "functions", "MB", "semantic ms", "type pass ms", "ns/function", "IR insts", "errors");
+    for (std::size_t functions = biggest / 8; functions <= biggest && functions > 0; functions *= 2)
+    {
+        std::string code = generated(functions);
+        TokenStream tokens(code);
+        Lexer(code).tokenize(tokens);
+        AstArena arena;
+        Parser parser(tokens, arena);
+        std::vector<ASTPtr> nodes = parser.Parse();
+
+        std::size_t errors = 0, type_errors = 0, instructions = 0;
+        double semantic = Bench::bestOf(5, [&] {
+            std::vector<Log::LogErrors::Held> diagnostics;
+            Log::LogErrors::Hold hold(diagnostics);
+            SemanticAnalyzer analyzer;
+            for (ASTPtr node : nodes)
+                analyzer.VisitNode(node);
+            errors = diagnostics.size();
+        });
+        double typed = Bench::bestOf(5, [&] {
+            std::vector<Log::LogErrors::Held> diagnostics;
+            Log::LogErrors::Hold hold(diagnostics);
+            IrUnit unit;
+            TypeChecker checker(unit);
+            checker.check(nodes);
+            instructions = unit.instructions();
+            type_errors = diagnostics.size();
+        });
+        std::printf("%10zu %10.1f %12.2f %14.2f %14.1f %12zu %8zu\n", functions, Bench::megabytes(code.size()), semantic * 1e3, typed * 1e3,
+                    typed * 1e9 / functions, instructions, errors + type_errors);
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BENCH_UTIL_HPP
+#define BENCH_UTIL_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+// small helpers shared by the benchmark programs
+namespace Bench
+{
+    class Timer
+    {
+    public:
+        Timer() : start(std::chrono::steady_clock::now()) {}
+        double seconds() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // runs the function some times and returns the best wall time (in seconds)
+    template <typename Fn>
+    double bestOf(int runs, Fn &&fn)
+    {
+        double best = 1e300;
+        for (int i = 0; i < runs; i++)
+        {
+            Timer t;
+            fn();
+            double s = t.seconds();
+            if (s < best)
+                best = s;
+        }
+        return best;
+    }
+
+    inline double megabytes(std::size_t bytes)
+    {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+
+    inline std::string tempPath(const std::string &name)
+    {
+        const char *dir = std::getenv("TMPDIR");
+        std::string base = (dir != nullptr && *dir != '\0') ? dir : "/tmp";
+#if defined(_WIN32)
+        if (dir == nullptr)
+            base = ".";
+#endif
+        return base + "/" + name;
+    }
+
+    inline bool writeFile(const std::string &path, const std::string &content)
+    {
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+        return static_cast<bool>(out);
+    }
+
+    // keeps the optimizer from throwing away the measured work
+    template <typename T>
+    inline void keep(const T &value)
+    {
+        static volatile const void *sink;
+        sink = &value;
+    }
+}
+
+#endif // BENCH_UTIL_HPP
@@ -0,0 +1,132 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// dispatch cost per node of ASTVisitor::VisitNode: the old chain of ten dynamic_casts
+// vs the switch on the NodeKind tag, over every node of a parsed corpus
+// usage: bench_visitor [functions (default 20000)]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/ast_visit.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+using namespace Rythin;
+
+static std::string generateCorpus(std::size_t functions)
+{
+    std::string code;
+    for (std::size_t n = 0; n < functions; n++)
+    {
+        std::string id = std::to_string(n);
+        code += "def function_" + id + ":func(first:int32, second:float64) -> [\n";
+        code += "    def total_" + id + ":int32 := 20 * 3 / 2 * 7\n";
+        code += "    def ratio_" + id + ":float64 := 1.5 * 2.25 / 3.0\n";
+        code += "    def label_" + id + ":charseq := \"label \" + \"number\"\n";
+        code += "    printnl(\"generated function\")\n";
+        code += "    if (first == 3) -> [\n";
+        code += "        print(\"three\")\n";
+        code += "    ]\n";
+        code += "    loop (true) -> [\n";
+        code += "        printnl(\"again\")\n";
+        code += "    ]\n";
+        code += "]\n";
+    }
+    return code;
+}
+
+// counts the calls, so the dispatch can't be thrown away
+class CountingVisitor : public ASTVisitor
+{
+public:
+    std::size_t calls = 0;
+    void Visit(PrintNode &) override { calls++; }
+    void Visit(PrintNl &) override { calls++; }
+    void Visit(VariableNode &) override { calls++; }
+    void Visit(FunctionDefinitionNode &) override { calls++; }
+    void Visit(VariableDefinitionNode &) override { calls++; }
+    void Visit(BinOp &) override { calls++; }
+    void Visit(IfStatement &) override { calls++; }
+    void Visit(ReturnNode &) override { calls++; }
+    void Visit(BlockNode &) override { calls++; }
+    void Visit(InterpolationNode &) override { calls++; }
+};
+
+// the dispatch before the NodeKind tag (raw pointers now, so without the refcount bumps it also had)
+static void legacyVisitNode(ASTVisitor &v, ASTPtr node)
+{
+    if (!node) return;
+
+    if (auto n = dynamic_cast<PrintNode *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<PrintNl *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<VariableNode *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<FunctionDefinitionNode *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<VariableDefinitionNode *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<BinOp *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<IfStatement *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<ReturnNode *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<BlockNode *>(node)) v.Visit(*n);
+    if (auto n = dynamic_cast<InterpolationNode *>(node)) v.Visit(*n);
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t functions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    std::string code = generateCorpus(functions);
+
+    Lexer lexer(code);
+    TokenStream tokens(code);
+    lexer.tokenize(tokens);
+    AstArena arena;
+    Parser parser(tokens, arena);
+    parser.Parse();
+    const std::vector<ASTNode *> &nodes = arena.all();
+
+    const int passes = 20;
+    CountingVisitor legacy;
+    double legacy_time = Bench::bestOf(3, [&] {
+        legacy.calls = 0;
+        for (int pass = 0; pass < passes; pass++)
+            for (ASTNode *node : nodes)
+                legacyVisitNode(legacy, node);
+    });
+
+    CountingVisitor tagged;
+    double tag_time = Bench::bestOf(3, [&] {
+        tagged.calls = 0;
+        for (int pass = 0; pass < passes; pass++)
+            for (ASTNode *node : nodes)
+                tagged.VisitNode(node);
+    });
+
+    if (legacy.calls != tagged.calls)
+    {
+        std::fprintf(stderr, "the dispatches disagree: %zu vs %zu calls\n", legacy.calls, tagged.calls);
+        return 1;
+    }
+
+    double visits = static_cast<double>(nodes.size()) * passes;
+    std::printf("%zu nodes, %d passes, %zu overridden visits per pass\n", nodes.size(), passes, tagged.calls / passes);
+    std::printf("%-28s %10s %10s\n", "dispatch", "ms", "ns/node");
+    std::printf("%-28s %10.2f %10.2f\n", "dynamic_cast chain", legacy_time * 1e3, legacy_time * 1e9 / visits);
+    std::printf("%-28s %10.2f %10.2f\n", "NodeKind switch", tag_time * 1e3, tag_time * 1e9 / visits);
+    return 0;
+}
@@ -0,0 +1,409 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// throughput and allocations of the frontend (lexer, parser, folding and the semantic pass)
+// on generated sources, one case per shape of code. For tracking between releases, the
+// json and csv formats have one record per case with every number.
+// usage: rhythin_bench [--case NAME] [--functions N] [--depth N] [--expr N] [--strings N]
+//                      [--comments N] [--runs N] [--format text|json|csv]
+// with no shape flag every case of the table is run, a shape flag runs one "custom" case
+// (the base case with the flags applied)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+#include "bench_util.hpp"
+#include "../src/includes/ast_arena.hpp"
+#include "../src/includes/const_folder.hpp"
+#include "../src/includes/semantic_visitor.hpp"
+#include "../src/lexer/r_lex.hpp"
+#include "../src/parser/r_parser.hpp"
+#include "../src/tokens/token_stream.hpp"
+
+#ifndef RHYTHIN_VERSION
+    #define RHYTHIN_VERSION "dev"
+#endif
+
+using namespace Rythin;
+
+// every allocation of the program goes through here: count, bytes, live and peak heap
+static std::size_t allocations = 0;
+static std::size_t allocated_bytes = 0;
+static std::size_t live_bytes = 0;
+static std::size_t peak_bytes = 0;
+
+void *operator new(std::size_t size)
+{
+    std::size_t *p = static_cast<std::size_t *>(std::malloc(size + sizeof(std::size_t) * 2));
+    if (!p)
+        throw std::bad_alloc();
+    p[0] = size;
+    allocations++;
+    allocated_bytes += size;
+    live_bytes += size;
+    if (live_bytes > peak_bytes)
+        peak_bytes = live_bytes;
+    return p + 2;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+    std::size_t *p = static_cast<std::size_t *>(ptr) - 2;
+    live_bytes -= p[0];
+    std::free(p);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+// peak resident set of the process so far, in bytes (it never goes down)
+static std::size_t peakRss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// the shape of the generated code
+struct Shape
+{
+    std::size_t functions = 20000;
+    std::size_t depth = 1;    // ifs and loops nested in each function
+    std::size_t expr = 4;     // operands of the value expressions
+    std::size_t strings = 1;  // printnl with a "$[first]" hole per level
+    std::size_t comments = 1; // comment lines before each function
+};
+
+struct Case
+{
+    const char *name;
+    Shape shape;
+};
+
+static std::vector<Case> cases()
+{
+    std::vector<Case> table;
+    Shape base;
+    table.push_back({"base", base});
+    Shape s = base;
+    s.functions = base.functions * 4;
+    table.push_back({"functions", s});
+    s = base;
+    s.depth = 12;
+    table.push_back({"nesting", s});
+    s = base;
+    s.expr = 48;
+    table.push_back({"expressions", s});
+    s = base;
+    s.strings = 8;
+    table.push_back({"strings", s});
+    s = base;
+    s.comments = 24;
+    table.push_back({"comments", s});
+    return table;
+}
+
+static std::string generate(const Shape &shape)
+{
+    std::string code;
+    for (std::size_t n = 0; n < shape.functions; n++)
+    {
+        std::string id = std::to_string(n);
+        for (std::size_t c = 0; c < shape.comments; c++)
+            code += "; comment line " + std::to_string(c) + " of the generated function " + id + ", about what it does\n";
+        code += "def function_" + id + ":func(first:int32, second:float64) -> [\n";
+
+        // every third operand is the argument, so the semantic pass resolves names too
+        code += "    def total_" + id + ":int32 := 1";
+        for (std::size_t e = 1; e < shape.expr; e++)
+        {
+            static const char *ops[] = {" + ", " * ", " - "};
+            code += ops[e % 3] + ((e % 3 == 2) ? std::string("first") : std::to_string(e % 90 + 1));
+        }
+        code += "\n";
+
+        std::string indent = "    ";
+        for (std::size_t d = 0; d < shape.depth; d++)
+        {
+            for (std::size_t k = 0; k < shape.strings; k++)
+                code += indent + "printnl(\"level " + std::to_string(d) + " of $[first] and $[second]\")\n";
+            code += indent + ((d % 2) ? "loop (true) -> [\n" : "if (first != " + std::to_string(d) + ") -> [\n");
+            indent += "    ";
+        }
+        code += indent + "print(\"innermost\")\n";
+        for (std::size_t d = shape.depth; d > 0; d--)
+        {
+            indent.resize(indent.size() - 4);
+            code += indent + "]\n";
+        }
+        code += "]\n";
+    }
+    return code;
+}
+
+// one phase of the pipeline: the best time over the runs, the allocations of the last run
+struct Phase
+{
+    double seconds = 1e300;
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+};
+
+struct Result
+{
+    std::string name;
+    Shape shape;
+    std::size_t source_bytes = 0, tokens = 0, nodes = 0;
+    Phase lex, parse, fold, semantic;
+    std::size_t peak_heap = 0, peak_rss = 0;
+};
+
+class Measure
+{
+public:
+    explicit Measure(Phase &phase) : phase(phase), allocs(allocations), bytes(allocated_bytes) {}
+    ~Measure()
+    {
+        double s = timer.seconds();
+        if (s < phase.seconds)
+            phase.seconds = s;
+        phase.allocations = allocations - allocs;
+        phase.bytes = allocated_bytes - bytes;
+    }
+
+private:
+    Phase &phase;
+    std::size_t allocs, bytes;
+    Bench::Timer timer;
+};
+
+static Result run(const Case &c, int runs)
+{
+    Result r;
+    r.name = c.name;
+    r.shape = c.shape;
+    std::string code = generate(c.shape);
+    r.source_bytes = code.size();
+
+    peak_bytes = live_bytes;
+    for (int i = 0; i < runs; i++)
+    {
+        AstArena arena;
+        std::vector<ASTPtr> nodes;
+        TokenStream *tokens;
+        {
+            Measure m(r.lex);
+            tokens = new TokenStream(code);
+            Lexer(code).tokenize(*tokens);
+        }
+        {
+            Measure m(r.parse);
+            Parser parser(*tokens, arena);
+            nodes = parser.Parse();
+        }
+        r.nodes = arena.size();
+        {
+            Measure m(r.fold);
+            ConstantFolder folder(arena);
+            for (ASTPtr &node : nodes)
+                node = folder.fold(node);
+        }
+        {
+            Measure m(r.semantic);
+            SemanticAnalyzer analyzer;
+            for (ASTPtr node : nodes)
+                analyzer.VisitNode(node);
+        }
+        r.tokens = tokens->size();
+        delete tokens;
+    }
+    r.peak_heap = peak_bytes;
+    r.peak_rss = peakRss();
+    return r;
+}
+
+static double mbs(const Result &r, const Phase &p) { return Bench::megabytes(r.source_bytes) / p.seconds; }
+
+static void printText(const std::vector<Result> &results)
+{
+    std::printf("rhythin %s\n", RHYTHIN_VERSION);
+    for (const Result &r : results)
+    {
+        std::printf("\n%s: %zu functions, depth %zu, expr %zu, strings %zu, comments %zu\n", r.name.c_str(), r.shape.functions,
+                    r.shape.depth, r.shape.expr, r.shape.strings, r.shape.comments);
+        std::printf("  source %.1f MB, %zu tokens, %zu nodes, peak heap %.1f MB, peak rss %.1f MB\n",
+                    Bench::megabytes(r.source_bytes), r.tokens, r.nodes, Bench::megabytes(r.peak_heap), Bench::megabytes(r.peak_rss));
+        std::printf("  %-9s %10s %10s %12s %12s %12s %10s\n", "phase", "ms", "MB/s", "tokens/s", "nodes/s", "allocs", "MB alloc");
+        const std::pair<const char *, const Phase *> phases[] = {{"lex", &r.lex}, {"parse", &r.parse}, {"fold", &r.fold}, {"semantic", &r.semantic}};
+        for (const auto &[name, p] : phases)
+        {
+            std::printf("  %-9s %10.2f %10.1f %12.3e %12.3e %12zu %10.1f\n", name, p->seconds * 1e3, mbs(r, *p),
+                        r.tokens / p->seconds, r.nodes / p->seconds, p->allocations, Bench::megabytes(p->bytes));
+        }
+    }
+}
+
+static void printJsonPhase(const char *name, const Result &r, const Phase &p)
+{
+    std::printf("\"%s\":{\"seconds\":%.6f,\"mb_per_s\":%.3f,\"tokens_per_s\":%.1f,\"nodes_per_s\":%.1f,\"allocations\":%zu,\"allocated_bytes\":%zu}",
+                name, p.seconds, mbs(r, p), r.tokens / p.seconds, r.nodes / p.seconds, p.allocations, p.bytes);
+}
+
+// one json object per line
+static void printJson(const std::vector<Result> &results)
+{
+    for (const Result &r : results)
+    {
+        std::printf("{\"version\":\"%s\",\"case\":\"%s\",\"functions\":%zu,\"depth\":%zu,\"expr\":%zu,\"strings\":%zu,\"comments\":%zu,",
+                    RHYTHIN_VERSION, r.name.c_str(), r.shape.functions, r.shape.depth, r.shape.expr, r.shape.strings, r.shape.comments);
+        std::printf("\"source_bytes\":%zu,\"tokens\":%zu,\"nodes\":%zu,\"peak_heap_bytes\":%zu,\"peak_rss_bytes\":%zu,",
+                    r.source_bytes, r.tokens, r.nodes, r.peak_heap, r.peak_rss);
+        printJsonPhase("lex", r, r.lex);
+        std::printf(",");
+        printJsonPhase("parse", r, r.parse);
+        std::printf(",");
+        printJsonPhase("fold", r, r.fold);
+        std::printf(",");
+        printJsonPhase("semantic", r, r.semantic);
+        std::printf("}\n");
+    }
+}
+
+// one row per case and phase
+static void printCsv(const std::vector<Result> &results)
+{
+    std::printf("version,case,functions,depth,expr,strings,comments,source_bytes,tokens,nodes,peak_heap_bytes,peak_rss_bytes,"
+                "phase,seconds,mb_per_s,tokens_per_s,nodes_per_s,allocations,allocated_bytes\n");
+    for (const Result &r : results)
+    {
+        const std::pair<const char *, const Phase *> phases[] = {{"lex", &r.lex}, {"parse", &r.parse}, {"fold", &r.fold}, {"semantic", &r.semantic}};
+        for (const auto &[name, p] : phases)
+        {
+            std::printf("%s,%s,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%s,%.6f,%.3f,%.1f,%.1f,%zu,%zu\n", RHYTHIN_VERSION,
+                        r.name.c_str(), r.shape.functions, r.shape.depth, r.shape.expr, r.shape.strings, r.shape.comments,
+                        r.source_bytes, r.tokens, r.nodes, r.peak_heap, r.peak_rss, name, p->seconds, mbs(r, *p),
+                        r.tokens / p->seconds, r.nodes / p->seconds, p->allocations, p->bytes);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<Case> table = cases();
+    const char *only = nullptr;
+    const char *format = "text";
+    int runs = 3;
+    bool custom = false;
+    Shape shape;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *flag = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value)
+        {
+            std::fprintf(stderr, "%s needs a value\n", flag);
+            return 2;
+        }
+        i++;
+        std::size_t n = std::strtoul(value, nullptr, 10);
+        if (std::strcmp(flag, "--case") == 0)
+            only = value;
+        else if (std::strcmp(flag, "--format") == 0)
+            format = value;
+        else if (std::strcmp(flag, "--runs") == 0)
+            runs = n > 0 ? static_cast<int>(n) : 1;
+        else if (std::strcmp(flag, "--functions") == 0)
+            custom = true, shape.functions = n;
+        else if (std::strcmp(flag, "--depth") == 0)
+            custom = true, shape.depth = n;
+        else if (std::strcmp(flag, "--expr") == 0)
+            custom = true, shape.expr = n > 0 ? n : 1;
+        else if (std::strcmp(flag, "--strings") == 0)
+            custom = true, shape.strings = n;
+        else if (std::strcmp(flag, "--comments") == 0)
+            custom = true, shape.comments = n;
+        else
+        {
+            std::fprintf(stderr, "unknown flag %s\n", flag);
+            return 2;
+        }
+    }
+    if (std::strcmp(format, "text") != 0 && std::strcmp(format, "json") != 0 && std::strcmp(format, "csv") != 0)
+    {
+        std::fprintf(stderr, "unknown format %s (text, json or csv)\n", format);
+        return 2;
+    }
+
+    std::vector<Case> selected;
+    if (custom)
+        selected.push_back({"custom", shape});
+    for (const Case &c : table)
+    {
+        if (!custom && (!only || std::strcmp(only, c.name) == 0))
+            selected.push_back(c);
+    }
+    if (selected.empty())
+    {
+        std::fprintf(stderr, "no case named %s\n", only);
+        return 2;
+    }
+
+    std::vector<Result> results;
+    for (const Case &c : selected)
+        results.push_back(run(c, runs));
+    if (Log::LogErrors::getInstance().getErrSize() != 0)
+    {
+        // the generated code must be valid, or the numbers are of the error recovery
+        Log::LogErrors::getInstance().printAll();
+        return 1;
+    }
+
+    if (std::strcmp(format, "json") == 0)
+        printJson(results);
+    else if (std::strcmp(format, "csv") == 0)
+        printCsv(results);
+    else
+        printText(results);
+    return 0;
+}
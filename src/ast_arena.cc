@@ -0,0 +1,78 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "../src/includes/ast_arena.hpp"
+
+namespace Rythin
+{
+    AstArena::~AstArena()
+    {
+        // only the node's own members (strings, vectors) are freed here,
+        // the children are plain pointers to other nodes of the arena
+        for (ASTNode *node : nodes)
+            node->~ASTNode();
+    }
+
+    void AstArena::clear()
+    {
+        for (ASTNode *node : nodes)
+            node->~ASTNode();
+        nodes.clear();
+        if (blocks.size() > 1)
+        {
+            blocks.resize(1);
+            block_bytes = block_size;
+        }
+        used = blocks.empty() ? block_size : 0;
+    }
+
+    void AstArena::adopt(AstArena &other)
+    {
+        if (other.blocks.empty())
+            return;
+        // the new nodes go on the last block taken, the free end of ours is not used again
+        for (std::unique_ptr<char[]> &block : other.blocks)
+            blocks.push_back(std::move(block));
+        nodes.insert(nodes.end(), other.nodes.begin(), other.nodes.end());
+        block_bytes += other.block_bytes;
+        used = other.used;
+
+        other.blocks.clear();
+        other.nodes.clear();
+        other.block_bytes = 0;
+        other.used = block_size;
+    }
+
+    void *AstArena::allocate(std::size_t size)
+    {
+        constexpr std::size_t align = alignof(std::max_align_t);
+        size = (size + align - 1) & ~(align - 1);
+        if (used + size > block_size)
+        {
+            std::size_t bytes = size > block_size ? size : block_size;
+            blocks.emplace_back(new char[bytes]); // not zeroed, the constructors set the nodes
+            block_bytes += bytes;
+            used = 0;
+        }
+        void *p = blocks.back().get() + used;
+        used += size;
+        return p;
+    }
+
+    std::size_t AstArena::memoryUsage() const
+    {
+        return block_bytes + nodes.capacity() * sizeof(ASTNode *);
+    }
+}
@@ -0,0 +1,353 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "../src/includes/ast_cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+
+#include "../src/includes/interner.hpp"
+#include "../src/includes/source_buffer.hpp"
+
+// set by the build (the project version)
+#ifndef RHYTHIN_VERSION
+    #define RHYTHIN_VERSION "dev"
+#endif
+
+namespace fs = std::filesystem;
+using namespace Log;
+
+namespace Rythin
+{
+    namespace
+    {
+        // sections of an entry, in file order, right after the header
+        enum Section : uint32_t
+        {
+            NODES,
+            ROOTS,
+            LISTS,
+            NUMBERS,
+            STRINGS,
+            CHARS,
+            PLANS,
+            SLOTS,
+            NAME_LENGTHS,  // the spellings of the symbols 1, 2, 3...
+            NAME_CHARS,
+            WARNINGS,
+            WARNING_CHARS, // their messages, back to back
+            SECTION_COUNT,
+        };
+
+        struct Header
+        {
+            char magic[4];
+            uint32_t format;
+            uint64_t compiler;
+            uint64_t source_size;
+            uint32_t counts[SECTION_COUNT]; // elements of each section
+        };
+
+        struct Warning
+        {
+            int32_t code, line, column;
+            uint32_t length;
+        };
+
+        constexpr char magic[4] = {'R', 'Y', 'A', 'C'};
+
+        uint64_t rotl(uint64_t x, int r)
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        // the version and the layout of the records
+        uint64_t compilerKey()
+        {
+            const uint64_t layout[] = {AstCache::format_version, sizeof(FlatNode), sizeof(Number),
+                                       sizeof(FormatPlan::Slot), Keywords::type_count};
+            return AstCache::hash(std::string_view(reinterpret_cast<const char *>(layout), sizeof(layout)),
+                                  AstCache::hash(RHYTHIN_VERSION));
+        }
+
+        template <typename T>
+        void write(std::string &out, const T *data, std::size_t count)
+        {
+            out.append(reinterpret_cast<const char *>(data), count * sizeof(T));
+        }
+
+        // the sections in order, every take fails once the bytes are over
+        class Reader
+        {
+        public:
+            explicit Reader(std::string_view bytes) : bytes(bytes) {}
+
+            template <typename T>
+            bool raw(T *out, std::size_t count)
+            {
+                std::size_t n = count * sizeof(T);
+                if (bytes.size() - at < n)
+                    return false;
+                if (n)
+                    std::memcpy(out, bytes.data() + at, n);
+                at += n;
+                return true;
+            }
+
+            template <typename Container>
+            bool array(Container &out, std::size_t count)
+            {
+                out.resize(count);
+                return raw(out.data(), count);
+            }
+
+            bool done() const { return at == bytes.size(); }
+
+        private:
+            std::string_view bytes;
+            std::size_t at = 0;
+        };
+    }
+
+    fs::path AstCache::defaultDir()
+    {
+        if (const char *dir = std::getenv("RHYTHIN_CACHE_DIR"))
+            return *dir ? fs::path(dir) : fs::path();
+        if (const char *dir = std::getenv("XDG_CACHE_HOME"); dir && *dir)
+            return fs::path(dir) / "rhythin";
+#if defined(_WIN32)
+        if (const char *dir = std::getenv("LOCALAPPDATA"); dir && *dir)
+            return fs::path(dir) / "rhythin" / "cache";
+#endif
+        if (const char *home = std::getenv("HOME"); home && *home)
+            return fs::path(home) / ".cache" / "rhythin";
+        return fs::path();
+    }
+
+    uint64_t AstCache::hash(std::string_view bytes, uint64_t seed)
+    {
+        // the rounds and the finalizer of murmur3, on 8 byte words
+        const uint64_t c1 = 0x87c37b91114253d5ull, c2 = 0x4cf5ad432745937full;
+        uint64_t h = seed ^ (bytes.size() * 0x9e3779b97f4a7c15ull);
+        std::size_t i = 0;
+        for (; i + 8 <= bytes.size(); i += 8)
+        {
+            uint64_t w;
+            std::memcpy(&w, bytes.data() + i, 8);
+            h ^= rotl(w * c1, 31) * c2;
+            h = rotl(h, 27) * 5 + 0x52dce729;
+        }
+        uint64_t tail = 0;
+        for (std::size_t k = 0; i < bytes.size(); i++, k += 8)
+            tail |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i])) << k;
+        h ^= rotl(tail * c1, 31) * c2;
+
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    fs::path AstCache::entryOf(std::string_view source) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.ryc", static_cast<unsigned long long>(hash(source, compilerKey())));
+        return dir / name;
+    }
+
+    bool AstCache::load(std::string_view source, FlatAst &out, std::vector<LogErrors::Held> &warnings)
+    {
+        if (!enabled())
+            return false;
+        fs::path path = entryOf(source);
+        std::error_code ec;
+        SourceBuffer file;
+        if (!fs::is_regular_file(path, ec) || !file.load(path.string()))
+            return false;
+
+        Reader in(file.view());
+        Header header;
+        if (!in.raw(&header, 1) || std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+            header.format != format_version || header.compiler != compilerKey() || header.source_size != source.size())
+            return false;
+
+        const uint32_t *count = header.counts;
+        std::vector<uint32_t> name_lengths;
+        std::string name_chars;
+        std::vector<Warning> records;
+        std::string warning_chars;
+        bool read = in.array(out.nodes, count[NODES]) && in.array(out.roots, count[ROOTS]) &&
+                    in.array(out.lists, count[LISTS]) && in.array(out.numbers, count[NUMBERS]) &&
+                    in.array(out.strings, count[STRINGS]) && in.array(out.chars, count[CHARS]) &&
+                    in.array(out.plans, count[PLANS]) && in.array(out.slots, count[SLOTS]) &&
+                    in.array(name_lengths, count[NAME_LENGTHS]) && in.array(name_chars, count[NAME_CHARS]) &&
+                    in.array(records, count[WARNINGS]) && in.array(warning_chars, count[WARNING_CHARS]) && in.done();
+
+        // the symbols of the records are ids, the names must get the same ones back
+        Interner &names = Interner::getInstance();
+        std::size_t at = 0;
+        for (std::size_t i = 0; read && i < name_lengths.size(); i++)
+        {
+            read = name_chars.size() - at >= name_lengths[i] &&
+                   names.intern(std::string_view(name_chars).substr(at, name_lengths[i])) == i + 1;
+            at += name_lengths[i];
+        }
+
+        at = 0;
+        for (std::size_t i = 0; read && i < records.size(); i++)
+        {
+            const Warning &w = records[i];
+            read = warning_chars.size() - at >= w.length;
+            if (read)
+                warnings.push_back(LogErrors::Held{warning_chars.substr(at, w.length), w.code, true, {nullptr, 0}, w.line, w.column});
+            at += w.length;
+        }
+
+        if (!read)
+        {
+            out.clear();
+            warnings.clear();
+            return false;
+        }
+        // the last use, for the eviction
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+        return true;
+    }
+
+    bool AstCache::store(std::string_view source, const FlatAst &ast, const std::vector<LogErrors::Held> &warnings)
+    {
+        if (!enabled())
+            return false;
+
+        Interner &names = Interner::getInstance();
+        std::vector<uint32_t> name_lengths;
+        std::string name_chars;
+        for (Symbol id = 1; id < names.size(); id++)
+        {
+            std::string_view s = names.spelling(id);
+            name_lengths.push_back(static_cast<uint32_t>(s.size()));
+            name_chars.append(s);
+        }
+
+        std::vector<Warning> records;
+        std::string warning_chars;
+        for (const LogErrors::Held &w : warnings)
+        {
+            LineColumn at = w.where.index ? w.where.resolve() : LineColumn{w.line, w.column};
+            records.push_back(Warning{w.code, at.line, at.column, static_cast<uint32_t>(w.message.size())});
+            warning_chars.append(w.message);
+        }
+
+        Header header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.format = format_version;
+        header.compiler = compilerKey();
+        header.source_size = source.size();
+        header.counts[NODES] = static_cast<uint32_t>(ast.nodes.size());
+        header.counts[ROOTS] = static_cast<uint32_t>(ast.roots.size());
+        header.counts[LISTS] = static_cast<uint32_t>(ast.lists.size());
+        header.counts[NUMBERS] = static_cast<uint32_t>(ast.numbers.size());
+        header.counts[STRINGS] = static_cast<uint32_t>(ast.strings.size());
+        header.counts[CHARS] = static_cast<uint32_t>(ast.chars.size());
+        header.counts[PLANS] = static_cast<uint32_t>(ast.plans.size());
+        header.counts[SLOTS] = static_cast<uint32_t>(ast.slots.size());
+        header.counts[NAME_LENGTHS] = static_cast<uint32_t>(name_lengths.size());
+        header.counts[NAME_CHARS] = static_cast<uint32_t>(name_chars.size());
+        header.counts[WARNINGS] = static_cast<uint32_t>(records.size());
+        header.counts[WARNING_CHARS] = static_cast<uint32_t>(warning_chars.size());
+
+        std::string bytes;
+        bytes.reserve(sizeof(header) + ast.memoryUsage() + name_chars.size() + name_lengths.size() * 4);
+        write(bytes, &header, 1);
+        write(bytes, ast.nodes.data(), ast.nodes.size());
+        write(bytes, ast.roots.data(), ast.roots.size());
+        write(bytes, ast.lists.data(), ast.lists.size());
+        write(bytes, ast.numbers.data(), ast.numbers.size());
+        write(bytes, ast.strings.data(), ast.strings.size());
+        write(bytes, ast.chars.data(), ast.chars.size());
+        write(bytes, ast.plans.data(), ast.plans.size());
+        write(bytes, ast.slots.data(), ast.slots.size());
+        write(bytes, name_lengths.data(), name_lengths.size());
+        write(bytes, name_chars.data(), name_chars.size());
+        write(bytes, records.data(), records.size());
+        write(bytes, warning_chars.data(), warning_chars.size());
+
+        // written aside and renamed, so a run never maps a half written entry
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        fs::path path = entryOf(source);
+        fs::path temp = path;
+        temp += "." + std::to_string(std::random_device{}()) + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.write(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+            {
+                file.close();
+                fs::remove(temp, ec);
+                return false;
+            }
+        }
+        fs::rename(temp, path, ec);
+        if (ec)
+        {
+            fs::remove(temp, ec);
+            return false;
+        }
+        evict();
+        return true;
+    }
+
+    void AstCache::evict() const
+    {
+        struct Entry
+        {
+            fs::file_time_type used;
+            std::uintmax_t size;
+            fs::path path;
+        };
+        std::vector<Entry> entries;
+        std::uintmax_t total = 0;
+        std::error_code ec;
+        for (const fs::directory_entry &e : fs::directory_iterator(dir, ec))
+        {
+            if (e.path().extension() != ".ryc")
+                continue;
+            std::uintmax_t size = e.file_size(ec);
+            if (ec)
+                continue;
+            entries.push_back(Entry{e.last_write_time(ec), size, e.path()});
+            total += size;
+        }
+        if (total <= max_bytes)
+            return;
+
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.used < b.used; });
+        for (const Entry &e : entries)
+        {
+            if (total <= max_bytes)
+                break;
+            if (fs::remove(e.path, ec))
+                total -= e.size;
+        }
+    }
+}
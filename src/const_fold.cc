@@ -0,0 +1,499 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "../src/includes/const_folder.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "../src/includes/log.hpp"
+
+using namespace Log;
+
+namespace Rythin
+{
+    static bool isInteger(NodeKind kind)
+    {
+        return kind == NodeKind::I32 || kind == NodeKind::I64;
+    }
+
+    static bool isFloat(NodeKind kind)
+    {
+        return kind == NodeKind::F32 || kind == NodeKind::F64;
+    }
+
+    static bool isComparison(TokensTypes op)
+    {
+        return op == TokensTypes::TOKEN_EQUAL || op == TokensTypes::TOKEN_NOT_EQUAL ||
+               op == TokensTypes::TOKEN_LESS_THAN || op == TokensTypes::TOKEN_LESS_EQUAL ||
+               op == TokensTypes::TOKEN_GREATER_THAN || op == TokensTypes::TOKEN_GREATER_EQUAL;
+    }
+
+    template <typename T>
+    static bool compare(TokensTypes op, T a, T b)
+    {
+        switch (op)
+        {
+        case TokensTypes::TOKEN_EQUAL: return a == b;
+        case TokensTypes::TOKEN_NOT_EQUAL: return a != b;
+        case TokensTypes::TOKEN_LESS_THAN: return a < b;
+        case TokensTypes::TOKEN_LESS_EQUAL: return a <= b;
+        case TokensTypes::TOKEN_GREATER_THAN: return a > b;
+        default: return a >= b;
+        }
+    }
+
+    static void notFolded(const std::string &why)
+    {
+        LogErrors::getInstance().addWarning("Constant expression not folded: " + why, 305, 0, 0);
+    }
+
+    // the value as the declared type of a variable, false if it isn't one of that type
+    static bool convert(TokensTypes declared, NodeKind &kind, int64_t integer, double &real)
+    {
+        switch (declared)
+        {
+        case TokensTypes::TOKEN_INT_32:
+            if (!isInteger(kind) || integer < INT32_MIN || integer > INT32_MAX)
+                return false;
+            kind = NodeKind::I32;
+            return true;
+        case TokensTypes::TOKEN_INT_64:
+            if (!isInteger(kind))
+                return false;
+            kind = NodeKind::I64;
+            return true;
+        case TokensTypes::TOKEN_FLOAT_32:
+        case TokensTypes::TOKEN_FLOAT_64:
+            if (kind == NodeKind::TRUE_OR_FALSE)
+                return false;
+            if (isInteger(kind))
+                real = static_cast<double>(integer);
+            kind = (declared == TokensTypes::TOKEN_FLOAT_32) ? NodeKind::F32 : NodeKind::F64;
+            if (kind == NodeKind::F32)
+                real = static_cast<float>(real);
+            return true;
+        case TokensTypes::TOKEN_BOOL:
+            return kind == NodeKind::TRUE_OR_FALSE;
+        default:
+            return false;
+        }
+    }
+
+    bool ConstantFolder::constantOf(ASTPtr node, Constant &out)
+    {
+        if (!node)
+            return false;
+        out.kind = node->kind;
+        switch (node->kind)
+        {
+        case NodeKind::I32: out.integer = static_cast<i32Node *>(node)->val; return true;
+        case NodeKind::I64: out.integer = static_cast<i64Node *>(node)->val; return true;
+        case NodeKind::TRUE_OR_FALSE: out.integer = static_cast<TrueOrFalseNode *>(node)->val; return true;
+        case NodeKind::F32: out.real = static_cast<f32Node *>(node)->val; return true;
+        case NodeKind::F64: out.real = static_cast<f64Node *>(node)->val; return true;
+        default: return false;
+        }
+    }
+
+    ASTPtr ConstantFolder::literal(const Constant &value, uint32_t token)
+    {
+        ASTPtr node;
+        switch (value.kind)
+        {
+        case NodeKind::I32: node = arena.make<i32Node>(static_cast<int32_t>(value.integer)); break;
+        case NodeKind::I64: node = arena.make<i64Node>(value.integer); break;
+        case NodeKind::F32: node = arena.make<f32Node>(static_cast<float>(value.real)); break;
+        case NodeKind::F64: node = arena.make<f64Node>(value.real); break;
+        default: node = arena.make<TrueOrFalseNode>(value.integer != 0); break;
+        }
+        node->token = token;
+        return node;
+    }
+
+    bool ConstantFolder::evaluate(TokensTypes op, const Constant &a, const Constant &b, Constant &out)
+    {
+        bool logical = op == TokensTypes::TOKEN_LOGICAL_AND || op == TokensTypes::TOKEN_LOGICAL_OR;
+
+        // bools only take the logical operators, == and !=
+        if (a.kind == NodeKind::TRUE_OR_FALSE || b.kind == NodeKind::TRUE_OR_FALSE)
+        {
+            if (a.kind != b.kind)
+                return false;
+            if (!logical && op != TokensTypes::TOKEN_EQUAL && op != TokensTypes::TOKEN_NOT_EQUAL)
+                return false;
+        }
+
+        if (logical)
+        {
+            bool l = isFloat(a.kind) ? a.real != 0 : a.integer != 0;
+            bool r = isFloat(b.kind) ? b.real != 0 : b.integer != 0;
+            out.kind = NodeKind::TRUE_OR_FALSE;
+            out.integer = (op == TokensTypes::TOKEN_LOGICAL_AND) ? (l && r) : (l || r);
+            return true;
+        }
+
+        if (isFloat(a.kind) || isFloat(b.kind))
+        {
+            bool single = a.kind != NodeKind::F64 && b.kind != NodeKind::F64;
+            double l = isFloat(a.kind) ? a.real : static_cast<double>(a.integer);
+            double r = isFloat(b.kind) ? b.real : static_cast<double>(b.integer);
+            if (single)
+            {
+                // an int operand becomes a float32, as it would at run time
+                l = static_cast<float>(l);
+                r = static_cast<float>(r);
+            }
+
+            if (isComparison(op))
+            {
+                out.kind = NodeKind::TRUE_OR_FALSE;
+                out.integer = compare(op, l, r);
+                return true;
+            }
+
+            double value;
+            switch (op)
+            {
+            case TokensTypes::TOKEN_PLUS: value = l + r; break;
+            case TokensTypes::TOKEN_MINUS: value = l - r; break;
+            case TokensTypes::TOKEN_MULTIPLY: value = l * r; break;
+            case TokensTypes::TOKEN_DIVIDE: value = l / r; break;
+            case TokensTypes::TOKEN_MODULO: value = std::fmod(l, r); break;
+            default: return false; // no bitwise operators on floats
+            }
+            out.kind = single ? NodeKind::F32 : NodeKind::F64;
+            out.real = single ? static_cast<float>(value) : value;
+            return true;
+        }
+
+        if (isComparison(op))
+        {
+            out.kind = NodeKind::TRUE_OR_FALSE;
+            out.integer = compare(op, a.integer, b.integer);
+            return true;
+        }
+
+        // integers: the result has the type of the widest operand
+        bool wide = a.kind == NodeKind::I64 || b.kind == NodeKind::I64;
+        const char *type = wide ? "int64" : "int32";
+        int bits = wide ? 64 : 32;
+        int64_t l = a.integer, r = b.integer, value = 0;
+        bool overflow = false;
+        switch (op)
+        {
+        case TokensTypes::TOKEN_PLUS: overflow = __builtin_add_overflow(l, r, &value); break;
+        case TokensTypes::TOKEN_MINUS: overflow = __builtin_sub_overflow(l, r, &value); break;
+        case TokensTypes::TOKEN_MULTIPLY: overflow = __builtin_mul_overflow(l, r, &value); break;
+        case TokensTypes::TOKEN_DIVIDE:
+        case TokensTypes::TOKEN_MODULO:
+            if (r == 0)
+            {
+                notFolded("division by zero");
+                return false;
+            }
+            if (r == -1 && l == (wide ? INT64_MIN : INT32_MIN))
+            {
+                overflow = true;
+                break;
+            }
+            value = (op == TokensTypes::TOKEN_DIVIDE) ? l / r : l % r;
+            break;
+        case TokensTypes::TOKEN_SHIFT_LEFT:
+        case TokensTypes::TOKEN_SHIFT_RIGHT:
+            if (r < 0 || r >= bits)
+            {
+                notFolded("shift by " + std::to_string(r) + " on " + type);
+                return false;
+            }
+            if (op == TokensTypes::TOKEN_SHIFT_RIGHT)
+                value = l >> r;
+            else if (wide)
+                value = static_cast<int64_t>(static_cast<uint64_t>(l) << r); // wraps, as in C++20
+            else
+                value = static_cast<int32_t>(static_cast<uint32_t>(l) << r);
+            break;
+        case TokensTypes::TOKEN_REF: value = l & r; break; // '&' after an operand
+        case TokensTypes::TOKEN_BIT_OR: value = l | r; break;
+        case TokensTypes::TOKEN_BIT_XOR: value = l ^ r; break;
+        default: return false;
+        }
+
+        if (!wide && (value < INT32_MIN || value > INT32_MAX))
+            overflow = true;
+        if (overflow)
+        {
+            notFolded(std::string(type) + " overflow");
+            return false;
+        }
+        out.kind = wide ? NodeKind::I64 : NodeKind::I32;
+        out.integer = value;
+        return true;
+    }
+
+    bool ConstantFolder::evaluate(TokensTypes op, const Constant &a, Constant &out)
+    {
+        out = a;
+        if (a.kind == NodeKind::TRUE_OR_FALSE)
+            return false;
+        switch (op)
+        {
+        case TokensTypes::TOKEN_PLUS:
+            return true;
+        case TokensTypes::TOKEN_MINUS:
+            if (isFloat(a.kind))
+            {
+                out.real = -a.real;
+                return true;
+            }
+            if (a.integer == (a.kind == NodeKind::I64 ? INT64_MIN : INT32_MIN))
+            {
+                notFolded(a.kind == NodeKind::I64 ? "int64 overflow" : "int32 overflow");
+                return false;
+            }
+            out.integer = -a.integer;
+            return true;
+        case TokensTypes::TOKEN_BIT_NOT:
+            if (isFloat(a.kind))
+                return false;
+            out.integer = ~a.integer;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void ConstantFolder::bind(Symbol name, ASTPtr value)
+    {
+        if (name >= constants.size())
+        {
+            constants.resize(name + 1, nullptr);
+            bound_at.resize(name + 1, none);
+        }
+        undo.push_back(Undo{name, constants[name], bound_at[name]});
+        constants[name] = value;
+        bound_at[name] = undo.size() - 1;
+    }
+
+    void ConstantFolder::closeScope(std::size_t mark)
+    {
+        while (undo.size() > mark)
+        {
+            constants[undo.back().name] = undo.back().value;
+            bound_at[undo.back().name] = undo.back().at;
+            undo.pop_back();
+        }
+    }
+
+    ASTPtr ConstantFolder::constantNamed(Symbol name) const
+    {
+        if (name >= constants.size())
+            return nullptr;
+        ASTPtr value = constants[name];
+        // walks back to the bind the function saw where it was declared
+        for (std::size_t at = bound_at[name]; at != none && at >= hidden_from && at < hidden_to; at = undo[at].at)
+            value = undo[at].value;
+        return value;
+    }
+
+    void ConstantFolder::foldBody(FunctionDefinitionNode &func)
+    {
+        auto it = declared.find(&func);
+        std::size_t from = hidden_from, to = hidden_to;
+        if (it != declared.end())
+        {
+            hidden_from = it->second;
+            hidden_to = scope();
+        }
+        fold(&func);
+        hidden_from = from;
+        hidden_to = to;
+    }
+
+    // `name op literal` with a constant name becomes the direct bool form of the condition
+    void ConstantFolder::foldCondition(IfExpressionNode &node)
+    {
+        Constant left, right, result;
+        if (node.var_name == Interner::empty || !constantOf(constantNamed(node.var_name), left) || !constantOf(node.val, right) || !isComparison(node.type))
+            return;
+        if (!evaluate(node.type, left, right, result))
+            return;
+        node.type = result.integer ? TokensTypes::TOKEN_TRUE : TokensTypes::TOKEN_FALSE;
+        node.var_name = Interner::empty;
+        node.val = literal(result, node.val->token);
+        count++;
+    }
+
+    ASTPtr ConstantFolder::fold(ASTPtr node)
+    {
+        // post-order on an explicit stack, the generated expressions and blocks can be deeper
+        // than the C++ stack (each frame is the node, where its result goes and how far it got)
+        ASTPtr result = node;
+        std::size_t base = work.size();
+        work.push_back(Frame{node, &result, 0, 0});
+        while (work.size() > base)
+        {
+            ASTPtr *child = next(work.back());
+            if (child)
+            {
+                work.push_back(Frame{*child, child, 0, 0});
+                continue;
+            }
+            *work.back().slot = work.back().node;
+            work.pop_back();
+        }
+        return result;
+    }
+
+    ASTPtr *ConstantFolder::next(Frame &f)
+    {
+        ASTPtr node = f.node;
+        if (!node)
+            return nullptr;
+
+        switch (node->kind)
+        {
+        case NodeKind::BLOCK:
+        {
+            auto &statements = static_cast<BlockNode *>(node)->statements;
+            if (f.step == 0)
+                f.mark = scope();
+            if (f.step < statements.size())
+                return &statements[f.step++];
+            closeScope(f.mark);
+            return nullptr;
+        }
+        case NodeKind::VARIABLE_DEFINITION:
+        {
+            auto n = static_cast<VariableDefinitionNode *>(node);
+            if (f.step++ == 0)
+                return &n->val;
+            Constant value;
+            // a name that is not a constant still hides an outer one
+            if (constantOf(n->val, value) && convert(n->type, value.kind, value.integer, value.real))
+                bind(n->var_name, literal(value, n->val->token));
+            else
+                bind(n->var_name, nullptr);
+            return nullptr;
+        }
+        case NodeKind::FUNCTION_DEFINITION:
+        {
+            auto n = static_cast<FunctionDefinitionNode *>(node);
+            if (f.step++ == 0)
+            {
+                if (n->deferred())
+                    declared.emplace(n, scope());
+                f.mark = scope();
+                for (ASTPtr arg : n->args)
+                    if (auto param = nodeAs<ExpressionNode>(arg))
+                        bind(param->var_name, nullptr);
+                return &n->block;
+            }
+            closeScope(f.mark);
+            return nullptr;
+        }
+        case NodeKind::LOOP:
+        {
+            auto n = static_cast<LoopNode *>(node);
+            switch (f.step++)
+            {
+            case 0:
+                return &n->value;
+            case 1:
+                f.mark = scope();
+                bind(n->var_name, nullptr);
+                return &n->block;
+            default:
+                closeScope(f.mark);
+                return nullptr;
+            }
+        }
+        case NodeKind::LOOP_CONDITION:
+        {
+            auto n = static_cast<LoopConditionNode *>(node);
+            ASTPtr *children[] = {&n->condition, &n->body};
+            return f.step < 2 ? children[f.step++] : nullptr;
+        }
+        case NodeKind::IF_STATEMENT:
+        {
+            auto n = static_cast<IfStatement *>(node);
+            ASTPtr *children[] = {&n->ifCondition, &n->ifBranch, &n->butCondition, &n->butBranch};
+            return f.step < 4 ? children[f.step++] : nullptr;
+        }
+        case NodeKind::IF_EXPRESSION:
+        {
+            auto n = static_cast<IfExpressionNode *>(node);
+            if (f.step++ == 0)
+                return &n->val;
+            foldCondition(*n);
+            return nullptr;
+        }
+        case NodeKind::IDENTIFIER:
+        {
+            auto &args = static_cast<IdentifierNode *>(node)->args;
+            return f.step < args.size() ? &args[f.step++] : nullptr;
+        }
+        case NodeKind::OBJECT:
+            return f.step++ == 0 ? &static_cast<ObjectNode *>(node)->val : nullptr;
+        case NodeKind::RETURN:
+            return f.step++ == 0 ? &static_cast<ReturnNode *>(node)->val : nullptr;
+        case NodeKind::FINISH:
+            return f.step++ == 0 ? &static_cast<FinishNode *>(node)->value : nullptr;
+        case NodeKind::VARIABLE:
+        {
+            Constant value;
+            if (constantOf(constantNamed(static_cast<VariableNode *>(node)->name), value))
+            {
+                count++;
+                f.node = literal(value, node->token);
+            }
+            return nullptr;
+        }
+        case NodeKind::UNARY_OP:
+        {
+            auto n = static_cast<UnaryOp *>(node);
+            if (f.step++ == 0)
+                return &n->operand;
+            Constant operand, result;
+            if (constantOf(n->operand, operand) && evaluate(n->op, operand, result))
+            {
+                count++;
+                f.node = literal(result, node->token);
+            }
+            return nullptr;
+        }
+        case NodeKind::BIN_OP:
+        {
+            auto n = static_cast<BinOp *>(node);
+            switch (f.step++)
+            {
+            case 0:
+                return &n->left;
+            case 1:
+                return &n->right;
+            }
+            Constant left, right, result;
+            if (constantOf(n->left, left) && constantOf(n->right, right) && evaluate(n->op, left, right, result))
+            {
+                count++;
+                f.node = literal(result, node->token);
+            }
+            return nullptr;
+        }
+        default:
+            return nullptr;
+        }
+    }
+}
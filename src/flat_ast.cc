@@ -0,0 +1,568 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "../src/includes/flat_ast.hpp"
+
+#include <algorithm>
+
+namespace Rythin
+{
+    // the kinds whose extra is a list of nodes
+    static bool hasList(NodeKind kind)
+    {
+        return kind == NodeKind::IDENTIFIER || kind == NodeKind::BLOCK || kind == NodeKind::FUNCTION_DEFINITION;
+    }
+
+    uint32_t FlatAst::append(const ASTNode *root)
+    {
+        // pre-order on a stack, not on calls: a generated chain of operators is as deep as it's long.
+        // A node is put, then its children one subtree after the other, as the recursion would
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        std::vector<Put> work{Put{root, FlatNode::none, FlatNode::none, 0}};
+        std::vector<Put> children;
+        while (!work.empty())
+        {
+            Put next = work.back();
+            work.pop_back();
+            link(next, put(next.node, children));
+            work.insert(work.end(), children.rbegin(), children.rend());
+            children.clear();
+        }
+        roots.push_back(index);
+        return index;
+    }
+
+    void FlatAst::link(const Put &child, uint32_t index)
+    {
+        if (child.slot != FlatNode::none)
+        {
+            lists[child.slot] = index;
+            return;
+        }
+        if (child.parent == FlatNode::none)
+            return; // a root
+
+        // the siblings before it are put already, there are 4 of them at most
+        FlatNode &parent = nodes[child.parent];
+        if (parent.first_child == FlatNode::none)
+        {
+            parent.first_child = index;
+        }
+        else
+        {
+            uint32_t last = parent.first_child;
+            while (nodes[last].next_sibling != FlatNode::none)
+                last = nodes[last].next_sibling;
+            nodes[last].next_sibling = index;
+        }
+        parent.present |= child.bit;
+    }
+
+    uint32_t FlatAst::addString(std::string_view s)
+    {
+        strings.push_back(Span{static_cast<uint32_t>(chars.size()), static_cast<uint32_t>(s.size())});
+        chars.append(s);
+        return static_cast<uint32_t>(strings.size() - 1);
+    }
+
+    uint32_t FlatAst::addNumber(Number n)
+    {
+        numbers.push_back(n);
+        return static_cast<uint32_t>(numbers.size() - 1);
+    }
+
+    uint32_t FlatAst::addPlan(const FormatPlan &plan, uint32_t val)
+    {
+        // with no holes the text is the val of the node, it's not stored twice
+        uint32_t text = (string(val) == plan.text) ? val : addString(plan.text);
+        plans.push_back(Plan{text, static_cast<uint32_t>(slots.size()), static_cast<uint32_t>(plan.slots.size())});
+        slots.insert(slots.end(), plan.slots.begin(), plan.slots.end());
+        return static_cast<uint32_t>(plans.size() - 1);
+    }
+
+    uint32_t FlatAst::addList(const std::vector<ASTPtr> &items, std::vector<Put> &children)
+    {
+        // the room is taken first, the items add their own lists after it when they are put
+        uint32_t at = static_cast<uint32_t>(lists.size());
+        lists.resize(lists.size() + items.size() + 1, FlatNode::none);
+        lists[at] = static_cast<uint32_t>(items.size());
+        for (std::size_t i = 0; i < items.size(); i++)
+        {
+            if (items[i])
+                children.push_back(Put{items[i], FlatNode::none, static_cast<uint32_t>(at + 1 + i), 0});
+        }
+        return at;
+    }
+
+    void FlatAst::addChildren(uint32_t parent, std::initializer_list<const ASTNode *> fields, std::vector<Put> &children)
+    {
+        uint8_t bit = 1;
+        for (const ASTNode *child : fields)
+        {
+            if (child)
+                children.push_back(Put{child, parent, FlatNode::none, bit});
+            bit <<= 1;
+        }
+    }
+
+    uint32_t FlatAst::put(const ASTNode *node, std::vector<Put> &children)
+    {
+        // the side arrays grow while the record is filled, so it's always reached by its index
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(FlatNode{node->kind});
+        nodes[index].token = node->token;
+
+        auto type = [&](TokensTypes t) { nodes[index].type = static_cast<uint8_t>(t); };
+        auto integer = [&](int64_t v) { Number n; n.integer = v; nodes[index].payload = addNumber(n); };
+        auto real = [&](double v) { Number n; n.real = v; nodes[index].payload = addNumber(n); };
+
+        switch (node->kind)
+        {
+        case NodeKind::PRINT:
+        {
+            auto n = static_cast<const PrintNode *>(node);
+            nodes[index].payload = addString(n->val);
+            nodes[index].extra = addPlan(n->format, nodes[index].payload);
+            break;
+        }
+        case NodeKind::PRINT_E:
+        {
+            auto n = static_cast<const PrintE *>(node);
+            nodes[index].payload = addString(n->val);
+            nodes[index].extra = addPlan(n->format, nodes[index].payload);
+            break;
+        }
+        case NodeKind::PRINT_NL:
+        {
+            auto n = static_cast<const PrintNl *>(node);
+            nodes[index].payload = addString(n->val);
+            nodes[index].extra = addPlan(n->format, nodes[index].payload);
+            break;
+        }
+        case NodeKind::LITERAL:
+        {
+            auto n = static_cast<const LiteralNode *>(node);
+            nodes[index].payload = addString(n->val);
+            nodes[index].extra = addPlan(n->format, nodes[index].payload);
+            break;
+        }
+        case NodeKind::CINPUT:
+        {
+            auto n = static_cast<const CinputNode *>(node);
+            nodes[index].payload = addString(n->msg);
+            Number time;
+            time.integer = n->time;
+            nodes[index].extra = addNumber(time);
+            break;
+        }
+        case NodeKind::PRINT_ERROR_LOG:
+            nodes[index].payload = addString(static_cast<const PrintErrorLog *>(node)->val);
+            break;
+        case NodeKind::USING:
+        {
+            auto n = static_cast<const UsingNode *>(node);
+            nodes[index].payload = addString(n->using_name);
+            addString(n->using_src);
+            addString(n->from_name);
+            addString(n->from_src);
+            addString(n->get_var_name);
+            break;
+        }
+        case NodeKind::VARIABLE:
+        {
+            auto n = static_cast<const VariableNode *>(node);
+            nodes[index].payload = n->name;
+            nodes[index].extra = n->slot;
+            nodes[index].type2 = n->global;
+            type(n->type);
+            break;
+        }
+        case NodeKind::IDENTIFIER:
+        {
+            auto n = static_cast<const IdentifierNode *>(node);
+            nodes[index].payload = n->name;
+            uint32_t args = addList(n->args, children);
+            nodes[index].extra = args;
+            break;
+        }
+        case NodeKind::BLOCK:
+        {
+            uint32_t statements = addList(static_cast<const BlockNode *>(node)->statements, children);
+            nodes[index].extra = statements;
+            break;
+        }
+        case NodeKind::LOOP_CONDITION:
+        {
+            auto n = static_cast<const LoopConditionNode *>(node);
+            addChildren(index, {n->condition, n->body}, children);
+            break;
+        }
+        case NodeKind::LOOP:
+        {
+            auto n = static_cast<const LoopNode *>(node);
+            nodes[index].payload = n->var_name;
+            type(n->type);
+            addChildren(index, {n->value, n->block}, children);
+            break;
+        }
+        case NodeKind::INTERPOLATION:
+        {
+            auto n = static_cast<const InterpolationNode *>(node);
+            nodes[index].payload = n->var_name;
+            nodes[index].extra = addString(n->val);
+            break;
+        }
+        case NodeKind::I32: integer(static_cast<const i32Node *>(node)->val); break;
+        case NodeKind::I64: integer(static_cast<const i64Node *>(node)->val); break;
+        case NodeKind::BYTE: integer(static_cast<const ByteNode *>(node)->byte); break;
+        case NodeKind::TRUE_OR_FALSE: integer(static_cast<const TrueOrFalseNode *>(node)->val); break;
+        case NodeKind::F64: real(static_cast<const f64Node *>(node)->val); break;
+        case NodeKind::F32: real(static_cast<const f32Node *>(node)->val); break;
+        case NodeKind::IF_STATEMENT:
+        {
+            auto n = static_cast<const IfStatement *>(node);
+            addChildren(index, {n->ifCondition, n->ifBranch, n->butBranch, n->butCondition}, children);
+            break;
+        }
+        case NodeKind::OBJECT:
+            addChildren(index, {static_cast<const ObjectNode *>(node)->val}, children);
+            break;
+        case NodeKind::RETURN:
+            addChildren(index, {static_cast<const ReturnNode *>(node)->val}, children);
+            break;
+        case NodeKind::FINISH:
+        {
+            auto n = static_cast<const FinishNode *>(node);
+            integer(n->val);
+            addChildren(index, {n->value}, children);
+            break;
+        }
+        case NodeKind::NIL:
+            break;
+        case NodeKind::EXPRESSION:
+        {
+            auto n = static_cast<const ExpressionNode *>(node);
+            nodes[index].payload = n->var_name;
+            type(n->type);
+            break;
+        }
+        case NodeKind::UNARY_OP:
+        {
+            auto n = static_cast<const UnaryOp *>(node);
+            type(n->op);
+            addChildren(index, {n->operand}, children);
+            break;
+        }
+        case NodeKind::BIN_OP:
+        {
+            auto n = static_cast<const BinOp *>(node);
+            type(n->op);
+            addChildren(index, {n->left, n->right}, children);
+            break;
+        }
+        case NodeKind::IF_EXPRESSION:
+        {
+            auto n = static_cast<const IfExpressionNode *>(node);
+            nodes[index].payload = n->var_name;
+            type(n->type);
+            nodes[index].type2 = static_cast<uint8_t>(n->logic_divisor);
+            addChildren(index, {n->val}, children);
+            break;
+        }
+        case NodeKind::FUNCTION_DEFINITION:
+        {
+            auto n = static_cast<const FunctionDefinitionNode *>(node);
+            nodes[index].payload = n->var_name;
+            type(n->type);
+            uint32_t args = addList(n->args, children);
+            nodes[index].extra = args;
+            addChildren(index, {n->block}, children);
+            break;
+        }
+        case NodeKind::VARIABLE_DEFINITION:
+        {
+            auto n = static_cast<const VariableDefinitionNode *>(node);
+            nodes[index].payload = n->var_name;
+            type(n->type);
+            addChildren(index, {n->val}, children);
+            break;
+        }
+        }
+        return index;
+    }
+
+    FormatPlan FlatAst::plan(uint32_t index) const
+    {
+        FormatPlan out;
+        const Plan &p = plans[index];
+        out.appendText(string(p.text));
+        for (uint32_t i = 0; i < p.count; i++)
+        {
+            out.slots.push_back(slots[p.slot + i]);
+            out.reserved += FormatPlan::slot_guess;
+        }
+        return out;
+    }
+
+    ASTPtr FlatAst::expand(uint32_t index, AstArena &arena) const
+    {
+        // post-order on a stack, as append: a node is made once its list items and then
+        // its children are, their nodes wait on made in that order
+        struct Expand
+        {
+            uint32_t index;
+            bool ready;
+            std::size_t first; // its first child on made
+        };
+        std::vector<Expand> work{Expand{index, false, 0}};
+        std::vector<ASTPtr> made;
+        while (!work.empty())
+        {
+            Expand &e = work.back();
+            if (e.index == FlatNode::none)
+            {
+                made.push_back(nullptr);
+                work.pop_back();
+                continue;
+            }
+            if (e.ready)
+            {
+                ASTPtr out = make(nodes[e.index], made.data() + e.first, arena);
+                made.resize(e.first);
+                made.push_back(out);
+                work.pop_back();
+                continue;
+            }
+            e.ready = true;
+            e.first = made.size();
+            const FlatNode &node = nodes[e.index];
+            std::size_t at = work.size(); // e goes stale from here
+            if (hasList(node.kind))
+            {
+                for (uint32_t item : list(node.extra))
+                    work.push_back(Expand{item, false, 0});
+            }
+            for (uint32_t child = node.first_child; child != FlatNode::none; child = nodes[child].next_sibling)
+                work.push_back(Expand{child, false, 0});
+            std::reverse(work.begin() + static_cast<std::ptrdiff_t>(at), work.end());
+        }
+        return made.back();
+    }
+
+    ASTPtr FlatAst::make(const FlatNode &node, const ASTPtr *made, AstArena &arena) const
+    {
+        TokensTypes type = static_cast<TokensTypes>(node.type);
+        ASTPtr c[4];
+        ASTPtr out = nullptr;
+
+        auto items = [&](std::vector<ASTPtr> &into) {
+            for (std::size_t i = 0; i < list(node.extra).size(); i++)
+                into.push_back(*made++);
+        };
+        // the node pointers of the struct by their position (null for the clear bits)
+        auto fields = [&](int count) {
+            for (int i = 0; i < count; i++)
+                c[i] = (node.present & (1u << i)) ? *made++ : nullptr;
+        };
+
+        switch (node.kind)
+        {
+        case NodeKind::PRINT:
+        {
+            auto n = arena.make<PrintNode>();
+            n->val = string(node.payload);
+            n->format = plan(node.extra);
+            out = n;
+            break;
+        }
+        case NodeKind::PRINT_E:
+        {
+            auto n = arena.make<PrintE>();
+            n->val = string(node.payload);
+            n->format = plan(node.extra);
+            out = n;
+            break;
+        }
+        case NodeKind::PRINT_NL:
+        {
+            auto n = arena.make<PrintNl>();
+            n->val = string(node.payload);
+            n->format = plan(node.extra);
+            out = n;
+            break;
+        }
+        case NodeKind::LITERAL:
+            out = arena.make<LiteralNode>(std::string(string(node.payload)), plan(node.extra));
+            break;
+        case NodeKind::CINPUT:
+            out = arena.make<CinputNode>(std::string(string(node.payload)), static_cast<int>(numbers[node.extra].integer));
+            break;
+        case NodeKind::PRINT_ERROR_LOG:
+        {
+            auto n = arena.make<PrintErrorLog>();
+            n->val = string(node.payload);
+            out = n;
+            break;
+        }
+        case NodeKind::USING:
+        {
+            auto n = arena.make<UsingNode>();
+            n->using_name = string(node.payload);
+            n->using_src = string(node.payload + 1);
+            n->from_name = string(node.payload + 2);
+            n->from_src = string(node.payload + 3);
+            n->get_var_name = string(node.payload + 4);
+            out = n;
+            break;
+        }
+        case NodeKind::VARIABLE:
+        {
+            auto n = arena.make<VariableNode>();
+            n->name = node.payload;
+            n->slot = node.extra;
+            n->global = node.type2 != 0;
+            n->type = static_cast<TokensTypes>(node.type);
+            out = n;
+            break;
+        }
+        case NodeKind::IDENTIFIER:
+        {
+            auto n = arena.make<IdentifierNode>();
+            n->name = node.payload;
+            items(n->args);
+            out = n;
+            break;
+        }
+        case NodeKind::BLOCK:
+        {
+            auto n = arena.make<BlockNode>();
+            items(n->statements);
+            out = n;
+            break;
+        }
+        case NodeKind::LOOP_CONDITION:
+        {
+            auto n = arena.make<LoopConditionNode>();
+            fields(2);
+            n->condition = c[0];
+            n->body = c[1];
+            out = n;
+            break;
+        }
+        case NodeKind::LOOP:
+            fields(2);
+            out = arena.make<LoopNode>(node.payload, type, c[0], c[1]);
+            break;
+        case NodeKind::INTERPOLATION:
+        {
+            auto n = arena.make<InterpolationNode>();
+            n->var_name = node.payload;
+            n->val = string(node.extra);
+            out = n;
+            break;
+        }
+        case NodeKind::I32: out = arena.make<i32Node>(static_cast<int32_t>(numbers[node.payload].integer)); break;
+        case NodeKind::I64: out = arena.make<i64Node>(numbers[node.payload].integer); break;
+        case NodeKind::BYTE: out = arena.make<ByteNode>(static_cast<unsigned char>(numbers[node.payload].integer)); break;
+        case NodeKind::TRUE_OR_FALSE: out = arena.make<TrueOrFalseNode>(numbers[node.payload].integer != 0); break;
+        case NodeKind::F64: out = arena.make<f64Node>(numbers[node.payload].real); break;
+        case NodeKind::F32: out = arena.make<f32Node>(static_cast<float>(numbers[node.payload].real)); break;
+        case NodeKind::IF_STATEMENT:
+            fields(4);
+            out = arena.make<IfStatement>(c[0], c[1], c[2], c[3]);
+            break;
+        case NodeKind::OBJECT:
+            fields(1);
+            out = arena.make<ObjectNode>(c[0]);
+            break;
+        case NodeKind::RETURN:
+            fields(1);
+            out = arena.make<ReturnNode>(c[0]);
+            break;
+        case NodeKind::FINISH:
+        {
+            auto n = arena.make<FinishNode>(static_cast<int>(numbers[node.payload].integer));
+            fields(1);
+            n->value = c[0];
+            out = n;
+            break;
+        }
+        case NodeKind::NIL:
+            out = arena.make<NilNode>();
+            break;
+        case NodeKind::EXPRESSION:
+        {
+            auto n = arena.make<ExpressionNode>();
+            n->var_name = node.payload;
+            n->type = type;
+            out = n;
+            break;
+        }
+        case NodeKind::UNARY_OP:
+            fields(1);
+            out = arena.make<UnaryOp>(type, c[0]);
+            break;
+        case NodeKind::BIN_OP:
+            fields(2);
+            out = arena.make<BinOp>(c[0], type, c[1]);
+            break;
+        case NodeKind::IF_EXPRESSION:
+        {
+            auto n = arena.make<IfExpressionNode>();
+            n->var_name = node.payload;
+            n->type = type;
+            n->logic_divisor = static_cast<TokensTypes>(node.type2);
+            fields(1);
+            n->val = c[0];
+            out = n;
+            break;
+        }
+        case NodeKind::FUNCTION_DEFINITION:
+        {
+            std::vector<ASTPtr> args;
+            items(args);
+            fields(1);
+            out = arena.make<FunctionDefinitionNode>(node.payload, type, std::move(args), c[0]);
+            break;
+        }
+        case NodeKind::VARIABLE_DEFINITION:
+            fields(1);
+            out = arena.make<VariableDefinitionNode>(node.payload, type, c[0]);
+            break;
+        }
+        out->token = node.token;
+        return out;
+    }
+
+    void FlatAst::clear()
+    {
+        nodes.clear();
+        roots.clear();
+        lists.clear();
+        numbers.clear();
+        strings.clear();
+        chars.clear();
+        plans.clear();
+        slots.clear();
+    }
+
+    std::size_t FlatAst::memoryUsage() const
+    {
+        return nodes.capacity() * sizeof(FlatNode) + roots.capacity() * sizeof(uint32_t) +
+               lists.capacity() * sizeof(uint32_t) + numbers.capacity() * sizeof(Number) +
+               strings.capacity() * sizeof(Span) + chars.capacity() + plans.capacity() * sizeof(Plan) +
+               slots.capacity() * sizeof(FormatPlan::Slot);
+    }
+}
@@ -16,9 +16,11 @@
 #ifndef AST_HPP
 #define AST_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
+#include <utility>
 #include <iostream>
 #include <iostream>
 
@@ -29,139 +31,211 @@
 
 #include "../../src/lexer/lex_types.hpp"
 #include "../../src/tokens/t_tokens.hpp"
+#include "format_plan.hpp"
+#include "interner.hpp"
 #include "rexcept.hpp"
+#include "val_types.hpp"
 // #include "ast_visit.hpp"
 
 namespace Rythin
 {
     class ASTVisitor;
 
+    // the concrete type of a node, one per struct below. VisitNode switches on it
+    enum class NodeKind : uint8_t
+    {
+        PRINT,
+        PRINT_E,
+        PRINT_NL,
+        CINPUT,
+        PRINT_ERROR_LOG,
+        USING,
+        VARIABLE,
+        IDENTIFIER,
+        LITERAL,
+        BLOCK,
+        LOOP_CONDITION,
+        LOOP,
+        INTERPOLATION,
+        I32,
+        I64,
+        BYTE,
+        F64,
+        F32,
+        TRUE_OR_FALSE,
+        IF_STATEMENT,
+        OBJECT,
+        RETURN,
+        FINISH,
+        NIL,
+        EXPRESSION,
+        UNARY_OP,
+        BIN_OP,
+        IF_EXPRESSION,
+        FUNCTION_DEFINITION,
+        VARIABLE_DEFINITION,
+    };
+
     class ASTNode
     {
     public:
+        const NodeKind kind;
+        ValueType value_type = ValueType::NONE; // static type of an expression, set by the TypeChecker
+        uint32_t token = 0; // index of the token the parser was on when it made the node
+
+        explicit ASTNode(NodeKind kind) : kind(kind) {}
         virtual ~ASTNode() = default;
     };
 
-    using ASTPtr = std::shared_ptr<ASTNode>;
+    // base of the node structs, sets the kind tag
+    template <NodeKind K>
+    struct Node : public ASTNode
+    {
+        static constexpr NodeKind node_kind = K;
+        Node() : ASTNode(K) {}
+    };
+
+    // nodes are owned by the AstArena of the compilation unit (see ast_arena.hpp)
+    using ASTPtr = ASTNode *;
 
-    struct PrintNode : public ASTNode
+    // the node as a T, or nullptr if it's of another kind (a compare of the tag, no RTTI)
+    template <typename T>
+    T *nodeAs(ASTNode *node)
+    {
+        return (node && node->kind == T::node_kind) ? static_cast<T *>(node) : nullptr;
+    }
+
+    struct PrintNode : public Node<NodeKind::PRINT>
     {
         std::string val;
+        FormatPlan format; // val with the "$[name]" holes as slots
     };
 
-    struct PrintE : public ASTNode
+    struct PrintE : public Node<NodeKind::PRINT_E>
     {
         std::string val;
+        FormatPlan format; // val with the "$[name]" holes as slots
     };
 
-    struct PrintNl : public ASTNode
+    struct PrintNl : public Node<NodeKind::PRINT_NL>
     {
         std::string val;
+        FormatPlan format; // val with the "$[name]" holes as slots
     };
 
-    struct CinputNode : public ASTNode
+    struct CinputNode : public Node<NodeKind::CINPUT>
     {
         std::string val; // the value is set by compiler/interpreter
         std::string msg;
-        int time;
+        int time = 0;
         CinputNode() {}
-        CinputNode(std::string msg) : msg(msg) {}
-        CinputNode(std::string msg, int time) : msg(msg), time(time) {}
+        CinputNode(std::string msg) : msg(std::move(msg)) {}
+        CinputNode(std::string msg, int time) : msg(std::move(msg)), time(time) {}
     };
 
-    struct PrintErrorLog : public ASTNode
+    struct PrintErrorLog : public Node<NodeKind::PRINT_ERROR_LOG>
     {
         std::string val;
     };
 
-    struct UsingNode : public ASTNode
+    struct UsingNode : public Node<NodeKind::USING>
     {
         std::string using_name, using_src;
         std::string from_name, from_src, get_var_name;
     };
 
     // the variable call node
-    struct VariableNode : public ASTNode
+    struct VariableNode : public Node<NodeKind::VARIABLE>
     {
-        std::string name;
+        static constexpr uint32_t unresolved = UINT32_MAX;
+
+        Symbol name = Interner::empty;
+        // the binding the semantic pass resolved it to: its slot among the globals (global)
+        // or among the arguments and locals of its function, in declaration order (the
+        // blocks next to each other reuse the same slots)
+        uint32_t slot = unresolved;
+        bool global = false;
+        TokensTypes type = TokensTypes::TOKEN_EOF; // declared type of the binding
     };
 
-    struct IdentifierNode : public ASTNode
+    struct IdentifierNode : public Node<NodeKind::IDENTIFIER>
     {
-        std::string name;
+        Symbol name = Interner::empty;
         std::vector<ASTPtr> args;
     };
 
-    struct LiteralNode : public ASTNode
+    struct LiteralNode : public Node<NodeKind::LITERAL>
     {
         std::string val;
-        LiteralNode(std::string val) : val(val) {}
+        FormatPlan format; // val with the "$[name]" holes as slots
+        LiteralNode(std::string val) : val(std::move(val)) {}
+        LiteralNode(std::string val, FormatPlan format) : val(std::move(val)), format(std::move(format)) {}
     };
 
-    struct BlockNode : public ASTNode
+    struct BlockNode : public Node<NodeKind::BLOCK>
     {
         std::vector<ASTPtr> statements;
     };
 
-    struct LoopConditionNode : public ASTNode
+    struct LoopConditionNode : public Node<NodeKind::LOOP_CONDITION>
     {
-        ASTPtr condition;
-        ASTPtr body;
+        ASTPtr condition = nullptr;
+        ASTPtr body = nullptr;
     };
 
-    struct LoopNode : public ASTNode
+    struct LoopNode : public Node<NodeKind::LOOP>
     {
-        std::string var_name;
+        Symbol var_name;
         TokensTypes type;
         ASTPtr value;
         ASTPtr block;
-        LoopNode(std::string var_name, TokensTypes type, ASTPtr value, ASTPtr block) : var_name(var_name), type(type), value(value), block(block) {} // Added value to constructor
+        LoopNode(Symbol var_name, TokensTypes type, ASTPtr value, ASTPtr block) : var_name(var_name), type(type), value(value), block(block) {} // Added value to constructor
     };
 
-    struct InterpolationNode : public ASTNode
+    struct InterpolationNode : public Node<NodeKind::INTERPOLATION>
     {
         std::string val;      // <- set the value of var/function name
-        std::string var_name; // gets the var/function and return the value to the val
+        Symbol var_name = Interner::empty; // gets the var/function and return the value to the val
     };
 
-    struct i32Node : public ASTNode
+    struct i32Node : public Node<NodeKind::I32>
     {
         int32_t val;
         i32Node(int32_t val) : val(val) {}
     };
 
-    struct i64Node : public ASTNode
+    struct i64Node : public Node<NodeKind::I64>
     {
         int64_t val;
         i64Node(int64_t val) : val(val) {}
     };
 
-    struct ByteNode : public ASTNode
+    struct ByteNode : public Node<NodeKind::BYTE>
     {
         unsigned char byte;
         ByteNode(unsigned char by) : byte(by) {}
     };
 
-    struct f64Node : public ASTNode
+    struct f64Node : public Node<NodeKind::F64>
     {
         // double is a float thats supports 8 bytes (or 64 bits), one byte = 8 bits, 8x8 = 64
         double val;
         f64Node(double val) : val(val) {}
     };
 
-    struct f32Node : public ASTNode
+    struct f32Node : public Node<NodeKind::F32>
     {
         float val;
         f32Node(float val) : val(val) {}
     };
 
-    struct TrueOrFalseNode : public ASTNode
+    struct TrueOrFalseNode : public Node<NodeKind::TRUE_OR_FALSE>
     {
         bool val;
         TrueOrFalseNode(bool val) : val(val) {}
     };
 
-    struct IfStatement : public ASTNode
+    struct IfStatement : public Node<NodeKind::IF_STATEMENT>
     {
         ASTPtr ifCondition;
         ASTPtr ifBranch;
@@ -170,115 +244,88 @@ namespace Rythin
         IfStatement(ASTPtr ifCondition, ASTPtr ifBranch, ASTPtr butBranch, ASTPtr butCondition) : ifCondition(ifCondition), ifBranch(ifBranch), butBranch(butBranch), butCondition(butCondition) {}
     };
 
-    struct ObjectNode : public ASTNode
+    struct ObjectNode : public Node<NodeKind::OBJECT>
     {
         ASTPtr val;
         ObjectNode(ASTPtr val) : val(val) {}
     };
 
-    struct ReturnNode : public ASTNode
+    struct ReturnNode : public Node<NodeKind::RETURN>
     {
         ASTPtr val; // return value (pode ser um int, float/double, string, byte e etc)
         ReturnNode(ASTPtr val) : val(val) {}
     };
 
-    struct FinishNode : public ASTNode
+    struct FinishNode : public Node<NodeKind::FINISH>
     {
         // finish code is a intiger but if is a variable name defined or a variable function call (like var() ), is a ASTPtr
-        int val;
-        ASTPtr value;
+        int val = 0;
+        ASTPtr value = nullptr;
 
         FinishNode(int val) : val(val) {}
         FinishNode(ASTPtr &value) : value(value) {}
     };
 
-    struct NilNode : public ASTNode
+    struct NilNode : public Node<NodeKind::NIL>
     {
         NilNode() = default;
     };
 
-    struct ExpressionNode : public ASTNode
+    struct ExpressionNode : public Node<NodeKind::EXPRESSION>
     {
-        std::string var_name;
-        TokensTypes type;
+        Symbol var_name = Interner::empty;
+        TokensTypes type{};
     };
 
     // Added: New AST node for unary operations (e.g., +val, -val)
-    struct UnaryOp : public ASTNode
+    struct UnaryOp : public Node<NodeKind::UNARY_OP>
     {
         TokensTypes op; // The unary operator (e.g., TOKEN_PLUS, TOKEN_MINUS)
         ASTPtr operand; // The expression it operates on
         UnaryOp(TokensTypes op, ASTPtr operand) : op(op), operand(operand) {}
     };
 
-    struct BinOp : public ASTNode
+    struct BinOp : public Node<NodeKind::BIN_OP>
     {
         TokensTypes op;     // operators
         ASTPtr left, right; // left value and right value
-        BinOp(ASTPtr left, TokensTypes &op, ASTPtr right) : left(left), op(op), right(right)
-        {
-            int l, r = 0;
-
-            if (auto vall = std::dynamic_pointer_cast<i32Node>(left))
-            {
-                //l = vall->val;
-                //std::cout << "Left value: " << vall->val << std::endl;
-                //std::cout << "Operator: " << Tokens::tokenTypeToString(op) << std::endl;
-                if (auto valr = std::dynamic_pointer_cast<i32Node>(right))
-                {
-                    //r = valr->val;
-                    //std::cout << "Right value: " << valr->val << std::endl;
-
-                    switch (op)
-                    {
-                    case TokensTypes::TOKEN_PLUS:
-                    {
-                        std::cout << "Out Value: " << (int)(vall->val + vall->val) << std::endl;
-                        break;
-                    }
-                        
-                    case TokensTypes::TOKEN_MINUS:
-                    {
-                        std::cout << "Out value: " << (int)(vall->val - vall->val) << "\n";
-                        break;
-                    }
-                    }
-                }
-            }
-        }
+        BinOp(ASTPtr left, TokensTypes op, ASTPtr right) : op(op), left(left), right(right) {}
     };
 
-    struct IfExpressionNode : public ASTNode
+    struct IfExpressionNode : public Node<NodeKind::IF_EXPRESSION>
     {
-        std::string var_name;      // name of the variable (can be empty if direct literal comparison)
-        TokensTypes type;          // type of expression (== or other binary operators types, or TRUE/FALSE token type for direct bools)
-        TokensTypes logic_divisor; // the divisor of the expressions like (&&, || and !)
-        ASTPtr val;                // the value of the condition (like x > 2, the value of this expression is 2)
+        Symbol var_name = Interner::empty; // name of the variable (empty if direct literal comparison)
+        TokensTypes type{};          // type of expression (== or other binary operators types, or TRUE/FALSE token type for direct bools)
+        TokensTypes logic_divisor{}; // the divisor of the expressions like (&&, || and !)
+        ASTPtr val = nullptr;        // the value of the condition (like x > 2, the value of this expression is 2)
     };
 
-    struct FunctionDefinitionNode : public ASTNode
+    struct FunctionDefinitionNode : public Node<NodeKind::FUNCTION_DEFINITION>
     {
-        std::string var_name;
+        Symbol var_name;
         std::vector<ASTPtr> args;
         TokensTypes type;
         ASTPtr block;
-        FunctionDefinitionNode(std::string name, TokensTypes tk, std::vector<ASTPtr> args, ASTPtr block) : var_name(name), type(tk), args(args), block(block)
+        // tokens [body_begin, body_end) of a body a lazy parser skipped, block is null until it's parsed
+        uint32_t body_begin = 0, body_end = 0;
+        FunctionDefinitionNode(Symbol name, TokensTypes tk, std::vector<ASTPtr> args, ASTPtr block) : var_name(name), type(tk), args(std::move(args)), block(block)
         {
             // Debugging code removed for cleaner ASTNode.
             // This kind of debug output is usually handled by a separate ASTVisitor or interpreter.
-            // while (auto test = std::dynamic_pointer_cast<PrintNl>(block))
+            // while (auto test = nodeAs<PrintNl>(block))
             // {
             //     std::cout << "Value of printnl(): " << test->val << "\n";
             // }
         }
+        bool deferred() const { return !block && body_end != 0; }
     };
 
-    struct VariableDefinitionNode : public ASTNode
+    struct VariableDefinitionNode : public Node<NodeKind::VARIABLE_DEFINITION>
     {
-        std::string var_name;
+        Symbol var_name;
         TokensTypes type;
         ASTPtr val;
-        VariableDefinitionNode(const std::string var, TokensTypes type, ASTPtr val) : var_name(var), type(type), val(val) {}
+        VariableDefinitionNode(Symbol var, TokensTypes type, ASTPtr val) : var_name(var), type(type), val(val) {}
     };
 }
 
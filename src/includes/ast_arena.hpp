@@ -0,0 +1,80 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef AST_ARENA_HPP
+#define AST_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief owner of the AST nodes of one compilation unit
+     *
+     * Nodes are bump allocated on big blocks and live as long as the arena:
+     * when it goes away every node is destroyed and the blocks are freed in one go.
+     * An ASTPtr is a plain pointer into the arena, so passing and copying it costs
+     * nothing (no refcount). It must outlive every stage that reads the nodes.
+     * Not thread safe, one arena per parser.
+     **/
+    class AstArena
+    {
+    public:
+        AstArena() = default;
+        AstArena(const AstArena &) = delete;
+        AstArena &operator=(const AstArena &) = delete;
+        ~AstArena();
+
+        template <typename T, typename... Args>
+        T *make(Args &&...args)
+        {
+            static_assert(std::is_base_of_v<ASTNode, T>, "the arena only holds AST nodes");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "over aligned node");
+            T *node = new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+            nodes.push_back(node);
+            return node;
+        }
+
+        // nodes made so far
+        std::size_t size() const { return nodes.size(); }
+        // every node of the unit, in the order they were made
+        const std::vector<ASTNode *> &all() const { return nodes; }
+        // bytes held by the blocks and the node list
+        std::size_t memoryUsage() const;
+        // destroys every node but keeps the first block, so the next nodes reuse its memory
+        void clear();
+        // takes the blocks and the nodes of other (left empty), they live as long as this arena now
+        void adopt(AstArena &other);
+
+    private:
+        static constexpr std::size_t block_size = 256 * 1024;
+
+        void *allocate(std::size_t size);
+
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::size_t used = block_size; // bytes taken on the last block
+        std::size_t block_bytes = 0;
+        std::vector<ASTNode *> nodes;  // their destructors (strings, vectors) run with the arena's
+    };
+}
+
+#endif // AST_ARENA_HPP
@@ -0,0 +1,72 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef AST_CACHE_HPP
+#define AST_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include "flat_ast.hpp"
+#include "log.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief on-disk cache of the checked AST of the source files
+     *
+     * An entry is the FlatAst of a unit that was parsed, folded and checked with
+     * no errors, plus the names of its symbols and the warnings of that run. It's
+     * keyed by a hash of the source bytes and of the compiler version, so an edit
+     * of the file or a new compiler is a miss. The records are indexes only, the
+     * file is mapped and its arrays copied as they are: a hit skips the lexer, the
+     * parser and the passes. Entries are evicted by last use, oldest first, when
+     * the directory goes over max_bytes.
+     **/
+    class AstCache
+    {
+    public:
+        // bump it whenever the records or the output of the parser/passes change
+        static constexpr uint32_t format_version = 5;
+        static constexpr std::uintmax_t max_bytes = 256ull * 1024 * 1024;
+
+        // an empty dir disables the cache (load misses, store does nothing)
+        explicit AstCache(std::filesystem::path dir) : dir(std::move(dir)) {}
+
+        // $RHYTHIN_CACHE_DIR, else $XDG_CACHE_HOME/rhythin, else $HOME/.cache/rhythin (empty if none is set)
+        static std::filesystem::path defaultDir();
+        // 64-bit hash of the bytes, the key of an entry is the one of the source and the compiler
+        static uint64_t hash(std::string_view bytes, uint64_t seed = 0);
+
+        bool enabled() const { return !dir.empty(); }
+
+        // the entry of the source, out must be empty. The names are interned again in the stored
+        // order and have to get the stored ids (the case on a fresh interner), else it's a miss
+        bool load(std::string_view source, FlatAst &out, std::vector<Log::LogErrors::Held> &warnings);
+        // writes the entry (the warnings with their line/column resolved), then evicts the old ones
+        bool store(std::string_view source, const FlatAst &ast, const std::vector<Log::LogErrors::Held> &warnings);
+
+    private:
+        std::filesystem::path entryOf(std::string_view source) const;
+        void evict() const;
+
+        std::filesystem::path dir;
+    };
+}
+
+#endif // AST_CACHE_HPP
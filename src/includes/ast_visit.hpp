@@ -25,36 +25,83 @@ namespace Rythin
     class ASTVisitor
     {
     public:
-        inline virtual void Visit(PrintNode& node) {};
+        virtual ~ASTVisitor() = default;
+
+        // one per node kind, they do nothing unless overridden (the blocks visit their statements)
+        inline virtual void Visit(PrintNode& node) {}
+        inline virtual void Visit(PrintE& node) {}
         inline virtual void Visit(PrintNl& node) {}
+        inline virtual void Visit(CinputNode& node) {}
+        inline virtual void Visit(PrintErrorLog& node) {}
+        inline virtual void Visit(UsingNode& node) {}
         inline virtual void Visit(VariableNode& node) {}
-        inline virtual void Visit(FunctionDefinitionNode& node) {}
-        inline virtual void Visit(VariableDefinitionNode& node) {}
-        inline virtual void Visit(BinOp& node) {}
-        inline virtual void Visit(IfStatement& node) {}
-        inline virtual void Visit(ReturnNode& node) {}
-        inline virtual void Visit(InterpolationNode& node) {}
+        inline virtual void Visit(IdentifierNode& node) {}
+        inline virtual void Visit(LiteralNode& node) {}
         inline virtual void Visit(BlockNode& node)
         {
             for (auto& stmt : node.statements)
                 VisitNode(stmt);
         }
+        inline virtual void Visit(LoopConditionNode& node) {}
+        inline virtual void Visit(LoopNode& node) {}
+        inline virtual void Visit(InterpolationNode& node) {}
+        inline virtual void Visit(i32Node& node) {}
+        inline virtual void Visit(i64Node& node) {}
+        inline virtual void Visit(ByteNode& node) {}
+        inline virtual void Visit(f64Node& node) {}
+        inline virtual void Visit(f32Node& node) {}
+        inline virtual void Visit(TrueOrFalseNode& node) {}
+        inline virtual void Visit(IfStatement& node) {}
+        inline virtual void Visit(ObjectNode& node) {}
+        inline virtual void Visit(ReturnNode& node) {}
+        inline virtual void Visit(FinishNode& node) {}
+        inline virtual void Visit(NilNode& node) {}
+        inline virtual void Visit(ExpressionNode& node) {}
+        inline virtual void Visit(UnaryOp& node) {}
+        inline virtual void Visit(BinOp& node) {}
+        inline virtual void Visit(IfExpressionNode& node) {}
+        inline virtual void Visit(FunctionDefinitionNode& node) {}
+        inline virtual void Visit(VariableDefinitionNode& node) {}
 
         // método genérico para despachar nós com base no tipo
+        // one switch on the kind tag, the compiler makes it a jump table
         void VisitNode(ASTPtr node)
         {
             if (!node) return;
 
-            if (auto n = std::dynamic_pointer_cast<PrintNode>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<PrintNl>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<VariableNode>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<FunctionDefinitionNode>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<VariableDefinitionNode>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<BinOp>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<IfStatement>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<ReturnNode>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<BlockNode>(node)) Visit(*n);
-            if (auto n = std::dynamic_pointer_cast<InterpolationNode>(node)) Visit(*n);
+            switch (node->kind)
+            {
+            case NodeKind::PRINT: Visit(static_cast<PrintNode&>(*node)); break;
+            case NodeKind::PRINT_E: Visit(static_cast<PrintE&>(*node)); break;
+            case NodeKind::PRINT_NL: Visit(static_cast<PrintNl&>(*node)); break;
+            case NodeKind::CINPUT: Visit(static_cast<CinputNode&>(*node)); break;
+            case NodeKind::PRINT_ERROR_LOG: Visit(static_cast<PrintErrorLog&>(*node)); break;
+            case NodeKind::USING: Visit(static_cast<UsingNode&>(*node)); break;
+            case NodeKind::VARIABLE: Visit(static_cast<VariableNode&>(*node)); break;
+            case NodeKind::IDENTIFIER: Visit(static_cast<IdentifierNode&>(*node)); break;
+            case NodeKind::LITERAL: Visit(static_cast<LiteralNode&>(*node)); break;
+            case NodeKind::BLOCK: Visit(static_cast<BlockNode&>(*node)); break;
+            case NodeKind::LOOP_CONDITION: Visit(static_cast<LoopConditionNode&>(*node)); break;
+            case NodeKind::LOOP: Visit(static_cast<LoopNode&>(*node)); break;
+            case NodeKind::INTERPOLATION: Visit(static_cast<InterpolationNode&>(*node)); break;
+            case NodeKind::I32: Visit(static_cast<i32Node&>(*node)); break;
+            case NodeKind::I64: Visit(static_cast<i64Node&>(*node)); break;
+            case NodeKind::BYTE: Visit(static_cast<ByteNode&>(*node)); break;
+            case NodeKind::F64: Visit(static_cast<f64Node&>(*node)); break;
+            case NodeKind::F32: Visit(static_cast<f32Node&>(*node)); break;
+            case NodeKind::TRUE_OR_FALSE: Visit(static_cast<TrueOrFalseNode&>(*node)); break;
+            case NodeKind::IF_STATEMENT: Visit(static_cast<IfStatement&>(*node)); break;
+            case NodeKind::OBJECT: Visit(static_cast<ObjectNode&>(*node)); break;
+            case NodeKind::RETURN: Visit(static_cast<ReturnNode&>(*node)); break;
+            case NodeKind::FINISH: Visit(static_cast<FinishNode&>(*node)); break;
+            case NodeKind::NIL: Visit(static_cast<NilNode&>(*node)); break;
+            case NodeKind::EXPRESSION: Visit(static_cast<ExpressionNode&>(*node)); break;
+            case NodeKind::UNARY_OP: Visit(static_cast<UnaryOp&>(*node)); break;
+            case NodeKind::BIN_OP: Visit(static_cast<BinOp&>(*node)); break;
+            case NodeKind::IF_EXPRESSION: Visit(static_cast<IfExpressionNode&>(*node)); break;
+            case NodeKind::FUNCTION_DEFINITION: Visit(static_cast<FunctionDefinitionNode&>(*node)); break;
+            case NodeKind::VARIABLE_DEFINITION: Visit(static_cast<VariableDefinitionNode&>(*node)); break;
+            }
         }
     };
 }
@@ -0,0 +1,108 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CONST_FOLDER_HPP
+#define CONST_FOLDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ast.hpp"
+#include "ast_arena.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief folds the constant expressions of the AST, between the parser and the semantic pass
+     *
+     * Operations on i32/i64/f32/f64 and bool literals are done here and the subtree
+     * is replaced by the literal of the result, with the usual promotion (any float
+     * makes it float, f64 over f32, i64 over i32). The variables whose value is a
+     * constant are replaced by it in the expressions and conditions after them, so
+     * `def c:int32 := a + b / 2` is a literal when a and b are. What would overflow,
+     * divide by zero or shift out of range is left as it is, with a warning.
+     * The tree is walked on an explicit stack, so its depth is not bounded by the C++ one.
+     **/
+    class ConstantFolder
+    {
+    public:
+        explicit ConstantFolder(AstArena &arena) : arena(arena) {}
+
+        // the node with its constant subtrees folded (the node itself or a new literal)
+        ASTPtr fold(ASTPtr node);
+        // folds the body of a lazy function once it's parsed, after the whole unit was folded:
+        // only the constants declared before the function are seen, like an eager fold would
+        void foldBody(FunctionDefinitionNode &func);
+        // operations and variables replaced so far
+        std::size_t folded() const { return count; }
+
+    private:
+        // value of a literal node: I32/I64/TRUE_OR_FALSE use integer, F32/F64 use real
+        struct Constant
+        {
+            NodeKind kind;
+            int64_t integer = 0;
+            double real = 0;
+        };
+
+        static bool constantOf(ASTPtr node, Constant &out);
+        // a op b, false if there's no folding for it
+        bool evaluate(TokensTypes op, const Constant &a, const Constant &b, Constant &out);
+        bool evaluate(TokensTypes op, const Constant &a, Constant &out);
+        ASTPtr literal(const Constant &value, uint32_t token);
+        void foldCondition(IfExpressionNode &node);
+
+        // known constants by symbol (nullptr: not a constant), scoped by blocks and functions
+        void bind(Symbol name, ASTPtr value);
+        std::size_t scope() const { return undo.size(); }
+        void closeScope(std::size_t mark);
+        // value of the name, skipping the binds on [hidden_from, hidden_to)
+        ASTPtr constantNamed(Symbol name) const;
+
+        // a node being folded: its result goes to *slot once its children are done
+        struct Frame
+        {
+            ASTPtr node;
+            ASTPtr *slot;
+            std::size_t step; // children handed out so far
+            std::size_t mark; // scope() when its block or function was entered
+        };
+        // does the work of f up to its next child and gives the slot of that child,
+        // nullptr when f is done (f.node is then its result)
+        ASTPtr *next(Frame &f);
+
+        struct Undo
+        {
+            Symbol name;
+            ASTPtr value; // of the name before this bind
+            std::size_t at; // undo index of that previous bind (none: unbound)
+        };
+        static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+        AstArena &arena;
+        std::vector<ASTPtr> constants;
+        std::vector<std::size_t> bound_at; // undo index of the current bind of each symbol
+        std::vector<Undo> undo;
+        // scope() at the declaration of each lazy function, its body is folded later
+        std::unordered_map<const FunctionDefinitionNode *, std::size_t> declared;
+        std::size_t hidden_from = 0, hidden_to = 0; // the top level binds after the function being folded
+        std::vector<Frame> work; // the nodes between the root and the one being folded
+        std::size_t count = 0;
+    };
+}
+
+#endif // CONST_FOLDER_HPP
@@ -0,0 +1,154 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FLAT_AST_HPP
+#define FLAT_AST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ast.hpp"
+#include "ast_arena.hpp"
+#include "format_plan.hpp"
+#include "../../src/lexer/keywords.hpp"
+#include "../../src/tokens/token_stream.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief one node of the FlatAst: a fixed record, the links are indexes on the same vector
+     *
+     * What payload and extra hold depends on the kind:
+     *   PRINT, PRINT_E, PRINT_NL, LITERAL  payload = string (val), extra = format plan
+     *   PRINT_ERROR_LOG                    payload = string (val)
+     *   CINPUT                             payload = string (msg), extra = number (time)
+     *   USING                              payload = first of 5 strings (using name/src, from name/src, get var)
+     *   VARIABLE                           payload = name symbol, extra = slot, type2 = global
+     *   EXPRESSION, LOOP,
+     *   IF_EXPRESSION, VARIABLE_DEFINITION payload = name symbol
+     *   IDENTIFIER, FUNCTION_DEFINITION    payload = name symbol, extra = list (args)
+     *   BLOCK                              extra = list (statements)
+     *   INTERPOLATION                      payload = name symbol, extra = string (val)
+     *   I32, I64, F32, F64, BYTE,
+     *   TRUE_OR_FALSE, FINISH              payload = number
+     * The node pointers of the structs (condition, block, left...) are the children,
+     * linked by first_child/next_sibling in member order. A null one is not linked and
+     * its bit on present is clear, so the order can still be told apart.
+     **/
+    struct FlatNode
+    {
+        static constexpr uint32_t none = UINT32_MAX;
+
+        NodeKind kind;
+        uint8_t present = 0; // bit i: the i-th node pointer of the struct is set
+        uint8_t type = 0;    // TokensTypes of the node (type, op)
+        uint8_t type2 = 0;   // second TokensTypes (IfExpressionNode::logic_divisor)
+        uint32_t token = 0;  // ASTNode::token
+        uint32_t first_child = none;
+        uint32_t next_sibling = none;
+        uint32_t payload = none;
+        uint32_t extra = none;
+    };
+
+    static_assert(sizeof(FlatNode) == 24, "keep the records small, they are scanned linearly");
+    static_assert(Keywords::type_count <= 256, "the token types no longer fit the record bytes");
+
+    /**
+     * @brief the AST of a unit as plain arrays, with no pointers
+     *
+     * Nodes are in pre-order: a node comes before its children and the items
+     * are in source order, so a pass over every node is a linear scan of nodes.
+     * The strings, numbers, format plans and node lists are side arrays, and all
+     * of them are trivially copyable, so the whole tree can be written to disk or
+     * handed to another thread as it is.
+     **/
+    class FlatAst
+    {
+    public:
+        struct Span
+        {
+            uint32_t offset, length; // on chars
+        };
+
+        struct Plan
+        {
+            uint32_t text;  // string with the fixed segments
+            uint32_t slot;  // first slot on slots
+            uint32_t count;
+        };
+
+        std::vector<FlatNode> nodes;
+        std::vector<uint32_t> roots;   // the top level items
+        std::vector<uint32_t> lists;   // a list is its size and then the node indexes
+        std::vector<Number> numbers;
+        std::vector<Span> strings;
+        std::string chars;             // the bytes of every string, back to back
+        std::vector<Plan> plans;
+        std::vector<FormatPlan::Slot> slots;
+
+        // copies the tree of the node (every node reachable from it) and adds it to roots
+        uint32_t append(const ASTNode *root);
+        // makes the tree of the node back on the arena (the opposite of append)
+        ASTPtr expand(uint32_t index, AstArena &arena) const;
+
+        std::size_t size() const { return nodes.size(); }
+        const FlatNode &operator[](uint32_t index) const { return nodes[index]; }
+        std::string_view string(uint32_t index) const
+        {
+            const Span &s = strings[index];
+            return std::string_view(chars).substr(s.offset, s.length);
+        }
+        std::span<const uint32_t> list(uint32_t index) const
+        {
+            if (index == FlatNode::none)
+                return {};
+            return std::span<const uint32_t>(lists.data() + index + 1, lists[index]);
+        }
+        FormatPlan plan(uint32_t index) const;
+
+        void clear();
+        // bytes held by the arrays
+        std::size_t memoryUsage() const;
+
+    private:
+        // a node waiting to be put, with where its index goes: a list slot, or a child of parent
+        struct Put
+        {
+            const ASTNode *node;
+            uint32_t parent;
+            uint32_t slot; // on lists
+            uint8_t bit;   // its bit on the present of parent
+        };
+
+        // the record of the node, its children are added to children in member order
+        uint32_t put(const ASTNode *node, std::vector<Put> &children);
+        void link(const Put &child, uint32_t index);
+        uint32_t addString(std::string_view s);
+        uint32_t addNumber(Number n);
+        uint32_t addPlan(const FormatPlan &plan, uint32_t val);
+        uint32_t addList(const std::vector<ASTPtr> &items, std::vector<Put> &children);
+        // the node pointers of a struct (in member order) as the children of parent
+        void addChildren(uint32_t parent, std::initializer_list<const ASTNode *> fields, std::vector<Put> &children);
+        // the node of the record, from its children made already (list items first)
+        ASTPtr make(const FlatNode &node, const ASTPtr *made, AstArena &arena) const;
+    };
+}
+
+#endif // FLAT_AST_HPP
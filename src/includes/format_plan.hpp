@@ -0,0 +1,84 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FORMAT_PLAN_HPP
+#define FORMAT_PLAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "interner.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief a string with "$[name]" holes, compiled once by the parser
+     *
+     * The fixed segments are kept back to back on text and every slot (the
+     * variable of a hole) says where the text before it ends. Rendering is one
+     * reserve for the whole output and one append per piece: the literal is not
+     * scanned for the holes again and no temporary string is built.
+     **/
+    struct FormatPlan
+    {
+        struct Slot
+        {
+            uint32_t end; // the text before the slot is text[previous end, end)
+            Symbol name;
+            uint32_t hole; // 1: a "$[name]" of a literal, 0: a name on its own (print(y), "a" + y)
+        };
+
+        // bytes reserved for the value of each slot
+        static constexpr std::size_t slot_guess = 16;
+
+        std::string text;        // the fixed segments, back to back
+        std::vector<Slot> slots;
+        std::size_t reserved = 0; // output size reserved by render
+
+        bool hasSlots() const { return !slots.empty(); }
+
+        void appendText(std::string_view s)
+        {
+            text.append(s);
+            reserved += s.size();
+        }
+
+        void appendSlot(Symbol name, bool hole)
+        {
+            slots.push_back(Slot{static_cast<uint32_t>(text.size()), name, hole ? 1u : 0u});
+            reserved += slot_guess;
+        }
+
+        // appends the formatted string to out, value(Symbol) gives the string_view of a slot
+        template <typename Fn>
+        void render(std::string &out, Fn &&value) const
+        {
+            out.reserve(out.size() + reserved);
+            std::size_t at = 0;
+            for (const Slot &slot : slots)
+            {
+                out.append(text, at, slot.end - at);
+                out.append(value(slot.name));
+                at = slot.end;
+            }
+            out.append(text, at, std::string::npos);
+        }
+    };
+}
+
+#endif // FORMAT_PLAN_HPP
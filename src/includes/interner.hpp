@@ -0,0 +1,78 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef INTERNER_HPP
+#define INTERNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Rythin
+{
+    // dense id of an interned name, the same spelling always gets the same id
+    using Symbol = uint32_t;
+
+    /**
+     * @brief table of the distinct names (identifiers) of the compilation
+     *
+     * Each spelling is stored once and gets a dense 32-bit id, so the token
+     * stream, the AST and the symbol tables carry and compare ids instead of
+     * strings, and tables can be plain arrays indexed by the id.
+     * Id 0 is the empty name. Spellings are kept in fixed blocks, so the views
+     * returned by spelling() stay valid while the interner is alive.
+     * Not thread safe: intern() is only called from the thread that fills the
+     * token stream, spelling() can be read from any thread after that.
+     **/
+    class Interner
+    {
+    private:
+        Interner();
+        Interner(const Interner &) = delete;
+        Interner &operator=(const Interner &) = delete;
+
+        void grow();
+        const char *store(std::string_view s);
+
+        std::vector<std::string_view> spellings; // by id
+        std::vector<uint32_t> hashes;            // by id
+        std::vector<Symbol> slots;               // open addressing, id + 1 (0 is a free slot)
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::size_t block_used;
+        std::size_t block_size;
+        std::size_t block_bytes;
+
+    public:
+        static constexpr Symbol empty = 0;
+
+        static Interner &getInstance()
+        {
+            static Interner instance;
+            return instance;
+        }
+
+        Symbol intern(std::string_view s);
+        std::string_view spelling(Symbol id) const { return spellings[id]; }
+        std::string str(Symbol id) const { return std::string(spellings[id]); }
+        std::size_t size() const { return spellings.size(); }
+        // bytes held by the tables and the spellings
+        std::size_t memoryUsage() const;
+    };
+}
+
+#endif // INTERNER_HPP
@@ -0,0 +1,69 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LINE_INDEX_HPP
+#define LINE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Rythin
+{
+    struct LineColumn
+    {
+        int line;   // starts at 1
+        int column; // bytes since the start of the line
+    };
+
+    /**
+     * @brief turns byte offsets of a source into line:column
+     *
+     * The lexer and the tokens only keep byte offsets. The table with the
+     * start of every line is built on the first locate() (one pass over the
+     * source), so a run without errors never pays for it.
+     * Not thread safe: the first locate() writes the table.
+     **/
+    class LineIndex
+    {
+    public:
+        explicit LineIndex(std::string_view source) : src(source) {}
+
+        // offsets past the end of the source are counted on the last line
+        LineColumn locate(std::size_t offset) const;
+
+    private:
+        void build() const;
+
+        std::string_view src;
+        mutable std::vector<uint32_t> starts; // offset of the first byte of each line
+        mutable bool built = false;
+    };
+
+    // where an error happened: resolved to line:column only by the logger
+    struct SourceLocation
+    {
+        const LineIndex *index;
+        std::size_t offset;
+
+        LineColumn resolve() const
+        {
+            return index ? index->locate(offset) : LineColumn{0, 0};
+        }
+    };
+}
+
+#endif // LINE_INDEX_HPP
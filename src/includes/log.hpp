@@ -22,6 +22,8 @@
 #include <cstring>
 #include <exception>
 
+#include "line_index.hpp"
+
 namespace Log
 {
     class LogErrors : std::exception
@@ -34,6 +36,30 @@ namespace Log
         std::vector<std::string> warns;
         int code;
     public:
+        // a diagnostic held back by a Hold, the location is resolved only when it's replayed
+        struct Held
+        {
+            std::string message;
+            int code;
+            bool warning;
+            Rythin::SourceLocation where; // index is null when line/column were given
+            int line, column;
+        };
+
+        // while alive, the diagnostics of the calling thread go to the vector instead of the log,
+        // so a worker thread can run code that reports without touching the shared log
+        class Hold
+        {
+        public:
+            explicit Hold(std::vector<Held> &into);
+            ~Hold();
+            Hold(const Hold &) = delete;
+            Hold &operator=(const Hold &) = delete;
+
+        private:
+            std::vector<Held> *previous;
+        };
+
         static LogErrors& getInstance() {
             static LogErrors instance;
             return instance;
@@ -43,6 +69,11 @@ namespace Log
         int getErrSize();
         void addError(const std::string &error, int exit_code, int line, int column);
         void addWarning(const std::string &err, int exit, int line, int column);
+        // the offset is turned into line:column here, only when there is something to report
+        void addError(const std::string &error, int exit_code, const Rythin::SourceLocation &where);
+        void addWarning(const std::string &err, int exit, const Rythin::SourceLocation &where);
+        // logs the held diagnostics, in their order
+        void replay(const std::vector<Held> &held);
         bool hasErrorsAndWarns();
         int exitCode();
         void printErrors();
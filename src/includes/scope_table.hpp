@@ -0,0 +1,145 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCOPE_TABLE_HPP
+#define SCOPE_TABLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "interner.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief the names in scope while a pass walks the AST, one frame per block
+     *
+     * The bindings of the open frames are one stack, and the innermost binding of
+     * each name is found through a table indexed by the symbol id (the ids are dense,
+     * see Interner, so the table is a hash with no collisions and no probing). Every
+     * binding links to the one it shadows. push() is O(1) and pop() undoes the
+     * bindings of the frame, so each binding costs O(1) to make and to drop, and
+     * the working set is the names of the blocks open at that point, not the unit.
+     * A frame can be opened on a parent other than the frame below it (a lazy body
+     * is checked at its first call, but in the scope of its declaration): lookups
+     * skip the frames in between.
+     **/
+    template <typename T>
+    class ScopeTable
+    {
+    public:
+        static constexpr uint32_t none = UINT32_MAX;
+
+        struct Binding
+        {
+            Symbol name;
+            uint32_t frame;    // index of the frame it's bound in
+            uint32_t shadowed; // the binding of the same name it hides, or none
+            T value;
+        };
+
+        ScopeTable() { push(none); } // the global frame, never popped
+
+        // opens a frame inside parent (the innermost frame by default)
+        void push() { push(top()); }
+        void push(uint32_t parent)
+        {
+            uint32_t index = static_cast<uint32_t>(frames.size());
+            uint32_t base = (parent != none && parent + 1 == index) ? frames[parent].base : index;
+            frames.push_back({static_cast<uint32_t>(bindings.size()), parent, base});
+        }
+        // closes the innermost frame, the names it shadowed are visible again
+        void pop()
+        {
+            if (frames.size() <= 1)
+                return;
+            uint32_t first = frames.back().first;
+            for (std::size_t i = bindings.size(); i-- > first;)
+                innermost[bindings[i].name] = bindings[i].shadowed;
+            bindings.resize(first);
+            frames.pop_back();
+        }
+        uint32_t top() const { return static_cast<uint32_t>(frames.size() - 1); }
+
+        // binds name in the innermost frame, hiding its outer bindings. nullptr if it's already
+        // bound in that frame. The pointers returned are valid until the next declare
+        T *declare(Symbol name, T value)
+        {
+            if (name >= innermost.size())
+                innermost.resize(std::max<std::size_t>(Interner::getInstance().size(), name + 1), none);
+            uint32_t shadowed = innermost[name];
+            if (shadowed != none && shadowed >= frames.back().first)
+                return nullptr; // the bindings of the innermost frame are the last ones
+            innermost[name] = static_cast<uint32_t>(bindings.size());
+            bindings.push_back({name, top(), shadowed, std::move(value)});
+            return &bindings.back().value;
+        }
+
+        // the innermost binding of name visible from the innermost frame
+        Binding *find(Symbol name)
+        {
+            uint32_t b = name < innermost.size() ? innermost[name] : none;
+            uint32_t f = top();
+            while (b != none)
+            {
+                uint32_t frame = bindings[b].frame;
+                // up the chain of parents, a run of frames opened one inside the other at a time
+                while (frame < frames[f].base)
+                {
+                    f = frames[frames[f].base].parent;
+                    if (f == none)
+                        return nullptr;
+                }
+                if (frame <= f && (b < hidden_from || b >= hidden_to))
+                    return &bindings[b];
+                b = bindings[b].shadowed; // bound in a skipped frame, or hidden
+            }
+            return nullptr;
+        }
+
+        // find() skips the bindings on [from, to): a lazy body checked at the end of the unit
+        // doesn't see the names declared after its function. returns the range it replaces
+        std::pair<uint32_t, uint32_t> hide(uint32_t from, uint32_t to)
+        {
+            std::pair<uint32_t, uint32_t> previous(hidden_from, hidden_to);
+            hidden_from = from;
+            hidden_to = to;
+            return previous;
+        }
+
+        std::size_t size() const { return bindings.size(); }
+        // place of a binding on the stack, and the place of the first binding of a frame
+        uint32_t slot(const Binding &b) const { return static_cast<uint32_t>(&b - bindings.data()); }
+        uint32_t first(uint32_t frame) const { return frames[frame].first; }
+
+    private:
+        struct Frame
+        {
+            uint32_t first;  // its first binding
+            uint32_t parent; // the frame it's inside of
+            uint32_t base;   // first frame of the run it's in (each one the parent of the next)
+        };
+
+        std::vector<Frame> frames;
+        std::vector<Binding> bindings;
+        std::vector<uint32_t> innermost; // by symbol id
+        uint32_t hidden_from = 0, hidden_to = 0;
+    };
+}
+
+#endif // SCOPE_TABLE_HPP
@@ -16,12 +16,17 @@
 #ifndef SEMANTIC_ANALYZER_HPP
 #define SEMANTIC_ANALYZER_HPP
 
-#include <unordered_map>
+#include <cstdint>
+#include <functional>
+#include <ostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 // Local Includes
 #include "ast.hpp"
 #include "ast_visit.hpp"
+#include "scope_table.hpp"
 #include "../../src/tokens/t_tokens.hpp"
 #include "log.hpp"
 
@@ -32,15 +37,69 @@ namespace Rythin
     class SemanticAnalyzer : public ASTVisitor
     {
     private:
-        std::unordered_map<std::string, TokensTypes> var_table;
-        std::unordered_map<std::string, ASTPtr> var_values;
-        std::unordered_map<std::string, TokensTypes> func_table;
+        // what a name is bound to, in the scope of its block
+        struct Binding
+        {
+            bool function = false;
+            TokensTypes type = TokensTypes::TOKEN_EOF;
+            FunctionDefinitionNode *definition = nullptr; // of functions
+        };
+
+        ScopeTable<Binding> scopes;
+        std::vector<uint32_t> function_frames; // the frames of the bodies being checked, the slots count from them
+        std::vector<ASTPtr> operands; // of the BinOp chains being visited
+
+        // --dump-symbols: the definitions in declaration order, only kept when asked
+        bool keep_symbols = false;
+        std::vector<ASTPtr> symbols;
+
+        // the arguments and the statements of a body, in a frame opened on parent (the frame of the declaration)
+        void checkFunction(FunctionDefinitionNode &node, uint32_t parent);
+
+    public:
+        // parses the body of a function the lazy parser skipped (see Parser::ParseBody)
+        using BodyLoader = std::function<ASTPtr(FunctionDefinitionNode &)>;
+
+    private:
+        BodyLoader load_body;
+        // the lazy functions, in declaration order, with the frame they were declared in and their slot
+        struct Deferred
+        {
+            FunctionDefinitionNode *func;
+            uint32_t frame;
+            uint32_t slot;
+        };
+        std::vector<Deferred> deferred;
+        // checks a lazy body in the scope of its declaration: the frame it was declared in, and only
+        // the names bound up to its own binding (the slot of the function)
+        void checkBody(FunctionDefinitionNode &node, uint32_t parent, uint32_t slot);
 
     public:
+        SemanticAnalyzer() = default;
+        // a lazy body is loaded and checked on the first call of its function
+        explicit SemanticAnalyzer(BodyLoader loader) : load_body(std::move(loader)) {}
+
+        // the lazy bodies not called by the end of the unit: all of them, or only the one of 'main'
+        void checkDeferred(bool all);
+
+        // keeps the variable and function definitions seen, for dumpSymbols
+        void keepSymbols(bool on) { keep_symbols = on; }
+        // one line per definition kept: name, type and the value when it's a literal
+        void dumpSymbols(std::ostream &out) const;
+
         void Visit(VariableDefinitionNode &node) override;
         void Visit(VariableNode &node) override;
         void Visit(BinOp &node) override;
         void Visit(FunctionDefinitionNode &node) override;
+        void Visit(ObjectNode &node) override;
+        void Visit(IdentifierNode &node) override;
+        // the blocks open a frame each, a loop one more for its variable
+        void Visit(BlockNode &node) override;
+        void Visit(IfStatement &node) override;
+        void Visit(LoopNode &node) override;
+        void Visit(LoopConditionNode &node) override;
+        // the names on the conditions
+        void Visit(IfExpressionNode &node) override;
         // TODO: Adicionar outros Visit conforme eu for expandindo
     };
 }
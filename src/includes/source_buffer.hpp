@@ -0,0 +1,77 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SOURCE_BUFFER_HPP
+#define SOURCE_BUFFER_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace Rythin
+{
+    /**
+     * @brief read-only view of a whole source file
+     *
+     * Regular files are memory-mapped, so the lexer scans the page cache directly
+     * and nothing is copied. Pipes, character devices and anything else that can't
+     * be mapped are read in chunks into an owned buffer instead.
+     * The buffer owns the bytes, so every string_view taken from view() is only
+     * valid while the SourceBuffer is alive.
+     **/
+    class SourceBuffer
+    {
+    public:
+        enum class Origin
+        {
+            NONE,     // nothing loaded (or load failed)
+            MAPPED,   // mmap/MapViewOfFile of a regular file
+            STREAMED, // chunked read into the owned buffer
+        };
+
+        SourceBuffer() = default;
+        ~SourceBuffer();
+
+        SourceBuffer(const SourceBuffer &) = delete;
+        SourceBuffer &operator=(const SourceBuffer &) = delete;
+        SourceBuffer(SourceBuffer &&other) noexcept;
+        SourceBuffer &operator=(SourceBuffer &&other) noexcept;
+
+        // maps the file when possible, falls back to the streamed read otherwise.
+        // returns false if the file can't be opened at all
+        bool load(const std::string &path);
+        // always uses the streamed read (used by the benchmarks and for pipes)
+        bool loadStreamed(const std::string &path);
+
+        std::string_view view() const { return std::string_view(data, length); }
+        std::size_t size() const { return length; }
+        Origin origin() const { return from; }
+
+    private:
+        void release();
+        bool map(const std::string &path);
+
+        const char *data = nullptr;
+        std::size_t length = 0;
+        Origin from = Origin::NONE;
+        std::string owned; // storage of the streamed read
+#if defined(_WIN32)
+        void *file_handle = nullptr;
+        void *map_handle = nullptr;
+#endif
+    };
+}
+
+#endif // SOURCE_BUFFER_HPP
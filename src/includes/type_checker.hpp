@@ -0,0 +1,154 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TYPE_CHECKER_HPP
+#define TYPE_CHECKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ast.hpp"
+#include "scope_table.hpp"
+#include "typed_ir.hpp"
+#include "val_types.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief the type pass: gives every expression its static type and lowers the unit to the typed IR
+     *
+     * Runs after the SemanticAnalyzer, on the same scopes (a name means the same
+     * binding on both passes). Each expression gets its ValueType on value_type:
+     * literals have their own type, a variable the type of its declaration, and
+     * arithmetic the widest of its operands (byte arithmetic is done on int32).
+     * A value can only go to a binding of its type or of a wider one (int32 to
+     * float64, anything to an obj), a literal to any type it fits in, and the
+     * conditions must be bools. The names the analyzer already reported have no
+     * type (NONE) and don't cause more errors here.
+     **/
+    class TypeChecker
+    {
+    public:
+        explicit TypeChecker(IrUnit &unit) : unit(unit) {}
+
+        // checks and lowers the top level items of a unit, in source order
+        void check(const std::vector<ASTPtr> &items);
+        // expressions typed so far
+        std::size_t typed() const { return count; }
+
+    private:
+        struct Local
+        {
+            ValueType type = ValueType::NONE;
+            bool global = false;
+            uint32_t reg = 0;      // register on its function, the index of a global, or the IrFunction of a FUNC
+            uint32_t function = 0; // the IrFunction it's a local of
+        };
+
+        // an operand on its way to a register: node (if any) is left to be emitted on into,
+        // then converted to as on reg when convert is set
+        struct Operand
+        {
+            ASTPtr node = nullptr;
+            uint32_t into = IrInst::none;
+            uint32_t reg = IrInst::none;
+            uint32_t src = IrInst::none;
+            bool convert = false;
+            ValueType as = ValueType::NONE;
+            ValueType from = ValueType::NONE;
+        };
+
+        // the walks that run on a stack of their own, see infer and emitInto
+        struct Typing
+        {
+            ASTPtr node;
+            bool ready; // its operands were typed
+        };
+        struct Lowering
+        {
+            ASTPtr node; // a BinOp or a UnaryOp
+            uint32_t dst;
+            int step;
+            ValueType type;
+            Operand left, right;
+        };
+
+        // the types, the errors are reported here
+        ValueType infer(ASTPtr node);
+        // the type of node from the types of its operands
+        ValueType typeNode(ASTPtr node);
+        ValueType inferBinary(BinOp &node);
+        ValueType inferUnary(UnaryOp &node);
+        ValueType inferCall(IdentifierNode &node);
+        ValueType inferCondition(IfExpressionNode &node);
+        // how a name is used: a value the analyzer checked already, a print operand or a "$[name]" hole
+        enum class Use
+        {
+            VALUE,
+            OPERAND,
+            HOLE
+        };
+        ValueType inferVariable(Symbol name, Use use);
+        void checkFormat(const FormatPlan &plan);
+        // the value of node can go to a binding of type to
+        static bool assignable(ASTPtr node, ValueType to);
+        void mismatch(const std::string &what, ValueType to, ASTPtr value);
+
+        // the code, from the typed nodes
+        void statement(ASTPtr node);
+        // binds a function to a new IrFunction (its index, or none if the name was taken)
+        uint32_t declare(FunctionDefinitionNode &node);
+        void function(FunctionDefinitionNode &node, uint32_t index);
+        void block(ASTPtr node);
+        void define(VariableDefinitionNode &node);
+        void loop(LoopNode &node);
+        void print(IrOp op, const FormatPlan &plan);
+        // a register with the value of node (the register of a local as it is)
+        uint32_t value(ASTPtr node);
+        // the value of node as the type as, on the register dst
+        void lower(ASTPtr node, uint32_t dst, ValueType as);
+        // node (of its own type) on dst
+        void emitInto(ASTPtr node, uint32_t dst);
+        // emitInto for the nodes that aren't operators
+        void emitValue(ASTPtr node, uint32_t dst);
+        uint32_t operand(ASTPtr node, ValueType as);
+        // operand() and lower() split around the code of the node itself (dst none is operand())
+        void start(ASTPtr node, ValueType as, uint32_t dst, Operand &o);
+        void finish(const Operand &o);
+        uint32_t load(Symbol name, uint32_t dst);
+        uint32_t text(const FormatPlan &plan, uint32_t dst);
+        uint32_t condition(ASTPtr node);
+
+        void number(ValueType type, uint32_t dst, int64_t integer, double real);
+        uint32_t emit(IrOp op, ValueType type, uint32_t dst, uint32_t a = IrInst::none, uint32_t b = IrInst::none);
+        uint32_t here() const { return static_cast<uint32_t>(code().size()); }
+        std::vector<IrInst> &code() { return unit.functions[current].code; }
+        const std::vector<IrInst> &code() const { return unit.functions[current].code; }
+        uint32_t temp();
+
+        IrUnit &unit;
+        ScopeTable<Local> scopes;
+        uint32_t current = 0;  // IrFunction being lowered
+        uint32_t next_reg = 0; // its first free register
+        std::size_t count = 0;
+        std::vector<bool> ahead; // by IrFunction: a top level function bound before its declaration was reached
+        std::vector<Typing> typing;
+        std::vector<Lowering> lowering;
+    };
+}
+
+#endif // TYPE_CHECKER_HPP
@@ -0,0 +1,143 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TYPED_IR_HPP
+#define TYPED_IR_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "format_plan.hpp"
+#include "interner.hpp"
+#include "val_types.hpp"
+
+namespace Rythin
+{
+    // the operations of the typed IR. every one works on a single type (IrInst::type),
+    // so a back end picks the machine operation from the instruction, with no tag on the values
+    enum class IrOp : uint8_t
+    {
+        CONST,        // dst = constant of type: the 64 bits of the number on a (low) and b (high), a string on IrUnit::strings for charseq
+        MOVE,         // dst = a
+        LOAD_GLOBAL,  // dst = global a
+        STORE_GLOBAL, // global a = b
+        CONVERT,      // dst = a (of the type from) as type
+        BOX,          // dst = a (of the type from) as an obj
+        NEG,          // dst = -a
+        BIT_NOT,      // dst = ~a
+        ADD,          // dst = a + b, and the same for the operators below
+        SUB,
+        MUL,
+        DIV,
+        MOD,
+        BIT_AND,
+        BIT_OR,
+        BIT_XOR,
+        SHL,
+        SHR,
+        EQ,           // dst (a bool) = a == b, type is the one of a and b
+        NE,
+        LT,
+        LE,
+        GT,
+        GE,
+        AND,          // on bools
+        OR,
+        FORMAT,       // dst = IrUnit::formats[a] with the charseqs b, b + 1... on its slots
+        PRINT,        // prints the charseq a
+        PRINT_NL,
+        PRINT_E,
+        INPUT,        // dst = a line read after the prompt a, b is the time
+        CALL,         // dst = function a called with the registers b, b + 1... (the arguments, of the types of its parameters)
+        JUMP,         // to the instruction a
+        BRANCH_FALSE, // to the instruction b when the bool a is false
+        RET,          // returns a (nothing when type is NONE)
+        FIN,          // ends the program with the int32 a as the exit code
+    };
+
+    const char *irOpName(IrOp op);
+
+    struct IrInst
+    {
+        static constexpr uint32_t none = UINT32_MAX;
+
+        IrOp op;
+        ValueType type = ValueType::NONE; // of the result (of the operands, on the compares)
+        ValueType from = ValueType::NONE; // of a, on CONVERT and BOX
+        uint8_t unused = 0;
+        uint32_t dst = none;
+        uint32_t a = none;
+        uint32_t b = none;
+
+        // the number of a CONST: integers (and bools, bytes) as int64, floats as double
+        int64_t integer() const { return static_cast<int64_t>((static_cast<uint64_t>(b) << 32) | a); }
+        double real() const
+        {
+            double d;
+            int64_t bits = integer();
+            std::memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+        void setInteger(int64_t value)
+        {
+            a = static_cast<uint32_t>(static_cast<uint64_t>(value));
+            b = static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32);
+        }
+        void setReal(double value)
+        {
+            int64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            setInteger(bits);
+        }
+    };
+
+    static_assert(sizeof(IrInst) == 16, "four instructions per cache line");
+
+    struct IrFunction
+    {
+        Symbol name = Interner::empty;
+        std::vector<ValueType> params; // they come on the registers 0, 1...
+        uint32_t registers = 0;        // the locals and temporaries (a register is reused once its block or statement ends)
+        bool lowered = false;          // false for a lazy body that was never parsed
+        std::vector<IrInst> code;
+    };
+
+    /**
+     * @brief the typed IR of a unit, made by the TypeChecker
+     *
+     * Register based, one IrFunction per function of the unit plus the top level
+     * code (functions[0], it sets the globals). Every instruction names the type it
+     * works on, and the conversions (int32 to float64, any value to an obj...) are
+     * explicit CONVERT and BOX instructions, so no register ever needs a runtime tag:
+     * an obj is the only boxed value. Jumps are indexes on the code of their function.
+     **/
+    struct IrUnit
+    {
+        std::vector<IrFunction> functions;
+        std::vector<ValueType> globals;    // by index, as LOAD_GLOBAL and STORE_GLOBAL use them
+        std::vector<std::string> strings;  // of the charseq CONSTs
+        std::vector<FormatPlan> formats;   // of the FORMATs
+
+        void clear();
+        std::size_t instructions() const;
+        // one line per global and per instruction
+        void dump(std::ostream &out) const;
+    };
+}
+
+#endif // TYPED_IR_HPP
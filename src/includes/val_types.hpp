@@ -16,13 +16,72 @@
 #ifndef VAL_TYPES_H
 #define VAL_TYPES_H
 
-enum class ValueType {
-    INT,
+#include <cstdint>
+
+#include "../../src/lexer/lex_types.hpp"
+
+// the static type of a value, set on every expression by the TypeChecker (type_checker.hpp).
+// the numeric ones are in promotion order: BYTE < INT < INT64 < FLOAT < DOUBLE
+enum class ValueType : uint8_t {
+    NONE,    // not checked yet, or its type error was already reported
     BOOL,
-    OBJ_PTR,
-    FLOAT,
-    STR,
-    DOUBLE
+    BYTE,
+    INT,     // int32
+    INT64,
+    FLOAT,   // float32
+    DOUBLE,  // float64
+    STR,     // charseq
+    OBJ_PTR, // obj: a boxed value of any type
+    FUNC
 };
 
-#endif //VAL_TYPES_H
\ No newline at end of file
+namespace Rythin
+{
+    constexpr bool isNumeric(ValueType type)
+    {
+        return type >= ValueType::BYTE && type <= ValueType::DOUBLE;
+    }
+
+    constexpr bool isIntegral(ValueType type)
+    {
+        return type >= ValueType::BYTE && type <= ValueType::INT64;
+    }
+
+    // the type named on a declaration (def x:int32, a:float64...), NONE if it's not a type
+    constexpr ValueType valueTypeOf(TokensTypes type)
+    {
+        switch (type)
+        {
+        case TokensTypes::TOKEN_BOOL: return ValueType::BOOL;
+        case TokensTypes::TOKEN_BYTES: return ValueType::BYTE;
+        case TokensTypes::TOKEN_INT_32: return ValueType::INT;
+        case TokensTypes::TOKEN_INT_64: return ValueType::INT64;
+        case TokensTypes::TOKEN_FLOAT_32: return ValueType::FLOAT;
+        case TokensTypes::TOKEN_FLOAT_64: return ValueType::DOUBLE;
+        case TokensTypes::TOKEN_CHARSEQ: return ValueType::STR;
+        case TokensTypes::TOKEN_OBJECT: return ValueType::OBJ_PTR;
+        case TokensTypes::TOKEN_FUNC: return ValueType::FUNC;
+        default: return ValueType::NONE;
+        }
+    }
+
+    // the name of the type as it's written on the code
+    constexpr const char *valueTypeName(ValueType type)
+    {
+        switch (type)
+        {
+        case ValueType::BOOL: return "bool";
+        case ValueType::BYTE: return "byte";
+        case ValueType::INT: return "int32";
+        case ValueType::INT64: return "int64";
+        case ValueType::FLOAT: return "float32";
+        case ValueType::DOUBLE: return "float64";
+        case ValueType::STR: return "charseq";
+        case ValueType::OBJ_PTR: return "obj";
+        case ValueType::FUNC: return "func";
+        default: return "none";
+        }
+    }
+}
+
+#endif //VAL_TYPES_H
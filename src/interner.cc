@@ -0,0 +1,102 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <cstring>
+
+#include "../src/includes/interner.hpp"
+
+namespace Rythin
+{
+    namespace
+    {
+        const std::size_t first_block = 16 * 1024;
+
+        // FNV-1a, names are short so there's nothing to gain from a wider hash
+        inline uint32_t hashOf(std::string_view s)
+        {
+            uint32_t h = 2166136261u;
+            for (char c : s)
+                h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+            return h;
+        }
+    }
+
+    Interner::Interner() : slots(1024, 0), block_used(0), block_size(0), block_bytes(0)
+    {
+        intern(std::string_view()); // id 0
+    }
+
+    const char *Interner::store(std::string_view s)
+    {
+        if (s.empty())
+            return "";
+        if (blocks.empty() || block_used + s.size() > block_size)
+        {
+            block_size = s.size() > first_block ? s.size() : first_block;
+            blocks.push_back(std::make_unique<char[]>(block_size));
+            block_bytes += block_size;
+            block_used = 0;
+        }
+        char *dst = blocks.back().get() + block_used;
+        std::memcpy(dst, s.data(), s.size());
+        block_used += s.size();
+        return dst;
+    }
+
+    void Interner::grow()
+    {
+        std::vector<Symbol> bigger(slots.size() * 2, 0);
+        std::size_t mask = bigger.size() - 1;
+        for (Symbol id = 0; id < spellings.size(); id++)
+        {
+            std::size_t i = hashes[id] & mask;
+            while (bigger[i] != 0)
+                i = (i + 1) & mask;
+            bigger[i] = id + 1;
+        }
+        slots = std::move(bigger);
+    }
+
+    Symbol Interner::intern(std::string_view s)
+    {
+        uint32_t h = hashOf(s);
+        std::size_t mask = slots.size() - 1;
+        std::size_t i = h & mask;
+        while (slots[i] != 0)
+        {
+            Symbol id = slots[i] - 1;
+            if (hashes[id] == h && spellings[id] == s)
+                return id;
+            i = (i + 1) & mask;
+        }
+
+        Symbol id = static_cast<Symbol>(spellings.size());
+        spellings.push_back(std::string_view(store(s), s.size()));
+        hashes.push_back(h);
+        slots[i] = id + 1;
+        // keeps the load under 1/2, the probes stay short
+        if (spellings.size() * 2 > slots.size())
+            grow();
+        return id;
+    }
+
+    std::size_t Interner::memoryUsage() const
+    {
+        std::size_t bytes = spellings.capacity() * sizeof(std::string_view) +
+                            hashes.capacity() * sizeof(uint32_t) +
+                            slots.capacity() * sizeof(Symbol);
+        return bytes + block_bytes;
+    }
+}
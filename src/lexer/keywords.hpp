@@ -0,0 +1,192 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef KEYWORDS_HPP
+#define KEYWORDS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "lex_types.hpp"
+
+namespace Rythin::Keywords
+{
+    struct Keyword
+    {
+        std::string_view spelling;
+        TokensTypes type;
+    };
+
+    // the one list of keywords: the lexer hash table and Tokens::tokenTypeToString are built from it.
+    // when a token type has more than one spelling, the first one is the name shown on messages
+    inline constexpr Keyword list[] = {
+        {"using", TokensTypes::TOKEN_USING},
+        {"const", TokensTypes::TOKEN_CONST},
+        {"finish", TokensTypes::TOKEN_FINISH},
+        {"def", TokensTypes::TOKEN_DEF},
+        {"let", TokensTypes::TOKEN_LET},
+        {"from", TokensTypes::TOKEN_FROM},
+        {"get", TokensTypes::TOKEN_GET},
+        {"loop", TokensTypes::TOKEN_LOOP},
+        {"in", TokensTypes::TOKEN_IN},
+        {"and", TokensTypes::TOKEN_LOGICAL_AND},
+        {"or", TokensTypes::TOKEN_LOGICAL_OR},
+        {"stop", TokensTypes::TOKEN_STOP},
+        {"continue", TokensTypes::TOKEN_CONTINUE},
+        {"if", TokensTypes::TOKEN_IF},
+        {"but", TokensTypes::TOKEN_BUT},
+        {"try", TokensTypes::TOKEN_TRY},
+        {"catch", TokensTypes::TOKEN_CATCH},
+        {"return", TokensTypes::TOKEN_RETURN},
+        {"alloc", TokensTypes::TOKEN_ALLOC},
+        {"flush", TokensTypes::TOKEN_FLUSH},
+        {"cinput", TokensTypes::TOKEN_CINPUT},
+        {"fwrite", TokensTypes::TOKEN_FWRITE},
+        {"fread", TokensTypes::TOKEN_FREAD},
+        {"mkdir", TokensTypes::TOKEN_MKDIR},
+        {"len", TokensTypes::TOKEN_LEN},
+        {"int32", TokensTypes::TOKEN_INT_32},
+        {"int64", TokensTypes::TOKEN_INT_64},
+        {"f", TokensTypes::TOKEN_FLOAT_IND},
+        {"bool", TokensTypes::TOKEN_BOOL},
+        {"charseq", TokensTypes::TOKEN_CHARSEQ},
+        {"obj", TokensTypes::TOKEN_OBJECT},
+        {"func", TokensTypes::TOKEN_FUNC},
+        {"float32", TokensTypes::TOKEN_FLOAT_32},
+        {"float64", TokensTypes::TOKEN_FLOAT_64},
+        {"byte", TokensTypes::TOKEN_BYTES},
+        {"print", TokensTypes::TOKEN_PRINT},
+        {"printnl", TokensTypes::TOKEN_PRINT_NEW_LINE},
+        {"printe", TokensTypes::TOKEN_PRINT_ERROR},
+        {"true", TokensTypes::TOKEN_TRUE},
+        {"false", TokensTypes::TOKEN_FALSE},
+        {"parallel", TokensTypes::TOKEN_PARALLEL},
+        {"nil", TokensTypes::TOKEN_NIL},
+        {"has", TokensTypes::TOKEN_HAS},
+    };
+
+    inline constexpr std::size_t count = sizeof(list) / sizeof(list[0]);
+    inline constexpr std::size_t table_size = 128; // power of two, at least ~3x the keywords
+
+    constexpr std::size_t minLength()
+    {
+        std::size_t min = list[0].spelling.size();
+        for (const Keyword &kw : list)
+            min = kw.spelling.size() < min ? kw.spelling.size() : min;
+        return min;
+    }
+
+    constexpr std::size_t maxLength()
+    {
+        std::size_t max = 0;
+        for (const Keyword &kw : list)
+            max = kw.spelling.size() > max ? kw.spelling.size() : max;
+        return max;
+    }
+
+    inline constexpr std::size_t min_length = minLength();
+    inline constexpr std::size_t max_length = maxLength();
+
+    // hashes the length and the first, middle and last chars, so it's O(1) for any identifier
+    constexpr uint32_t hash(std::string_view s, uint32_t seed)
+    {
+        uint32_t h = seed ^ (static_cast<uint32_t>(s.size()) * 0x9E3779B1u);
+        h = (h ^ static_cast<unsigned char>(s[0])) * 0x01000193u;
+        h = (h ^ static_cast<unsigned char>(s[s.size() / 2])) * 0x01000193u;
+        h = (h ^ static_cast<unsigned char>(s[s.size() - 1])) * 0x01000193u;
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h & (table_size - 1);
+    }
+
+    constexpr bool isPerfect(uint32_t seed)
+    {
+        bool used[table_size] = {};
+        for (const Keyword &kw : list)
+        {
+            uint32_t slot = hash(kw.spelling, seed);
+            if (used[slot])
+                return false;
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    // first seed without collisions, searched by the compiler
+    constexpr uint32_t findSeed()
+    {
+        for (uint32_t seed = 0; seed < 1000000; seed++)
+        {
+            if (isPerfect(seed))
+                return seed;
+        }
+        return UINT32_MAX;
+    }
+
+    inline constexpr uint32_t seed = findSeed();
+    static_assert(seed != UINT32_MAX, "no perfect hash seed for the keyword list, grow table_size");
+
+    constexpr std::array<Keyword, table_size> buildTable()
+    {
+        std::array<Keyword, table_size> table{};
+        for (Keyword &slot : table)
+            slot = Keyword{std::string_view(), TokensTypes::TOKEN_IDENTIFIER};
+        for (const Keyword &kw : list)
+            table[hash(kw.spelling, seed)] = kw;
+        return table;
+    }
+
+    inline constexpr std::array<Keyword, table_size> table = buildTable();
+
+    // keyword type of the spelling, or TOKEN_IDENTIFIER. one hash and one compare
+    constexpr TokensTypes lookup(std::string_view s)
+    {
+        if (s.size() < min_length || s.size() > max_length)
+            return TokensTypes::TOKEN_IDENTIFIER;
+        const Keyword &kw = table[hash(s, seed)];
+        return kw.spelling == s ? kw.type : TokensTypes::TOKEN_IDENTIFIER;
+    }
+
+    inline constexpr std::size_t type_count = static_cast<std::size_t>(TokensTypes::TOKEN_PARALLEL) + 1;
+
+    constexpr std::array<std::string_view, type_count> buildSpellings()
+    {
+        std::array<std::string_view, type_count> names{};
+        for (const Keyword &kw : list)
+        {
+            std::string_view &name = names[static_cast<std::size_t>(kw.type)];
+            if (name.empty())
+                name = kw.spelling;
+        }
+        return names;
+    }
+
+    inline constexpr std::array<std::string_view, type_count> spellings = buildSpellings();
+
+    // keyword spelling of the type, empty if it isn't a keyword type
+    constexpr std::string_view spelling(TokensTypes type)
+    {
+        std::size_t i = static_cast<std::size_t>(type);
+        return i < type_count ? spellings[i] : std::string_view();
+    }
+
+    static_assert(lookup("printnl") == TokensTypes::TOKEN_PRINT_NEW_LINE);
+    static_assert(lookup("printn") == TokensTypes::TOKEN_IDENTIFIER);
+}
+
+#endif // KEYWORDS_HPP
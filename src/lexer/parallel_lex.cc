@@ -0,0 +1,193 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+// local includes
+#include "../../src/lexer/parallel_lex.hpp"
+#include "../../src/includes/log.hpp"
+
+using namespace Log;
+
+namespace Rythin
+{
+    ParallelLexer::ParallelLexer(std::string_view input, unsigned threads) : code_input(input), workers(threads), splits(0), resyncs(0)
+    {
+        if (workers == 0)
+            workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<ParallelLexer::Chunk> ParallelLexer::split() const
+    {
+        // a few chunks per thread, so a slow chunk doesn't leave the others idle
+        std::size_t size = code_input.size();
+        std::size_t count = std::max<std::size_t>(1, std::min<std::size_t>(workers * 4, size / min_chunk));
+        std::size_t target = size / count;
+
+        std::vector<Chunk> pieces;
+        pieces.reserve(count);
+        std::size_t begin = 0;
+        do
+        {
+            std::size_t end = size;
+            std::size_t cut = begin + target;
+            if (pieces.size() + 1 < count && cut < size)
+            {
+                // chunks start on a line, right after the '\n'
+                const char *nl = static_cast<const char *>(std::memchr(code_input.data() + cut, '\n', size - cut));
+                end = nl ? (nl - code_input.data()) + 1 : size;
+            }
+            Chunk piece;
+            piece.begin = begin;
+            piece.end = end;
+            pieces.push_back(std::move(piece));
+            begin = end;
+        } while (begin < size);
+        return pieces;
+    }
+
+    void ParallelLexer::lexChunk(Chunk &chunk) const
+    {
+        Lexer lexer(code_input);
+        lexer.seek(chunk.begin);
+        lexer.deferErrors(&chunk.errors);
+        chunk.tokens.clear();
+        chunk.texts.clear();
+        chunk.errors.clear();
+        chunk.eof = false;
+        chunk.halted = false;
+        chunk.tokens.reserve((chunk.end - chunk.begin) / 4 + 1);
+        while (true)
+        {
+            RawToken tk = lexer.next_tk();
+            if (lexer.halted())
+            {
+                chunk.halted = true;
+                chunk.next = tk.offset;
+                return;
+            }
+            // the first token of the next chunk is lexed only to know where this one stops
+            bool fresh = !lexer.continued();
+            if (fresh && tk.type != TokensTypes::TOKEN_EOF && tk.offset >= chunk.end)
+            {
+                chunk.next = tk.offset;
+                return;
+            }
+            uint32_t text = 0;
+            if (TokenStream::hasPayload(tk.type))
+            {
+                text = static_cast<uint32_t>(chunk.texts.size());
+                chunk.texts.push_back(std::move(tk.text));
+            }
+            chunk.tokens.push_back(Lexed{static_cast<uint8_t>(tk.type), fresh, tk.offset, tk.length, text, tk.number});
+            if (tk.type == TokensTypes::TOKEN_EOF)
+            {
+                chunk.eof = true;
+                return;
+            }
+        }
+    }
+
+    bool ParallelLexer::keep(Chunk &chunk, std::size_t first, std::size_t from, TokenStream &out)
+    {
+        // errors of the dropped tokens and of the one past the end are not reported
+        for (const LexDiagnostic &err : chunk.errors)
+        {
+            if (err.token < from || (!chunk.eof && !err.fatal && err.token >= chunk.next))
+                continue;
+            LogErrors::getInstance().addError(err.message, err.code, SourceLocation{&out.lineIndex(), err.offset});
+        }
+        for (std::size_t i = first; i < chunk.tokens.size(); i++)
+        {
+            Lexed &tk = chunk.tokens[i];
+            TokensTypes type = static_cast<TokensTypes>(tk.type);
+            std::string text = TokenStream::hasPayload(type) ? std::move(chunk.texts[tk.text]) : std::string();
+            out.push(RawToken{type, tk.offset, tk.length, std::move(text), tk.number});
+        }
+        if (chunk.halted)
+        {
+            // the unexpected character is real, same end as the serial lexer
+            LogErrors::getInstance().printAll();
+            exit(76);
+        }
+        return !chunk.eof;
+    }
+
+    void ParallelLexer::tokenize(TokenStream &out)
+    {
+        std::vector<Chunk> pieces = split();
+        splits = pieces.size();
+        resyncs = 0;
+        if (workers <= 1 || pieces.size() <= 1)
+        {
+            Lexer lexer(code_input);
+            lexer.tokenize(out);
+            return;
+        }
+
+        // the threads take the next chunk not lexed yet, the calling thread is one of them
+        std::atomic<std::size_t> next_chunk{0};
+        auto work = [&] {
+            for (std::size_t i = next_chunk++; i < pieces.size(); i = next_chunk++)
+                lexChunk(pieces[i]);
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        for (unsigned t = 1; t < workers && t < pieces.size(); t++)
+            pool.emplace_back(work);
+        work();
+        for (std::thread &t : pool)
+            t.join();
+
+        std::size_t total = 0;
+        for (const Chunk &chunk : pieces)
+            total += chunk.tokens.size();
+        out.reserve(total);
+
+        // pos: start of the next token of the serial lexing
+        std::size_t pos = 0;
+        for (Chunk &chunk : pieces)
+        {
+            if (pos >= chunk.end)
+                continue; // all inside a token of a chunk before
+
+            auto it = std::lower_bound(chunk.tokens.begin(), chunk.tokens.end(), pos,
+                                       [](const Lexed &tk, std::size_t offset) { return tk.offset < offset; });
+            bool synced = pos == chunk.begin || (it != chunk.tokens.end() && it->offset == pos && it->fresh) ||
+                          (chunk.halted && chunk.next == pos);
+            std::size_t first = it - chunk.tokens.begin();
+            if (!synced)
+            {
+                // the chunk started inside a token, its guess is thrown away
+                chunk.begin = pos;
+                lexChunk(chunk);
+                resyncs++;
+                first = 0;
+            }
+            if (!keep(chunk, first, pos, out))
+                return;
+            pos = chunk.next;
+            // frees the chunk as soon as it's on the stream
+            std::vector<Lexed>().swap(chunk.tokens);
+            std::vector<std::string>().swap(chunk.texts);
+        }
+        // the last chunk ends on the input end, so its EOF token returned above
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PARALLEL_LEX_HPP
+#define PARALLEL_LEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../src/tokens/token_stream.hpp"
+#include "r_lex.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief lexes a big source on several threads
+     *
+     * The source is cut in chunks at line starts and every chunk is lexed on its
+     * own, as if nothing came before it. That guess is only wrong when the cut
+     * falls inside a token (a string literal or a "$[...]" that spans lines), and
+     * the lexer keeps no state between tokens but the offset, so the stitch walks
+     * the chunks in order: a chunk is kept from the token that starts where the
+     * previous chunk stopped, and if none does it's lexed again from there.
+     * (The pieces of a string with "$[name]" holes come from one lexing, so only
+     * the first one counts as a token start.)
+     * The errors of the chunks are held back and only the ones of kept tokens are
+     * reported, so the tokens, the errors and their order are the same of
+     * Lexer::tokenize. Identifiers are interned by the stitch, on the calling thread.
+     **/
+    class ParallelLexer
+    {
+    public:
+        // below this many bytes per chunk the threads don't pay off
+        static constexpr std::size_t min_chunk = 256 * 1024;
+
+        // threads = 0 takes one per core
+        ParallelLexer(std::string_view input, unsigned threads);
+
+        // lexes the whole input into the stream (EOF token included)
+        void tokenize(TokenStream &out);
+
+        unsigned threads() const { return workers; }
+        // chunks of the last tokenize, and how many of them were lexed again
+        std::size_t chunks() const { return splits; }
+        std::size_t relexed() const { return resyncs; }
+
+    private:
+        // RawToken without the string (24 bytes instead of 56), the texts are on the chunk
+        struct Lexed
+        {
+            uint8_t type;
+            bool fresh; // not a piece of a string with holes, the lexing can restart at its offset
+            uint32_t offset;
+            uint32_t length;
+            uint32_t text; // index on Chunk::texts, only for tokens with payload
+            Number number;
+        };
+
+        struct Chunk
+        {
+            std::size_t begin;
+            std::size_t end;                  // tokens starting at [begin, end) are the chunk's
+            std::vector<Lexed> tokens;
+            std::vector<std::string> texts;
+            std::vector<LexDiagnostic> errors;
+            std::size_t next = 0;             // start of the first token past end (or of the bad char)
+            bool eof = false;                 // the last token is the EOF one
+            bool halted = false;              // stopped on an unexpected character at next
+        };
+
+        std::vector<Chunk> split() const;
+        void lexChunk(Chunk &chunk) const;
+        // keeps the tokens of the chunk from index first on, false once the EOF is pushed
+        bool keep(Chunk &chunk, std::size_t first, std::size_t from, TokenStream &out);
+
+        std::string_view code_input; // not owned, must outlive the lexer
+        unsigned workers;
+        std::size_t splits;
+        std::size_t resyncs;
+    };
+}
+
+#endif // PARALLEL_LEX_HPP
@@ -19,14 +19,17 @@
 #include <string>
 #include <cctype>
 #include <stdexcept>
-#include <unordered_map>
 #include <limits.h>
-#include <queue>
+#include <utility>
+#include <charconv>
+#include <cstdint>
 
 // local includes
 #include "../../src/lexer/r_lex.hpp"
 #include "../../src/tokens/t_tokens.hpp"
 #include "../../src/lexer/lex_types.hpp"
+#include "../../src/lexer/keywords.hpp"
+#include "../../src/lexer/r_scan.hpp"
 #include "../../src/includes/rexcept.hpp"
 #include "../../src/includes/log.hpp"
 #include "../../src/includes/ast.hpp"
@@ -34,141 +37,135 @@
 using namespace Log;
 using namespace std;
 
-std::queue<Tokens> token_buffer;
-
 namespace Rythin
 {
-    Lexer::Lexer(std::string input) : code_input(input), position(0), line(1), column(0)
+    Lexer::Lexer(std::string_view input) : code_input(input), position(0), tk_start(0), lines(input), index(&lines), scan(Scan::kernels()), deferred(nullptr), stopped(false), queued(0), resumed(false)
     {
         current_input = (input.length() > 0) ? input[position] : '\0';
     }
 
-    Tokens Lexer::next_tk()
+    void Lexer::seek(std::size_t offset)
     {
-        skip_withspace();
-        if (std::isalpha(current_input) || current_input == '_')
-        {
-            return identifier();
-        }
-        else if (current_input == '"')
-        {
-            return stringLiteral();
-        }
-        else if (std::isdigit(current_input) == true || current_input == '.')
-        {
-            bool isFloat = false;
-            bool isDouble = false;
-
-            std::string numberStr;
-
-            if (current_input == '.')
-            {
-                numberStr += current_input;
-                advance_tk();
-
-                std::string fractional = digits();
-                if (fractional.empty())
-                {
-                    LogErrors::getInstance().addError("Invalid float/double format", 23, line, column);
-                    //throw Excepts::SyntaxException("\f\fInvalid float/double format at line: " + line);
-                }
-
-                numberStr += fractional;
-                isDouble = true;
+        position = offset;
+        tk_start = position;
+        pending.clear();
+        queued = 0;
+        current_input = (position < code_input.length()) ? code_input[position] : '\0';
+    }
 
-                if (current_input == 'f')
-                {
-                    isFloat = true;
-                    isDouble = false;
-                    advance_tk();
-                }
+    void Lexer::deferErrors(std::vector<LexDiagnostic> *sink)
+    {
+        deferred = sink;
+    }
 
-                return Tokens(isFloat ? TokensTypes::TOKEN_FLOAT_32 : TokensTypes::TOKEN_FLOAT_64, numberStr, line, column);
-            }
+    bool Lexer::halted() const
+    {
+        return stopped;
+    }
 
-            numberStr += digits();
+    void Lexer::report(const std::string &message, int code)
+    {
+        if (deferred)
+        {
+            deferred->push_back(LexDiagnostic{message, code, static_cast<uint32_t>(position), static_cast<uint32_t>(tk_start), false});
+            return;
+        }
+        LogErrors::getInstance().addError(message, code, here());
+    }
 
-            if (current_input == '.')
-            {
-                numberStr += current_input;
-                advance_tk();
+    RawToken Lexer::token(TokensTypes type, std::string text)
+    {
+        return RawToken{type, static_cast<uint32_t>(tk_start), static_cast<uint32_t>(position - tk_start), std::move(text), {0}};
+    }
 
-                std::string fractional = digits();
-                if (fractional.empty())
-                {
-                    LogErrors::getInstance().addError("Invalid float/double format", 23, line, column);
-                    //throw std::runtime_error("Invalid float/double format");
-                }
+    void Lexer::tokenize(TokenStream &out)
+    {
+        // a held error can outlive the lexer, the stream's index lives as long as the tokens
+        index = &out.lineIndex();
+        // rough guess of one token every 4 bytes, avoids most of the regrowth
+        out.reserve(code_input.size() / 4 + 1);
+        while (true)
+        {
+            RawToken tk = next_tk();
+            bool eof = tk.type == TokensTypes::TOKEN_EOF;
+            out.push(std::move(tk));
+            if (eof)
+                break;
+        }
+    }
 
-                numberStr += fractional;
-                isDouble = true;
-            }
+    bool Lexer::continued() const
+    {
+        return resumed;
+    }
 
-            if (current_input == 'f')
+    RawToken Lexer::next_tk()
+    {
+        resumed = queued < pending.size();
+        if (resumed)
+        {
+            RawToken tk = std::move(pending[queued++]);
+            if (queued == pending.size())
             {
-                isFloat = true;
-                isDouble = false;
-                advance_tk();
+                pending.clear();
+                queued = 0;
             }
+            return tk;
+        }
 
-            if (isFloat)
-                return Tokens(TokensTypes::TOKEN_FLOAT_32, numberStr, line, column);
-            else if (isDouble)
-                return Tokens(TokensTypes::TOKEN_FLOAT_64, numberStr, line, column);
-            else
-                return Tokens(TokensTypes::TOKEN_INT_32, numberStr, line, column);
+        // whitespace and comments are skipped in whole runs before the token
+        skip_withspace();
+        while (current_input == ';' || current_input == '#')
+        {
+            skip_comment();
+            skip_withspace();
+        }
+        tk_start = position;
+        if (std::isalpha(current_input) || current_input == '_')
+        {
+            return identifier();
+        }
+        else if (current_input == '"')
+        {
+            return stringLiteral();
+        }
+        else if (std::isdigit(static_cast<unsigned char>(current_input)) || current_input == '.')
+        {
+            return number();
         }
         else
         {
             switch (current_input)
             {
             case '\0':
-                return Tokens(TokensTypes::TOKEN_EOF, std::string("\0"), line, column);
-            case ';':
-                advance_tk();
-
-                while (current_input != '\0' && current_input != '\n')
-                {
-                    advance_tk();
-                }
-                return next_tk();
-            case '#':
-
-            {
-                while (current_input != '\0' and current_input != '\n')
-                {
-                    advance_tk();
-                }
-                return next_tk();
-            }
-
+                return token(TokensTypes::TOKEN_EOF);
             case ':':
                 advance_tk();
                 if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_ASSIGN, ":=", line, column);
+                    return token(TokensTypes::TOKEN_ASSIGN);
 
                 }
-                return Tokens(TokensTypes::TOKEN_COLON, ":", line, column);
+                return token(TokensTypes::TOKEN_COLON);
             case '=':
                 advance_tk();
                 if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_EQUAL, "==", line, column);
+                    return token(TokensTypes::TOKEN_EQUAL);
                 }
             case '!':
                 advance_tk();
                 if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_NOT_EQUAL, "!=", line, column);
+                    return token(TokensTypes::TOKEN_NOT_EQUAL);
 
                 }
                 else
                 {
-                    return Tokens(TokensTypes::TOKEN_NOT_EQUAL, "!", line, column);
+                    return token(TokensTypes::TOKEN_NOT_EQUAL);
 
                 }
             case '-':
@@ -176,115 +173,114 @@ namespace Rythin
                 if (current_input == '>')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_ARROW_SET, "->", line, column);
+                    return token(TokensTypes::TOKEN_ARROW_SET);
 
                 }
                 else if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_ATTR_MINUS, "-=", line, column);
+                    return token(TokensTypes::TOKEN_ATTR_MINUS);
 
                 }
                 else
                 {
-                    return Tokens(TokensTypes::TOKEN_MINUS, "-", line, column);
+                    return token(TokensTypes::TOKEN_MINUS);
 
                 }
             case '[':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_LBRACKET, "[", line, column);
+                return token(TokensTypes::TOKEN_LBRACKET);
 
             case ']':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_RBRACKET, "]", line, column);
+                return token(TokensTypes::TOKEN_RBRACKET);
 
             case '(':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_LPAREN, "(", line, column);
+                return token(TokensTypes::TOKEN_LPAREN);
 
             case ')':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_RPAREN, ")", line, column);
+                return token(TokensTypes::TOKEN_RPAREN);
 
             case '+':
                 advance_tk();
                 if (current_input == '+')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_PLUSPLUS, "++", line, column);
+                    return token(TokensTypes::TOKEN_PLUSPLUS);
 
                 }
                 else if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_ATTR_PLUS, "+=", line, column);
+                    return token(TokensTypes::TOKEN_ATTR_PLUS);
 
                 }
                 else
                 {
-                    return Tokens(TokensTypes::TOKEN_PLUS, "+", line, column);
+                    return token(TokensTypes::TOKEN_PLUS);
 
                 }
             case '.':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_DOT, ".", line, column);
+                return token(TokensTypes::TOKEN_DOT);
 
             case '/':
                 advance_tk();
                 if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_ATTR_DIVIDE, "/=", line, column);
+                    return token(TokensTypes::TOKEN_ATTR_DIVIDE);
 
                 }
-                return Tokens(TokensTypes::TOKEN_DIVIDE, "/", line, column);
+                return token(TokensTypes::TOKEN_DIVIDE);
 
             case '&':
                 advance_tk();
                 if (current_input == '&')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_LOGICAL_AND, "&&", line, column);
+                    return token(TokensTypes::TOKEN_LOGICAL_AND);
 
                 }
-                return Tokens(TokensTypes::TOKEN_REF, "&", line, column);
+                return token(TokensTypes::TOKEN_REF);
 
             case '$':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_DEREF, "$", line, column);
+                return token(TokensTypes::TOKEN_DEREF);
 
             case ',':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_COMMA, ",", line, column);
+                return token(TokensTypes::TOKEN_COMMA);
 
             case '*':
                 advance_tk();
                 if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_ATTR_MULTIPLY, "*=", line, column);
+                    return token(TokensTypes::TOKEN_ATTR_MULTIPLY);
 
                 }
-                return Tokens(TokensTypes::TOKEN_MULTIPLY, "*", line, column);
+                return token(TokensTypes::TOKEN_MULTIPLY);
 
             case '>':
                 advance_tk();
                 if (current_input == '>')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_SHIFT_RIGHT, ">>", line, column);
+                    return token(TokensTypes::TOKEN_SHIFT_RIGHT);
 
                 }
                 else if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_GREATER_EQUAL, ">=", line, column);
+                    return token(TokensTypes::TOKEN_GREATER_EQUAL);
 
                 }
                 else
                 {
-                    advance_tk();
-                    return Tokens(TokensTypes::TOKEN_GREATER_THAN, ">", line, column);
+                    return token(TokensTypes::TOKEN_GREATER_THAN);
 
                 }
             case '<':
@@ -292,134 +288,112 @@ namespace Rythin
                 if (current_input == '=')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_LESS_EQUAL, "<=", line, column);
+                    return token(TokensTypes::TOKEN_LESS_EQUAL);
 
                 }
                 else if (current_input == '<')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_SHIFT_LEFT, "<<", line, column);
+                    return token(TokensTypes::TOKEN_SHIFT_LEFT);
 
                 }
-                return Tokens(TokensTypes::TOKEN_LESS_THAN, "<", line, column);
+                return token(TokensTypes::TOKEN_LESS_THAN);
 
             case '|':
                 advance_tk();
                 if (current_input == '|')
                 {
                     advance_tk();
-                    return Tokens(TokensTypes::TOKEN_LOGICAL_OR, "||", line, column);
+                    return token(TokensTypes::TOKEN_LOGICAL_OR);
 
                 }
-                return Tokens(TokensTypes::TOKEN_BIT_OR, "|", line, column);
+                return token(TokensTypes::TOKEN_BIT_OR);
 
             case '%':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_MODULO, "%", line, column);
+                return token(TokensTypes::TOKEN_MODULO);
 
             case '~':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_BIT_NOT, "~", line, column);
+                return token(TokensTypes::TOKEN_BIT_NOT);
 
             case '^':
                 advance_tk();
-                return Tokens(TokensTypes::TOKEN_BIT_XOR, "^", line, column);
+                return token(TokensTypes::TOKEN_BIT_XOR);
             default:
-                LogErrors::getInstance().addError("Unexpected character: '" + to_string(current_input) + "'", 76, line, column);
+                report("Unexpected character: '" + to_string(current_input) + "'", 76);
+                if (deferred)
+                {
+                    // a chunk lexer may have started on a wrong guess, the ParallelLexer decides if it's real
+                    deferred->back().fatal = true;
+                    stopped = true;
+                    return token(TokensTypes::TOKEN_EOF);
+                }
                 LogErrors::getInstance().printAll();
                 exit(76);
             }
         }
     }
 
-    void Lexer::advance_tk(bool isComment)
+    void Lexer::advance_tk()
     {
-        if (current_input == '\n')
-        {
-            line++;
-            column = 0;
-        }
-        else
-        {
-            column++;
-        }
+        // only the offset is kept, line:column come from the LineIndex when an error needs them
         position++;
         current_input = (position < code_input.length()) ? code_input[position] : '\0';
     }
 
+    void Lexer::advance_run(std::size_t count)
+    {
+        position += count;
+        current_input = (position < code_input.length()) ? code_input[position] : '\0';
+    }
+
+    SourceLocation Lexer::here() const
+    {
+        return SourceLocation{index, position};
+    }
+
+    std::size_t Lexer::remaining() const
+    {
+        return (position < code_input.length()) ? code_input.length() - position : 0;
+    }
+
     void Lexer::skip_withspace()
     {
-        while (std::isspace(static_cast<unsigned char>(current_input)))
+        if (!std::isspace(static_cast<unsigned char>(current_input)))
+            return;
+        // a lone space or new line between tokens is the common case, it doesn't pay for the scanner call
+        if (!std::isspace(static_cast<unsigned char>(peekNextChar())))
         {
             advance_tk();
+            return;
         }
+        advance_run(scan.whitespace(code_input.data() + position, remaining()));
     }
 
-    Tokens Lexer::identifier()
+    void Lexer::skip_comment()
     {
-        int start = position;
-        while (std::isalnum(current_input) || current_input == '_' || current_input == '-')
-        {
-            advance_tk();
-        }
+        // from the ';' or '#' until the end of the line (the '\n' stays for skip_withspace)
+        advance_run(scan.lineBody(code_input.data() + position, remaining()));
+    }
 
-        std::string value = code_input.substr(start, position - start);
-        static const std::unordered_map<std::string, TokensTypes> keywords = {
-            {"using", TokensTypes::TOKEN_USING},
-            {"const", TokensTypes::TOKEN_CONST},
-            {"finish", TokensTypes::TOKEN_FINISH},
-            {"def", TokensTypes::TOKEN_DEF},
-            {"let", TokensTypes::TOKEN_LET},
-            {"from", TokensTypes::TOKEN_FROM},
-            {"get", TokensTypes::TOKEN_GET},
-            {"loop", TokensTypes::TOKEN_LOOP},
-            {"in", TokensTypes::TOKEN_IN},
-            {"and", TokensTypes::TOKEN_LOGICAL_AND},
-            {"or", TokensTypes::TOKEN_LOGICAL_OR},
-            {"stop", TokensTypes::TOKEN_STOP},
-            {"continue", TokensTypes::TOKEN_CONTINUE},
-            {"if", TokensTypes::TOKEN_IF},
-            {"but", TokensTypes::TOKEN_BUT},
-            {"try", TokensTypes::TOKEN_TRY},
-            {"catch", TokensTypes::TOKEN_CATCH},
-            {"return", TokensTypes::TOKEN_RETURN},
-            {"alloc", TokensTypes::TOKEN_ALLOC},
-            {"flush", TokensTypes::TOKEN_FLUSH},
-            {"cinput", TokensTypes::TOKEN_CINPUT},
-            {"fwrite", TokensTypes::TOKEN_FWRITE},
-            {"fread", TokensTypes::TOKEN_FREAD},
-            {"mkdir", TokensTypes::TOKEN_MKDIR},
-            {"len", TokensTypes::TOKEN_LEN},
-            {"int32", TokensTypes::TOKEN_INT_32},
-            {"int64", TokensTypes::TOKEN_INT_64},
-            {"f", TokensTypes::TOKEN_FLOAT_IND},
-            {"bool", TokensTypes::TOKEN_BOOL},
-            {"charseq", TokensTypes::TOKEN_CHARSEQ},
-            {"obj", TokensTypes::TOKEN_OBJECT},
-            {"func", TokensTypes::TOKEN_FUNC},
-            {"float32", TokensTypes::TOKEN_FLOAT_32},
-            {"float64", TokensTypes::TOKEN_FLOAT_64},
-            {"byte", TokensTypes::TOKEN_BYTES},
-            {"print", TokensTypes::TOKEN_PRINT},
-            {"printnl", TokensTypes::TOKEN_PRINT_NEW_LINE},
-            {"printe", TokensTypes::TOKEN_PRINT_ERROR},
-            {"true", TokensTypes::TOKEN_TRUE},
-            {"false", TokensTypes::TOKEN_FALSE},
-            {"parallel", TokensTypes::TOKEN_PARALLEL},
-            {"nil", TokensTypes::TOKEN_NIL},
-            {"has", TokensTypes::TOKEN_HAS}};
-
-        if (keywords.count(value))
-        {
-            return Tokens(keywords.at(value), value, line, column);
-        }
-        return Tokens(TokensTypes::TOKEN_IDENTIFIER, value, line, column);
+    RawToken Lexer::identifier()
+    {
+        std::size_t start = position;
+        advance_run(scan.identifier(code_input.data() + position, remaining()));
+
+        // perfect hash over the source slice, no string is built for the lookup
+        return token(Keywords::lookup(code_input.substr(start, position - start)));
     }
 
-    Tokens Lexer::stringLiteral()
+    RawToken Lexer::stringLiteral()
     {
+        // a string with holes is lexed as segments and holes: STRING_LITERAL (INTERP_START
+        // IDENTIFIER INTERP_END STRING_LITERAL)*. The first segment is returned, the rest is queued
         advance_tk(); // Skip opening quote
-        int start = position;
+        std::size_t segment = tk_start;
+        bool holes = false;
+        RawToken first;
         std::string ivalue = "";
         while (current_input != '"' && current_input != '\0')
         {
@@ -479,7 +453,7 @@ namespace Rythin
                 else
                 {
                     // LogErrors
-                    LogErrors::getInstance().addError("Unknown escape sequence \\" + current_input, 34, line, column);
+                    report("Unknown escape sequence \\" + current_input, 34);
                     //std::cerr << "Unknown escape sequence \\" << current_input << " at line " << line << ", column " << column << std::endl;
                     continue;
                     //throw std::runtime_error("Unknown escape sequence");
@@ -487,9 +461,15 @@ namespace Rythin
             }
             else if (current_input == '$' && peekNextChar() == '[')
             {
-                advance_tk(); // Skip $
-                advance_tk(); // Skip [
-                ivalue += processInterpolation();
+                RawToken text{TokensTypes::TOKEN_STRING_LITERAL, static_cast<uint32_t>(segment), static_cast<uint32_t>(position - segment), std::move(ivalue), {0}};
+                ivalue.clear();
+                if (holes)
+                    pending.push_back(std::move(text));
+                else
+                    first = std::move(text);
+                holes = true;
+                interpolation();
+                segment = position;
             }
             else
             {
@@ -499,46 +479,126 @@ namespace Rythin
         }
         if (current_input == '\0')
         {
-            LogErrors::getInstance().addError("Unterminated/unclosed string literal", 14, line, column);
+            report("Unterminated/unclosed string literal", 14);
         }
         advance_tk(); // skipping closing quotes
-        return Tokens(TokensTypes::TOKEN_STRING_LITERAL, ivalue, line, column);
+        if (!holes)
+            return token(TokensTypes::TOKEN_STRING_LITERAL, std::move(ivalue));
+        pending.push_back(RawToken{TokensTypes::TOKEN_STRING_LITERAL, static_cast<uint32_t>(segment), static_cast<uint32_t>(position - segment), std::move(ivalue), {0}});
+        return first;
     }
 
     char Lexer::peekNextChar() const
     {
-        int nextPosition = position + 1;
+        std::size_t nextPosition = position + 1;
         return (nextPosition < code_input.length()) ? code_input[nextPosition] : '\0';
     }
 
-    std::string Lexer::processInterpolation()
+    void Lexer::interpolation()
     {
-        int start = position;
-        while (current_input != ']' && current_input != '\0')
-        {
+        // "$[" name "]", with spaces around the name allowed
+        pending.push_back(RawToken{TokensTypes::TOKEN_INTERP_START, static_cast<uint32_t>(position), 2, std::string(), {0}});
+        advance_run(2);
+        while (current_input == ' ' || current_input == '\t')
             advance_tk();
+        if (std::isalpha(static_cast<unsigned char>(current_input)) || current_input == '_')
+        {
+            std::size_t start = position;
+            advance_run(scan.identifier(code_input.data() + position, remaining()));
+            pending.push_back(RawToken{TokensTypes::TOKEN_IDENTIFIER, static_cast<uint32_t>(start), static_cast<uint32_t>(position - start), std::string(), {0}});
+            while (current_input == ' ' || current_input == '\t')
+                advance_tk();
         }
-        if (current_input == ']')
+        if (current_input != ']')
         {
-            auto val = code_input.substr(start, position - start);
-            advance_tk(); // Skip ]
-            return val;
+            while (current_input != ']' && current_input != '\0')
+                advance_tk();
+            if (current_input == ']')
+                report("Only a variable name can be interpolated", 14);
         }
-        else
+        if (current_input == '\0')
         {
-            LogErrors::getInstance().addError("Unterminated interpolation", 14, line, column);
-            return nullptr;
+            report("Unterminated interpolation", 14);
+            // empty INTERP_END, the token sequence of the string stays complete for the parser
+            pending.push_back(RawToken{TokensTypes::TOKEN_INTERP_END, static_cast<uint32_t>(position), 0, std::string(), {0}});
+            return;
         }
+        pending.push_back(RawToken{TokensTypes::TOKEN_INTERP_END, static_cast<uint32_t>(position), 1, std::string(), {0}});
+        advance_tk(); // Skip ]
     }
 
-    std::string Lexer::digits()
+    int Lexer::digits()
     {
-        std::string res = "";
-        while (current_input != '\0' && std::isdigit(current_input))
+        std::size_t start = position;
+        while (std::isdigit(static_cast<unsigned char>(current_input)))
+        {
+            advance_tk();
+        }
+        return static_cast<int>(position - start);
+    }
+
+    RawToken Lexer::number()
+    {
+        bool isFloat = false;
+        bool isDouble = false;
+
+        digits(); // none when the literal starts with '.'
+        if (current_input == '.')
+        {
+            advance_tk();
+            if (digits() == 0)
+            {
+                report("Invalid float/double format", 23);
+                //throw Excepts::SyntaxException("\f\fInvalid float/double format at line: " + line);
+            }
+            isDouble = true;
+        }
+
+        std::size_t end = position; // the 'f' suffix is not part of the value
+        if (current_input == 'f')
         {
-            res += current_input;
+            isFloat = true;
+            isDouble = false;
             advance_tk();
         }
-        return res;
+
+        // decoded straight from the source, the parser only reads the binary value
+        const char *first = code_input.data() + tk_start;
+        const char *last = code_input.data() + end;
+        Number value = {0};
+        TokensTypes type;
+        if (isFloat || isDouble)
+        {
+            std::from_chars_result res;
+            if (isFloat)
+            {
+                float f = 0;
+                res = std::from_chars(first, last, f);
+                value.real = f;
+                type = TokensTypes::TOKEN_FLOAT_32;
+            }
+            else
+            {
+                res = std::from_chars(first, last, value.real);
+                type = TokensTypes::TOKEN_FLOAT_64;
+            }
+            if (res.ec == std::errc::result_out_of_range)
+                report("Float literal out of range", 23);
+        }
+        else
+        {
+            std::from_chars_result res = std::from_chars(first, last, value.integer);
+            if (res.ec == std::errc::result_out_of_range)
+            {
+                report("Integer literal out of range (bigger than int64)", 23);
+                value.integer = 0;
+            }
+            // the literals that don't fit on int32 are int64
+            type = (value.integer > INT32_MAX) ? TokensTypes::TOKEN_INT_64 : TokensTypes::TOKEN_INT_32;
+        }
+
+        RawToken tk = token(type);
+        tk.number = value;
+        return tk;
     }
-}
\ No newline at end of file
+}
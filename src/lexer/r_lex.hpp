@@ -16,32 +16,76 @@
 #ifndef R_LEX_HPP
 #define R_LEX_HPP
 
+#include "../../src/includes/line_index.hpp"
 #include "../../src/tokens/t_tokens.hpp"
+#include "../../src/tokens/token_stream.hpp"
 #include "lex_types.hpp"
+#include "r_scan.hpp"
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace Rythin
 {
+    // error of a chunk lexer (see ParallelLexer), only reported if its token is kept
+    struct LexDiagnostic
+    {
+        std::string message;
+        int code;
+        uint32_t offset; // where it was found
+        uint32_t token;  // start of the token that was being lexed
+        bool fatal;      // unexpected character, the lexer stopped there
+    };
+
     class Lexer
     {
     private:
-        std::string code_input;
+        std::string_view code_input; // not owned, must outlive the lexer (see SourceBuffer)
         char current_input;
-        int position;
-        int line;
-        int column;
+        std::size_t position;
+        std::size_t tk_start; // where the token being lexed starts
+        LineIndex lines; // line:column of the errors, built only if one is reported
+        const LineIndex *index; // the one the errors point to: lines, or the one of the stream being filled
+        const Scan::Kernels &scan; // vectorized scanners chosen for this cpu
+        std::vector<LexDiagnostic> *deferred; // set: the errors are held back instead of reported
+        bool stopped; // hit an unexpected character while deferring
+        // the tokens after the first segment of a string with "$[name]" holes,
+        // all lexed with it and given by the next calls
+        std::vector<RawToken> pending;
+        std::size_t queued; // next token of pending
+        bool resumed; // the last token came from pending
 
-        void advance_tk(bool isComment = NULL);
+        void advance_tk();
+        // moves over count bytes at once
+        void advance_run(std::size_t count);
+        SourceLocation here() const;
+        void report(const std::string &message, int code);
+        std::size_t remaining() const;
         void skip_withspace();
-        Tokens identifier();
-        Tokens stringLiteral();
+        void skip_comment();
+        RawToken token(TokensTypes type, std::string text = std::string());
+        RawToken identifier();
+        RawToken stringLiteral();
         char peekNextChar() const;
-        std::string processInterpolation();
-        std::string digits();
+        void interpolation();
+        int digits();
+        RawToken number();
 
     public:
-        Lexer(std::string input);
-        Tokens next_tk();
+        Lexer(std::string_view input);
+        RawToken next_tk();
+        // the last token is a piece of a string with holes (after its first segment),
+        // so the lexing can't restart at its offset
+        bool continued() const;
+        // lexes the whole input into the stream (EOF token included)
+        void tokenize(TokenStream &out);
+        // restarts the lexing at offset, it must be the start of a token or of a line
+        void seek(std::size_t offset);
+        // holds the errors on sink instead of the LogErrors, and an unexpected character
+        // ends the lexing (EOF token, halted() is set) instead of the program
+        void deferErrors(std::vector<LexDiagnostic> *sink);
+        bool halted() const;
     };
 } // namespace Rythin
 
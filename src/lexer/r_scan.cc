@@ -0,0 +1,353 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <atomic>
+
+#include "r_scan.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define RHYTHIN_SCAN_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define RHYTHIN_TARGET_AVX2
+    #else
+        #define RHYTHIN_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace Rythin::Scan
+{
+    namespace
+    {
+        // --- scalar ---
+
+        inline bool isSpace(unsigned char c)
+        {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+        inline bool isIdent(unsigned char c)
+        {
+            unsigned char lower = c | 0x20;
+            return (lower >= 'a' && lower <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+        }
+
+        std::size_t whitespaceScalar(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            while (i < n && isSpace(static_cast<unsigned char>(p[i])))
+                i++;
+            return i;
+        }
+
+        std::size_t lineBodyScalar(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            while (i < n && p[i] != '\n' && p[i] != '\0')
+                i++;
+            return i;
+        }
+
+        std::size_t identifierScalar(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            while (i < n && isIdent(static_cast<unsigned char>(p[i])))
+                i++;
+            return i;
+        }
+
+        std::size_t newlinesScalar(const char *p, std::size_t n)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; i++)
+                count += p[i] == '\n';
+            return count;
+        }
+
+        const Kernels scalar_kernels = {whitespaceScalar, lineBodyScalar, identifierScalar, newlinesScalar, {Level::SCALAR, Level::SCALAR, Level::SCALAR, Level::SCALAR}};
+
+#if defined(RHYTHIN_SCAN_X86)
+        inline unsigned firstBit(unsigned mask)
+        {
+    #if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+    #else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+    #endif
+        }
+
+        inline unsigned bitCount(unsigned mask)
+        {
+    #if defined(_MSC_VER) && !defined(__clang__)
+            return static_cast<unsigned>(__popcnt(mask));
+    #else
+            return static_cast<unsigned>(__builtin_popcount(mask));
+    #endif
+        }
+
+        // --- SSE2, 16 bytes per step ---
+        // the compares are signed, so bytes >= 0x80 are negative and never in the ranges below
+
+        inline __m128i spaceMask16(__m128i c)
+        {
+            __m128i space = _mm_cmpeq_epi8(c, _mm_set1_epi8(' '));
+            __m128i ctrl = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('\t' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('\r' + 1)));
+            return _mm_or_si128(space, ctrl);
+        }
+
+        inline __m128i identMask16(__m128i c)
+        {
+            __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+            __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+            __m128i extra = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('_')), _mm_cmpeq_epi8(c, _mm_set1_epi8('-')));
+            return _mm_or_si128(_mm_or_si128(alpha, digit), extra);
+        }
+
+        std::size_t whitespaceSSE2(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                unsigned stop = ~static_cast<unsigned>(_mm_movemask_epi8(spaceMask16(c))) & 0xFFFFu;
+                if (stop != 0)
+                    return i + firstBit(stop);
+            }
+            return i + whitespaceScalar(p + i, n - i);
+        }
+
+        std::size_t lineBodySSE2(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                __m128i end = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(c, _mm_setzero_si128()));
+                unsigned stop = static_cast<unsigned>(_mm_movemask_epi8(end));
+                if (stop != 0)
+                    return i + firstBit(stop);
+            }
+            return i + lineBodyScalar(p + i, n - i);
+        }
+
+        std::size_t identifierSSE2(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                unsigned stop = ~static_cast<unsigned>(_mm_movemask_epi8(identMask16(c))) & 0xFFFFu;
+                if (stop != 0)
+                    return i + firstBit(stop);
+            }
+            return i + identifierScalar(p + i, n - i);
+        }
+
+        std::size_t newlinesSSE2(const char *p, std::size_t n)
+        {
+            std::size_t count = 0;
+            std::size_t i = 0;
+            const __m128i nl = _mm_set1_epi8('\n');
+            for (; i + 16 <= n; i += 16)
+            {
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                count += bitCount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(c, nl))));
+            }
+            return count + newlinesScalar(p + i, n - i);
+        }
+
+        const Kernels sse2_kernels = {whitespaceSSE2, lineBodySSE2, identifierSSE2, newlinesSSE2, {Level::SSE2, Level::SSE2, Level::SSE2, Level::SSE2}};
+
+        // --- AVX2, 32 bytes per step ---
+
+        RHYTHIN_TARGET_AVX2 inline __m256i spaceMask32(__m256i c)
+        {
+            __m256i space = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(' '));
+            __m256i ctrl = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('\t' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), c));
+            return _mm256_or_si256(space, ctrl);
+        }
+
+        RHYTHIN_TARGET_AVX2 inline __m256i identMask32(__m256i c)
+        {
+            __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+            __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+            __m256i extra = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')), _mm256_cmpeq_epi8(c, _mm256_set1_epi8('-')));
+            return _mm256_or_si256(_mm256_or_si256(alpha, digit), extra);
+        }
+
+        RHYTHIN_TARGET_AVX2 std::size_t whitespaceAVX2(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32)
+            {
+                __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                unsigned stop = ~static_cast<unsigned>(_mm256_movemask_epi8(spaceMask32(c)));
+                if (stop != 0)
+                    return i + firstBit(stop);
+            }
+            return i + whitespaceSSE2(p + i, n - i);
+        }
+
+        RHYTHIN_TARGET_AVX2 std::size_t lineBodyAVX2(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32)
+            {
+                __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                __m256i end = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(c, _mm256_setzero_si256()));
+                unsigned stop = static_cast<unsigned>(_mm256_movemask_epi8(end));
+                if (stop != 0)
+                    return i + firstBit(stop);
+            }
+            return i + lineBodySSE2(p + i, n - i);
+        }
+
+        RHYTHIN_TARGET_AVX2 std::size_t identifierAVX2(const char *p, std::size_t n)
+        {
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32)
+            {
+                __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                unsigned stop = ~static_cast<unsigned>(_mm256_movemask_epi8(identMask32(c)));
+                if (stop != 0)
+                    return i + firstBit(stop);
+            }
+            return i + identifierSSE2(p + i, n - i);
+        }
+
+        RHYTHIN_TARGET_AVX2 std::size_t newlinesAVX2(const char *p, std::size_t n)
+        {
+            std::size_t count = 0;
+            std::size_t i = 0;
+            const __m256i nl = _mm256_set1_epi8('\n');
+            for (; i + 32 <= n; i += 32)
+            {
+                __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                count += bitCount(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, nl))));
+            }
+            return count + newlinesSSE2(p + i, n - i);
+        }
+
+        const Kernels avx2_kernels = {whitespaceAVX2, lineBodyAVX2, identifierAVX2, newlinesAVX2, {Level::AVX2, Level::AVX2, Level::AVX2, Level::AVX2}};
+
+        // what an avx2 cpu runs: the runs the lexer skips are short (an indent, a name, a ~70 byte
+        // comment) and the wider loads don't pay for themselves there, sse2 is as fast or faster.
+        // counting the newlines walks the whole source and is ~5x faster with avx2.
+        // (the kernel table of bench_lexer, on one x86-64 machine: run it again when a kernel changes)
+        const Kernels avx2_best_kernels = {whitespaceSSE2, lineBodySSE2, identifierSSE2, newlinesAVX2, {Level::SSE2, Level::SSE2, Level::SSE2, Level::AVX2}};
+
+        bool cpuHasAVX2()
+        {
+    #if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) // the os saves the ymm registers
+                return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+    #else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+    #endif
+        }
+#endif // RHYTHIN_SCAN_X86
+
+        // per kernel the fastest level this cpu has
+        const Kernels &best()
+        {
+#if defined(RHYTHIN_SCAN_X86)
+            if (detect() == Level::AVX2)
+                return avx2_best_kernels;
+#endif
+            return kernelsOf(detect());
+        }
+
+        std::atomic<const Kernels *> &current()
+        {
+            static std::atomic<const Kernels *> active{&best()};
+            return active;
+        }
+    }
+
+    Level detect()
+    {
+#if defined(RHYTHIN_SCAN_X86)
+        static const Level best = cpuHasAVX2() ? Level::AVX2 : Level::SSE2;
+        return best;
+#else
+        return Level::SCALAR;
+#endif
+    }
+
+    const Kernels &kernelsOf(Level level)
+    {
+#if defined(RHYTHIN_SCAN_X86)
+        if (level == Level::AVX2)
+            return avx2_kernels;
+        if (level == Level::SSE2)
+            return sse2_kernels;
+#endif
+        return scalar_kernels;
+    }
+
+    const Kernels &kernels()
+    {
+        return *current().load(std::memory_order_relaxed);
+    }
+
+    void force(Level level)
+    {
+        if (static_cast<int>(level) > static_cast<int>(detect()))
+            level = detect();
+        current().store(&kernelsOf(level), std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        current().store(&best(), std::memory_order_relaxed);
+    }
+
+    std::string describe(const Kernels &k)
+    {
+        std::string out;
+        out += std::string("whitespace ") + levelName(k.levels.whitespace);
+        out += std::string(", lineBody ") + levelName(k.levels.lineBody);
+        out += std::string(", identifier ") + levelName(k.levels.identifier);
+        out += std::string(", newlines ") + levelName(k.levels.newlines);
+        return out;
+    }
+
+    const char *levelName(Level level)
+    {
+        switch (level)
+        {
+        case Level::AVX2:
+            return "avx2";
+        case Level::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+        }
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef R_SCAN_HPP
+#define R_SCAN_HPP
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @name byte scanners of the lexer
+ * @brief skip whole runs of whitespace, comment bodies and identifier chars
+ *
+ * The x86 builds have SSE2 (16 bytes per step) and AVX2 (32 bytes per step)
+ * versions. On the first call each kernel takes the level that measured fastest on
+ * this cpu (bench_lexer): an avx2 cpu counts the newlines with avx2 and skips
+ * the short runs with sse2. On that bench the lexer is ~1.5x faster than with the
+ * scalar loops on comment heavy code and about the same on code heavy one, where
+ * the time goes to making the tokens, not to the scanning.
+ * Every other target uses the scalar loops.
+ * All of them take the bytes left on the input and return how many were skipped.
+ **/
+namespace Rythin::Scan
+{
+    enum class Level
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+    };
+
+    struct Kernels
+    {
+        // length of the run of whitespace (isspace on the "C" locale) at p
+        std::size_t (*whitespace)(const char *p, std::size_t n);
+        // length of the comment body at p: everything until '\n' or '\0'
+        std::size_t (*lineBody)(const char *p, std::size_t n);
+        // length of the run of identifier chars ([A-Za-z0-9_-]) at p
+        std::size_t (*identifier)(const char *p, std::size_t n);
+        // number of '\n' on [p, p + n) (sizes the LineIndex table)
+        std::size_t (*newlines)(const char *p, std::size_t n);
+        // the level each one of them runs at
+        struct
+        {
+            Level whitespace, lineBody, identifier, newlines;
+        } levels;
+    };
+
+    // best level of this cpu/build
+    Level detect();
+    // kernels in use (the lexer keeps this reference, so there's no lookup per call)
+    const Kernels &kernels();
+    // forces every kernel to one level (clamped to detect()), used by the benchmarks. affects lexers created after it
+    void force(Level level);
+    // back to the fastest kernels of this cpu
+    void reset();
+    const char *levelName(Level level);
+    // "whitespace sse2, lineBody sse2, ...": the level of each kernel
+    std::string describe(const Kernels &k);
+    // kernels of one level, all of them of that level (the benchmarks time them one by one)
+    const Kernels &kernelsOf(Level level);
+}
+
+#endif // R_SCAN_HPP
@@ -0,0 +1,51 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cstring>
+
+#include "../src/includes/line_index.hpp"
+#include "../src/lexer/r_scan.hpp"
+
+namespace Rythin
+{
+    void LineIndex::build() const
+    {
+        // the vector count sizes the table, memchr (vectorized on the libc) finds each '\n'
+        starts.reserve(Scan::kernels().newlines(src.data(), src.size()) + 1);
+        starts.push_back(0);
+        const char *begin = src.data();
+        const char *end = begin + src.size();
+        for (const char *p = begin; p < end;)
+        {
+            const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            if (!nl)
+                break;
+            starts.push_back(static_cast<uint32_t>(nl - begin + 1));
+            p = nl + 1;
+        }
+        built = true;
+    }
+
+    LineColumn LineIndex::locate(std::size_t offset) const
+    {
+        if (!built)
+            build();
+        // last line starting at or before the offset
+        auto it = std::upper_bound(starts.begin(), starts.end(), offset);
+        std::size_t line = static_cast<std::size_t>(it - starts.begin()) - 1;
+        return LineColumn{static_cast<int>(line + 1), static_cast<int>(offset - starts[line])};
+    }
+}
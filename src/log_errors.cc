@@ -28,8 +28,37 @@
 
 namespace Log
 {
+    // where the diagnostics of this thread go while a Hold is alive
+    static thread_local std::vector<LogErrors::Held> *holding = nullptr;
+
+    LogErrors::Hold::Hold(std::vector<Held> &into) : previous(holding)
+    {
+        holding = &into;
+    }
+
+    LogErrors::Hold::~Hold()
+    {
+        holding = previous;
+    }
+
+    void LogErrors::replay(const std::vector<Held> &held)
+    {
+        for (const Held &d : held)
+        {
+            if (d.warning)
+                d.where.index ? addWarning(d.message, d.code, d.where) : addWarning(d.message, d.code, d.line, d.column);
+            else
+                d.where.index ? addError(d.message, d.code, d.where) : addError(d.message, d.code, d.line, d.column);
+        }
+    }
+
     void LogErrors::addError(const std::string &error, int exit_code, int line, int column)
     {
+        if (holding)
+        {
+            holding->push_back(Held{error, exit_code, false, {nullptr, 0}, line, column});
+            return;
+        }
         if (line == 0 && column == 0)
         {
             logs.push_back(ERROR + error);
@@ -44,6 +73,11 @@ namespace Log
 
     void LogErrors::addWarning(const std::string &err, int exit, int line, int column)
     {
+        if (holding)
+        {
+            holding->push_back(Held{err, exit, true, {nullptr, 0}, line, column});
+            return;
+        }
         if (line == 0 && column == 0)
         {
             warns.push_back(WARNING + err);
@@ -55,6 +89,28 @@ namespace Log
         code = exit;
     }
 
+    void LogErrors::addError(const std::string &error, int exit_code, const Rythin::SourceLocation &where)
+    {
+        if (holding)
+        {
+            holding->push_back(Held{error, exit_code, false, where, 0, 0});
+            return;
+        }
+        Rythin::LineColumn at = where.resolve();
+        addError(error, exit_code, at.line, at.column);
+    }
+
+    void LogErrors::addWarning(const std::string &err, int exit, const Rythin::SourceLocation &where)
+    {
+        if (holding)
+        {
+            holding->push_back(Held{err, exit, true, where, 0, 0});
+            return;
+        }
+        Rythin::LineColumn at = where.resolve();
+        addWarning(err, exit, at.line, at.column);
+    }
+
     bool LogErrors::hasErrorsAndWarns()
     {
         return !logs.empty() || !warns.empty();
@@ -81,6 +137,15 @@ namespace Log
 
     void LogErrors::printAll()
     {
+        // printed while they're held (a fatal error exits right after): the held ones go to the log first
+        if (holding)
+        {
+            std::vector<Held> *held = holding;
+            holding = nullptr;
+            replay(*held);
+            held->clear();
+            holding = held;
+        }
         printWarnings();
         printErrors();
     }
@@ -0,0 +1,138 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "../../src/parser/parallel_parse.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace Log;
+
+namespace Rythin
+{
+    ParallelParser::ParallelParser(const TokenStream &tokens, AstArena &arena, unsigned threads)
+        : tokens(tokens), arena(arena), workers(threads), splits(0), serial_from(tokens.size())
+    {
+        if (workers == 0)
+            workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<int> ParallelParser::split() const
+    {
+        // a few chunks per thread, so a slow chunk doesn't leave the others idle
+        std::size_t size = tokens.size();
+        std::size_t count = std::max<std::size_t>(1, std::min<std::size_t>(workers * 4, size / min_chunk));
+        std::size_t target = size / count;
+
+        std::vector<int> starts{0};
+        std::size_t next_cut = target;
+        int depth = 0;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            switch (tokens.type(i))
+            {
+            case TokensTypes::TOKEN_LBRACKET:
+            case TokensTypes::TOKEN_LPAREN:
+                depth++;
+                break;
+            case TokensTypes::TOKEN_RBRACKET:
+            case TokensTypes::TOKEN_RPAREN:
+                if (--depth < 0)
+                    return {0}; // unbalanced, the cuts can't be trusted
+                break;
+            case TokensTypes::TOKEN_DEF:
+                if (depth == 0 && i >= next_cut && starts.size() < count)
+                {
+                    starts.push_back(static_cast<int>(i));
+                    next_cut = i + target;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        if (depth != 0)
+            return {0};
+        return starts;
+    }
+
+    void ParallelParser::parseChunk(Chunk &chunk) const
+    {
+        LogErrors::Hold hold(chunk.diagnostics);
+        Parser parser(tokens, chunk.arena, chunk.begin, chunk.end, true);
+        parser.deferBodies(lazy);
+        parser.maxDepth(max_depth);
+        chunk.items = parser.Parse();
+        chunk.failed = std::any_of(chunk.diagnostics.begin(), chunk.diagnostics.end(),
+                                   [](const LogErrors::Held &d) { return !d.warning; });
+    }
+
+    std::vector<ASTPtr> ParallelParser::Parse()
+    {
+        std::vector<int> starts = split();
+        splits = starts.size();
+        serial_from = tokens.size();
+        if (workers <= 1 || starts.size() <= 1)
+        {
+            serial_from = 0;
+            Parser parser(tokens, arena);
+            parser.deferBodies(lazy);
+            parser.maxDepth(max_depth);
+            return parser.Parse();
+        }
+
+        std::vector<Chunk> pieces(starts.size());
+        for (std::size_t i = 0; i < pieces.size(); i++)
+        {
+            pieces[i].begin = starts[i];
+            pieces[i].end = (i + 1 < starts.size()) ? starts[i + 1] : static_cast<int>(tokens.size());
+        }
+
+        // the threads take the next chunk not parsed yet, the calling thread is one of them
+        std::atomic<std::size_t> next_chunk{0};
+        auto work = [&] {
+            for (std::size_t i = next_chunk++; i < pieces.size(); i = next_chunk++)
+                parseChunk(pieces[i]);
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        for (unsigned t = 1; t < workers && t < pieces.size(); t++)
+            pool.emplace_back(work);
+        work();
+        for (std::thread &t : pool)
+            t.join();
+
+        std::vector<ASTPtr> items;
+        for (Chunk &chunk : pieces)
+        {
+            if (chunk.failed)
+            {
+                // the chunks before ended their last item right at the cut, like the serial parser did
+                serial_from = static_cast<std::size_t>(chunk.begin);
+                Parser parser(tokens, arena, chunk.begin, static_cast<int>(tokens.size()), false);
+                parser.deferBodies(lazy);
+                parser.maxDepth(max_depth);
+                std::vector<ASTPtr> rest = parser.Parse();
+                items.insert(items.end(), rest.begin(), rest.end());
+                break;
+            }
+            LogErrors::getInstance().replay(chunk.diagnostics);
+            items.insert(items.end(), chunk.items.begin(), chunk.items.end());
+            arena.adopt(chunk.arena);
+        }
+        return items;
+    }
+}
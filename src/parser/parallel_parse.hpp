@@ -0,0 +1,86 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PARALLEL_PARSE_HPP
+#define PARALLEL_PARSE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "../../src/includes/ast_arena.hpp"
+#include "../../src/includes/log.hpp"
+#include "../../src/tokens/token_stream.hpp"
+#include "../../src/parser/r_parser.hpp"
+
+namespace Rythin
+{
+    /**
+     * @brief parses the top level items of a big token stream on several threads
+     *
+     * A pre-scan of the token types cuts the stream in chunks at the 'def' tokens
+     * out of any bracket or parenthesis, and every chunk is parsed by its own Parser
+     * on its own arena. The items are spliced in source order and the arenas are
+     * handed to the arena of the unit.
+     * The diagnostics of the chunks are held back and logged in chunk order. A chunk
+     * with an error may have recovered differently from the serial parser (which
+     * could have gone past the cut), so from the first one on the stream is parsed
+     * again serially: the items and the log are always the ones of Parser::Parse.
+     **/
+    class ParallelParser
+    {
+    public:
+        // below this many tokens per chunk the threads don't pay off
+        static constexpr std::size_t min_chunk = 16 * 1024;
+
+        // threads = 0 takes one per core
+        ParallelParser(const TokenStream &tokens, AstArena &arena, unsigned threads);
+
+        std::vector<ASTPtr> Parse();
+        // see Parser::deferBodies
+        void deferBodies(bool on) { lazy = on; }
+        // see Parser::maxDepth
+        void maxDepth(std::size_t depth) { max_depth = depth; }
+
+        unsigned threads() const { return workers; }
+        // chunks of the last Parse, and the token the serial parsing took over from (or the stream size)
+        std::size_t chunks() const { return splits; }
+        std::size_t reparsedFrom() const { return serial_from; }
+
+    private:
+        struct Chunk
+        {
+            int begin = 0;
+            int end = 0;
+            AstArena arena;
+            std::vector<ASTPtr> items;
+            std::vector<Log::LogErrors::Held> diagnostics;
+            bool failed = false; // an error was reported
+        };
+
+        // starts of the chunks, the first is 0
+        std::vector<int> split() const;
+        void parseChunk(Chunk &chunk) const;
+
+        const TokenStream &tokens;
+        AstArena &arena;
+        unsigned workers;
+        std::size_t splits;
+        std::size_t serial_from;
+        bool lazy = false;
+        std::size_t max_depth = Parser::default_max_depth;
+    };
+}
+
+#endif // PARALLEL_PARSE_HPP
@@ -1,33 +1,96 @@
-#include <memory>
+#include <iostream>
+#include <string>
+#include <string_view>
 #include <vector>
 // local
 #include "r_parser.hpp"
 #include "../includes/ast.hpp"
-#include "../lexer/lex_types.hpp"
+#include "../includes/ast_arena.hpp"
+#include "../includes/log.hpp"
+#include "../lexer/r_lex.hpp"
 #include "../tokens/t_tokens.hpp"
+#include "../tokens/token_stream.hpp"
 
-using namespace std;
+using namespace Rythin;
 
-namespace Rythin
+// parses the code and checks the kinds of the top level items
+static bool parses(const char *what, std::string_view code, const std::vector<NodeKind> &kinds)
 {
-    vector<Tokens> nodes;
-    int main()
+    TokenStream tokens(code);
+    Lexer(code).tokenize(tokens);
+
+    AstArena arena;
+    Parser p(tokens, arena);
+    std::vector<ASTPtr> nodes = p.Parse();
+
+    bool ok = nodes.size() == kinds.size();
+    for (std::size_t i = 0; ok && i < nodes.size(); i++)
+        ok = nodes[i] && nodes[i]->kind == kinds[i];
+    std::cout << (ok ? "[ok]   " : "[fail] ") << what << std::endl;
+    return ok;
+}
+
+// an expression with every operator in parentheses, as the parser grouped it
+static std::string grouped(ASTPtr node)
+{
+    if (auto op = nodeAs<BinOp>(node))
+        return "(" + grouped(op->left) + " " + Tokens::tokenTypeToString(op->op) + " " + grouped(op->right) + ")";
+    if (auto op = nodeAs<UnaryOp>(node))
+        return "(" + Tokens::tokenTypeToString(op->op) + grouped(op->operand) + ")";
+    if (auto num = nodeAs<i32Node>(node))
+        return std::to_string(num->val);
+    if (auto var = nodeAs<VariableNode>(node))
+        return Interner::getInstance().str(var->name);
+    return "?";
+}
+
+// parses the expression as the value of a definition and checks how it was grouped
+static bool groups(const char *what, const std::string &expression, const std::string &expected)
+{
+    std::string code = "def v:int32 := " + expression + "\n";
+    TokenStream tokens(code);
+    Lexer(code).tokenize(tokens);
+
+    AstArena arena;
+    Parser p(tokens, arena);
+    std::vector<ASTPtr> nodes = p.Parse();
+
+    auto def = nodes.size() == 1 ? nodeAs<VariableDefinitionNode>(nodes[0]) : nullptr;
+    std::string got = def ? grouped(def->val) : "no definition";
+    bool ok = got == expected;
+    std::cout << (ok ? "[ok]   " : "[fail] ") << what;
+    if (!ok)
+        std::cout << ": " << got << " (expected " << expected << ")";
+    std::cout << std::endl;
+    return ok;
+}
+
+int main()
+{
+    int failed = 0;
+    // tests the variable definition
+    failed += !parses("variable definition", "def var_name:int32 := 23\n", {NodeKind::VARIABLE_DEFINITION});
+    failed += !parses("expression", "def v:int32 := (1 + 2) * -3 / 4\n", {NodeKind::VARIABLE_DEFINITION});
+    failed += !parses("function", "def main:func(a:int32) -> [\n    printnl(\"a is $[a]\")\n]\n", {NodeKind::FUNCTION_DEFINITION});
+    failed += !parses("if and loops",
+                      "if (true) -> [ print(\"x\") ]\n"
+                      "loop (i:int32 in 3) -> [ print(i) ]\n"
+                      "loop (true) -> [ print(\"z\") ]\n",
+                      {NodeKind::IF_STATEMENT, NodeKind::LOOP, NodeKind::LOOP_CONDITION});
+
+    // precedence and associativity of the binary operators
+    failed += !groups("left associative", "10 - 4 - 3", "((10 - 4) - 3)");
+    failed += !groups("left associative division", "64 / 8 / 2", "((64 / 8) / 2)");
+    failed += !groups("product before sum", "1 + 2 * 3 - 4", "((1 + (2 * 3)) - 4)");
+    failed += !groups("sum before shift", "1 << 2 + 1", "(1 << (2 + 1))");
+    failed += !groups("shift before bitwise", "a & 1 << 2 | b ^ 3", "((a & (1 << 2)) | (b ^ 3))");
+    failed += !groups("parentheses", "(1 + 2) * (3 - a)", "((1 + 2) * (3 - a))");
+    failed += !groups("prefix operators", "-a * ~2 - -3", "(((-a) * (~2)) - (-3))");
+
+    if (Log::LogErrors::getInstance().getErrSize() != 0)
     {
-        // tests the variable definition
-        {
-            nodes.push_back(Tokens(TokensTypes::TOKEN_DEF, "def", 1, 3));
-            nodes.push_back(Tokens(TokensTypes::TOKEN_IDENTIFIER, "var_name", 1, 5));
-            nodes.push_back(Tokens(Tokens(TokensTypes::TOKEN_COLON, ":", 1, 7)));
-            nodes.push_back(Tokens(TokensTypes::TOKEN_INT_32, "int32", 1, 9));
-            nodes.push_back(Tokens(TokensTypes::TOKEN_ASSIGN, ":=", 1, 11));
-            nodes.push_back(Tokens(TokensTypes::TOKEN_INT_32, "23", 1, 15));
-            nodes.push_back(Tokens(TokensTypes::TOKEN_EOF, "\0", 2, 0));
-
-            // parse it now
-            Parser p(nodes);
-            p.Parse();
-        }
-
-        return 0;
+        Log::LogErrors::getInstance().printAll();
+        failed++;
     }
-}
\ No newline at end of file
+    return failed != 0;
+}
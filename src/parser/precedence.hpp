@@ -0,0 +1,88 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PRECEDENCE_HPP
+#define PRECEDENCE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../src/lexer/keywords.hpp"
+#include "../../src/lexer/lex_types.hpp"
+
+namespace Rythin::Precedence
+{
+    struct Operator
+    {
+        TokensTypes type;
+        uint8_t power;      // how tight it binds, 0 is not a binary operator
+        bool right = false; // right associative (a op b op c is a op (b op c))
+    };
+
+    // the binary operators of the expressions, from the loosest to the tightest (the C order).
+    // a single '&' is lexed as TOKEN_REF, after an operand it is the bitwise and
+    inline constexpr Operator list[] = {
+        {TokensTypes::TOKEN_LOGICAL_OR, 1},
+        {TokensTypes::TOKEN_LOGICAL_AND, 2},
+        {TokensTypes::TOKEN_BIT_OR, 3},
+        {TokensTypes::TOKEN_BIT_XOR, 4},
+        {TokensTypes::TOKEN_REF, 5},
+        {TokensTypes::TOKEN_EQUAL, 6},
+        {TokensTypes::TOKEN_NOT_EQUAL, 6},
+        {TokensTypes::TOKEN_LESS_THAN, 7},
+        {TokensTypes::TOKEN_LESS_EQUAL, 7},
+        {TokensTypes::TOKEN_GREATER_THAN, 7},
+        {TokensTypes::TOKEN_GREATER_EQUAL, 7},
+        {TokensTypes::TOKEN_SHIFT_LEFT, 8},
+        {TokensTypes::TOKEN_SHIFT_RIGHT, 8},
+        {TokensTypes::TOKEN_PLUS, 9},
+        {TokensTypes::TOKEN_MINUS, 9},
+        {TokensTypes::TOKEN_MULTIPLY, 10},
+        {TokensTypes::TOKEN_DIVIDE, 10},
+        {TokensTypes::TOKEN_MODULO, 10},
+    };
+
+    // prefix operators bind tighter than any binary one
+    inline constexpr uint8_t prefix_power = 11;
+
+    constexpr std::array<Operator, Keywords::type_count> buildTable()
+    {
+        std::array<Operator, Keywords::type_count> table{};
+        for (std::size_t i = 0; i < table.size(); i++)
+            table[i] = Operator{static_cast<TokensTypes>(i), 0};
+        for (const Operator &op : list)
+            table[static_cast<std::size_t>(op.type)] = op;
+        return table;
+    }
+
+    inline constexpr std::array<Operator, Keywords::type_count> table = buildTable();
+
+    // the entry of the token type, power 0 if it doesn't continue an expression
+    constexpr const Operator &binary(TokensTypes type)
+    {
+        return table[static_cast<std::size_t>(type)];
+    }
+
+    constexpr bool isPrefix(TokensTypes type)
+    {
+        return type == TokensTypes::TOKEN_MINUS || type == TokensTypes::TOKEN_PLUS || type == TokensTypes::TOKEN_BIT_NOT;
+    }
+
+    static_assert(binary(TokensTypes::TOKEN_MULTIPLY).power > binary(TokensTypes::TOKEN_PLUS).power);
+    static_assert(binary(TokensTypes::TOKEN_RPAREN).power == 0);
+}
+
+#endif // PRECEDENCE_HPP
@@ -13,6 +13,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <string>
@@ -33,91 +34,124 @@ using namespace Log;
 namespace Rythin
 {
 
-    Tokens Parser::current()
+    TokenView Parser::tokenAt(int index)
     {
-        if (position >= 0 && position < tokens.size())
+        if (window)
         {
-            return tokens[position];
+            // the window lexes up to the index and gives the EOF token past the end
+            return window->at(static_cast<std::size_t>(index >= 0 ? index : position));
+        }
+        if (index >= 0 && index < limit)
+        {
+            return tokens->at(index);
         }
         // If position is out of bounds, return EOF (End Of File) token.
         // This ensures the parser doesn't crash on out-of-bounds access.
         // It's crucial for error recovery to always return a valid token type,
         // even if it's an EOF when past the end.
-        return tokens[tokens.size() - 1];
+        return tokens->at(tokens->size() - 1);
+    }
+
+    Symbol Parser::nameOf(const TokenView &tk)
+    {
+        if (tk.type == TokensTypes::TOKEN_IDENTIFIER)
+            return tk.symbol;
+        // consume() gave back another token (error recovery), its text is the name like before.
+        // a concurrent parser already logged the error and its range is parsed again serially
+        if (concurrent)
+            return Interner::empty;
+        return Interner::getInstance().intern(tk.value);
+    }
+
+    std::string_view Parser::code(int first, int last) const
+    {
+        if (!tokens || first < 0 || last < first)
+            return {};
+        return tokens->text(static_cast<std::size_t>(first), static_cast<std::size_t>(std::min(last, limit - 1)));
+    }
+
+    TokenView Parser::current()
+    {
+        return tokenAt(position);
     }
 
     // Peeks at a token relative to the current position without consuming it.
     // Useful for lookahead decisions.
-    Tokens Parser::peek(int offset)
+    TokenView Parser::peek(int offset)
     {
-        int peek_pos = position + offset;
-        if (peek_pos >= 0 && peek_pos < tokens.size())
-        {
-            return tokens[peek_pos];
-        }
         // Return EOF if peeking beyond the file
-        return tokens[tokens.size() - 1];
+        return tokenAt(position + offset);
     }
 
-    Tokens Parser::consume(TokensTypes tk)
+    TokenView Parser::consume(TokensTypes tk)
     {
-        codes.push_back(current().value);
-
         if (current().type == TokensTypes::TOKEN_EOF)
         {
             // If EOF is reached unexpectedly, add an error but allow parsing to continue
             // (e.g., if it's the end of a block that should have been closed).
             // The main Parse() loop will eventually stop on EOF.
-            LogErrors::getInstance().addError("Expected a statement but reached the end of file and left early.... Are you forget anything?", 1, current().line, current().column);
+            LogErrors::getInstance().addError("Expected a statement but reached the end of file and left early.... Are you forget anything?", 1, current().where);
             // Do NOT exit here to allow error progression.
-            return Tokens{TokensTypes::TOKEN_EOF, "", current().line, current().column}; // Return EOF token
+            return TokenView{TokensTypes::TOKEN_EOF, {}, current().where}; // Return EOF token
         }
 
         if (current().type != tk)
         {
             // If the current type doesn't match the expected token, add an error.
             // Do NOT exit here to allow error progression.
-            LogErrors::getInstance().addError("Expected " + Tokens::tokenTypeToString(tk) + " token but got: " + Tokens::tokenTypeToString(current().type), 4, current().line, current().column);
+            LogErrors::getInstance().addError("Expected " + Tokens::tokenTypeToString(tk) + " token but got: " + Tokens::tokenTypeToString(current().type), 4, current().where);
             // Try to advance the parser to potentially recover from the error.
             // This is a simple recovery strategy; more advanced parsers might skip tokens.
             position++;
-            return tokens[position - 1]; // Return the consumed (but incorrect) token
+            return tokenAt(position - 1); // Return the consumed (but incorrect) token
         }
 
         position++;
-        return tokens[position - 1];
+        return tokenAt(position - 1);
     }
 
-    std::vector<ASTPtr> Parser::Parse()
+    // next top level item, nullptr once the tokens are over
+    ASTPtr Parser::ParseTopLevel()
     {
-
-        std::vector<ASTPtr> node;
         while (current().type != TokensTypes::TOKEN_EOF)
         {
             ASTPtr declaration = ParseDeclarations();
             if (declaration) // Only add if parsing was successful (not nullptr due to error)
             {
-                node.push_back(declaration);
+                return declaration;
             }
-            else
+            // Error occurred in ParseDeclarations, try to recover and continue
+            // Simple recovery: if it's not EOF, advance past the current token
+            // to avoid infinite loops on unhandled tokens.
+            if (current().type != TokensTypes::TOKEN_EOF)
             {
-                // Error occurred in ParseDeclarations, try to recover and continue
-                // Simple recovery: if it's not EOF, advance past the current token
-                // to avoid infinite loops on unhandled tokens.
-                if (current().type != TokensTypes::TOKEN_EOF)
-                {
-                    position++;
-                }
-                else
-                {
-                    // If EOF is reached, break the loop
-                    break;
-                }
+                position++;
             }
         }
+        return nullptr;
+    }
+
+    std::vector<ASTPtr> Parser::Parse()
+    {
+
+        std::vector<ASTPtr> node;
+        while (ASTPtr declaration = ParseTopLevel())
+        {
+            node.push_back(declaration);
+        }
         return node;
     }
 
+    void Parser::Parse(FlatAst &out)
+    {
+        lazy = false; // the records have no place for the range of a body
+        while (ASTPtr declaration = ParseTopLevel())
+        {
+            out.append(declaration);
+            arena.clear();
+        }
+    }
+
     // look the if current type is the expected token
     bool Parser::check(TokensTypes tk)
     {
@@ -151,53 +185,43 @@ namespace Rythin
 
     ASTPtr Parser::ParseDeclarations()
     {
+        std::size_t base = open.size();
+        ASTPtr statement = ParseStatement();
+        if (open.size() == base)
+            return statement;
+        return ParseOpenBlocks(base); // the statement is done when its blocks are
+    }
+
+    ASTPtr Parser::ParseStatement()
+    {
+        // the statements only peek ahead, they never go back before their start
+        if (window)
+            window->keepFrom(position);
         switch (current().type)
         {
         case TokensTypes::TOKEN_CINPUT:
             return ParseCinput();
         case TokensTypes::TOKEN_IF:
-            return ParseIfStatement();
+            return openWith(ParseIfStatement(), OpenBlock::IF);
         case TokensTypes::TOKEN_LOOP:
-        {
-            // Resolving loop ambiguity:
-            // Loop can be `loop (condition) ->` or `loop (var:type in value) ->`.
-            // We need to look ahead after `loop (` to differentiate.
-            // Consume LOOP and LPAREN first, then peek to decide.
-            int start_pos = position; // Save position to restore if needed
-            // Temporarily consume TOKEN_LOOP and TOKEN_LPAREN to inspect what follows.
-            // This consume operation might add an error if the token is not as expected,
-            // but the error is logged and parsing continues.
-            Tokens loop_token = consume(TokensTypes::TOKEN_LOOP);
-            if (loop_token.type != TokensTypes::TOKEN_LOOP)
-            {                         // Check if consume failed
-                position = start_pos; // Restore position if consume failed for initial token
-                return nullptr;
-            }
-            Tokens lparen_token = consume(TokensTypes::TOKEN_LPAREN);
-            if (lparen_token.type != TokensTypes::TOKEN_LPAREN)
-            {                         // Check if consume failed
-                position = start_pos; // Restore position if consume failed
-                return nullptr;
-            }
-
-            // Check if it's a loop expression (e.g., `var:type in value`)
-            // This means we expect an IDENTIFIER, then a COLON, then a TYPE, then 'in'.
-            // Ensure proper token types are checked for types (INT_32, INT_64, FLOAT_32, FLOAT_64).
-            if (check(TokensTypes::TOKEN_IDENTIFIER) &&
-                peek(1).type == TokensTypes::TOKEN_COLON &&
-                (peek(2).type == TokensTypes::TOKEN_INT_32 || peek(2).type == TokensTypes::TOKEN_INT_64 ||
-                 peek(2).type == TokensTypes::TOKEN_FLOAT_32 || peek(2).type == TokensTypes::TOKEN_FLOAT_64) &&
-                peek(3).type == TokensTypes::TOKEN_IN)
+            // Loop can be `loop (var:type in value) ->` or `loop (condition) ->`,
+            // a fixed peek past `loop (` tells them apart without consuming anything
+            if (peek(1).type != TokensTypes::TOKEN_LPAREN)
             {
-                position = start_pos; // Restore position, ParseLoopExpression will consume from TOKEN_LOOP
-                return ParseLoopExpression();
+                // no condition at all: report it and leave the next statement to the caller
+                consume(TokensTypes::TOKEN_LOOP);
+                LogErrors::getInstance().addError("Expected " + Tokens::tokenTypeToString(TokensTypes::TOKEN_LPAREN) + " token but got: " + Tokens::tokenTypeToString(current().type), 4, current().where);
+                return nullptr;
             }
-            else
+            if (peek(2).type == TokensTypes::TOKEN_IDENTIFIER &&
+                peek(3).type == TokensTypes::TOKEN_COLON &&
+                (peek(4).type == TokensTypes::TOKEN_INT_32 || peek(4).type == TokensTypes::TOKEN_INT_64 ||
+                 peek(4).type == TokensTypes::TOKEN_FLOAT_32 || peek(4).type == TokensTypes::TOKEN_FLOAT_64) &&
+                peek(5).type == TokensTypes::TOKEN_IN)
             {
-                position = start_pos; // Restore position, ParseLoopCond will consume from TOKEN_LOOP
-                return ParseLoopCond();
+                return openWith(ParseLoopExpression(), OpenBlock::LOOP);
             }
-        }
+            return openWith(ParseLoopCond(), OpenBlock::LOOP_COND);
 
         case TokensTypes::TOKEN_PRINT:
             return ParsePrint();
@@ -206,45 +230,43 @@ namespace Rythin
         case TokensTypes::TOKEN_PRINT_NEW_LINE:
             return ParsePrintNl();
         case TokensTypes::TOKEN_STRING_LITERAL: // This case just consumes and returns nullptr, which might not be intended for a top-level declaration.
-            consume(TokensTypes::TOKEN_STRING_LITERAL);
+        {
+            FormatPlan unused;
+            ParseStringLiteral(unused);
             // error only for test
-            // LogErrors::getInstance().addError("Unexpected string literal at top-level. Expected a statement.", 2, current().line, current().column);
+            // LogErrors::getInstance().addError("Unexpected string literal at top-level. Expected a statement.", 2, current().where);
             return nullptr; // Return nullptr for error progression
+        }
         case TokensTypes::TOKEN_DEF:
         {
-            // stores the current position on another int
-            int pos = position;
-            // Advance until '=' or '(' is found, or EOF, to determine if it's a variable or function declaration.
-            // This consume loop should not add errors for simply advancing. Errors are added by final checks.
-            while (!check(TokensTypes::TOKEN_ASSIGN) && !check(TokensTypes::TOKEN_LPAREN) && current().type != TokensTypes::TOKEN_EOF)
+            // `def name:type := value` or `def name:func(args) -> [...]`: the token after
+            // the type decides, so nothing is scanned ahead and nothing is parsed twice
+            TokensTypes after_type = peek(4).type;
+            if (after_type == TokensTypes::TOKEN_LPAREN)
             {
-                position++; // Simply advance, don't use consume() to avoid adding errors in this lookahead
+                ASTPtr func = ParseFuncDeclaration();
+                if (func && static_cast<FunctionDefinitionNode *>(func)->deferred())
+                    return func; // the body was skipped, there's no block to open
+                return openWith(func, OpenBlock::FUNCTION);
             }
-
-            if (check(TokensTypes::TOKEN_ASSIGN))
-            {
-                // sets the position to the old position - controlled backtracking
-                position = pos;
+            if (after_type == TokensTypes::TOKEN_ASSIGN)
                 return ParseVarDeclaration();
-            }
-            else if (check(TokensTypes::TOKEN_LPAREN))
-            {
-                // sets the position to the old position again - controlled backtracking
-                position = pos;
-                return ParseFuncDeclaration();
-            }
-            else // If EOF reached without finding '=' or '('
+            for (int k = 1; k <= 4; k++)
             {
-                LogErrors::getInstance().addError("Unexpected EOF while parsing 'def' declaration. Missing '=' or '('?", 1, current().line, current().column);
-                position = pos; // Restore position for better error context if needed, or simply return nullptr
-                return nullptr; // Return nullptr for error progression
+                if (peek(k).type == TokensTypes::TOKEN_EOF)
+                {
+                    LogErrors::getInstance().addError("Unexpected EOF while parsing 'def' declaration. Missing '=' or '('?", 1, peek(k).where);
+                    return nullptr; // Return nullptr for error progression
+                }
             }
+            // a malformed variable declaration, its consumes say what is missing
+            return ParseVarDeclaration();
         }
 
         default:
             // if the current type don't have the valid statements keywords,
             // throw a compilation exception
-            LogErrors::getInstance().addError("Invalid statement/keyword '" + Tokens::tokenTypeToString(current().type) + "'", 2, current().line, current().column);
+            LogErrors::getInstance().addError("Invalid statement/keyword '" + Tokens::tokenTypeToString(current().type) + "'", 2, current().where);
             return nullptr; // Return nullptr for error progression
         }
     }
@@ -254,8 +276,8 @@ namespace Rythin
         // Check for nullptr returns from consume to ensure tokens are valid
         if (consume(TokensTypes::TOKEN_DEF).type != TokensTypes::TOKEN_DEF)
             return nullptr;
-        std::string var_name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-        if (var_name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+        Symbol var_name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+        if (var_name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
             return nullptr; // Check if identifier was consumed correctly
         if (consume(TokensTypes::TOKEN_COLON).type != TokensTypes::TOKEN_COLON)
             return nullptr;
@@ -263,14 +285,14 @@ namespace Rythin
         auto type_token = consume(current().type); // Consume the type token
         if (type_token.type == TokensTypes::TOKEN_EOF)
         { // Check if consume failed
-            LogErrors::getInstance().addError("Expected a type token after ':' in function declaration.", 4, current().line, current().column);
+            LogErrors::getInstance().addError("Expected a type token after ':' in function declaration.", 4, current().where);
             return nullptr;
         }
         TokensTypes type = type_token.type;
 
         if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
             return nullptr;
-        std::vector<ASTPtr> args;
+        PendingList args(pending);
 
         while (!check(TokensTypes::TOKEN_RPAREN) && current().type != TokensTypes::TOKEN_EOF) // Added EOF check for robustness
         {
@@ -286,13 +308,13 @@ namespace Rythin
                     return nullptr; // Return if EOF reached during recovery
                 continue;           // Continue loop to try parsing next argument
             }
-            args.push_back(arg);
+            args.push(arg);
             while (check(TokensTypes::TOKEN_COMMA))
             {
                 consume(TokensTypes::TOKEN_COMMA);
                 if (check(TokensTypes::TOKEN_RPAREN))
                 { // Handle trailing comma error
-                    LogErrors::getInstance().addError("Trailing comma in function arguments.", 4, current().line, current().column);
+                    LogErrors::getInstance().addError("Trailing comma in function arguments.", 4, current().where);
                     break; // Exit inner loop, next consume will be RPAREN
                 }
                 ASTPtr next_arg = ParseFuncExpressions();
@@ -306,7 +328,7 @@ namespace Rythin
                         return nullptr;
                     break; // Break inner loop, will check outer loop condition
                 }
-                args.push_back(next_arg);
+                args.push(next_arg);
             }
         }
         if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
@@ -314,107 +336,173 @@ namespace Rythin
         if (consume(TokensTypes::TOKEN_ARROW_SET).type != TokensTypes::TOKEN_ARROW_SET)
             return nullptr;
 
-        auto block = ParseBlock();
-        if (!block)
-            return nullptr; // Error in parsing block
-        return std::make_shared<FunctionDefinitionNode>(var_name, type, args, block);
+        if (lazy && check(TokensTypes::TOKEN_LBRACKET))
+        {
+            // only the range of the body, an unclosed one is parsed now to report it
+            int close = matchingBracket(position);
+            if (close >= 0)
+            {
+                auto func = make<FunctionDefinitionNode>(var_name, type, args.take(), nullptr);
+                func->body_begin = static_cast<uint32_t>(position);
+                func->body_end = static_cast<uint32_t>(close) + 1;
+                position = close + 1;
+                return func;
+            }
+        }
+
+        // the block is opened by ParseStatement
+        return make<FunctionDefinitionNode>(var_name, type, args.take(), nullptr);
+    }
+
+    int Parser::matchingBracket(int open)
+    {
+        int depth = 0;
+        for (int i = open; i < limit; i++)
+        {
+            TokensTypes type = tokens->type(static_cast<std::size_t>(i));
+            if (type == TokensTypes::TOKEN_LBRACKET)
+                depth++;
+            else if (type == TokensTypes::TOKEN_RBRACKET && --depth == 0)
+                return i;
+        }
+        return -1;
+    }
+
+    ASTPtr Parser::ParseBody(const TokenStream &tokens, AstArena &arena, const FunctionDefinitionNode &func, std::size_t max_depth)
+    {
+        if (!func.deferred())
+            return func.block;
+        Parser parser(tokens, arena, static_cast<int>(func.body_begin), static_cast<int>(func.body_end), false);
+        parser.maxDepth(max_depth);
+        return parser.ParseBlock();
     }
 
-    // --- Arithmetic Expression Parsing (Resolved Ambiguity & Precedence) ---
+    // --- Expression Parsing (table driven, see precedence.hpp) ---
 
-    // Parses primary expressions: numbers, identifiers, or expressions in parentheses.
+    // Parses the operands: numbers and identifiers. Prefix operators and parentheses
+    // are handled by ParseBinaryExpression, so this never recurses.
     ASTPtr Parser::ParsePrimaryExpression()
     {
         ASTPtr val;
         switch (current().type)
         {
         case TokensTypes::TOKEN_INT_32:
-            val = std::make_shared<i32Node>(std::stoi(consume(TokensTypes::TOKEN_INT_32).value));
+            val = make<i32Node>(static_cast<int32_t>(consume(TokensTypes::TOKEN_INT_32).number.integer));
             break;
         case TokensTypes::TOKEN_INT_64:
-            val = std::make_shared<i64Node>(std::stoll(consume(TokensTypes::TOKEN_INT_64).value));
+            val = make<i64Node>(consume(TokensTypes::TOKEN_INT_64).number.integer);
             break;
         case TokensTypes::TOKEN_FLOAT_32:
-            val = std::make_shared<f32Node>(std::stof(consume(TokensTypes::TOKEN_FLOAT_32).value));
+            val = make<f32Node>(static_cast<float>(consume(TokensTypes::TOKEN_FLOAT_32).number.real));
             break;
         case TokensTypes::TOKEN_FLOAT_64:
-            val = std::make_shared<f64Node>(std::stod(consume(TokensTypes::TOKEN_FLOAT_64).value));
-            break;
-        case TokensTypes::TOKEN_LPAREN: // Handle parenthesized expressions (e.g., (1 + 2) * 3)
-            if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
-                return nullptr;
-            val = ParseAdditiveExpression(); // Recursively parse the expression inside parentheses
-            if (!val)
-                return nullptr; // Error in recursive call
-            if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
-                return nullptr;
+            val = make<f64Node>(consume(TokensTypes::TOKEN_FLOAT_64).number.real);
             break;
         case TokensTypes::TOKEN_IDENTIFIER: // Handle variable calls
             val = ParseVarCall();
             if (!val)
                 return nullptr; // Error in variable call
             break;
-        case TokensTypes::TOKEN_MINUS: // Handle unary minus
-            if (consume(TokensTypes::TOKEN_MINUS).type != TokensTypes::TOKEN_MINUS)
-                return nullptr;
-            val = ParsePrimaryExpression(); // The operand of unary minus
-            if (!val)
-                return nullptr; // Error in operand
-            val = std::make_shared<UnaryOp>(TokensTypes::TOKEN_MINUS, val);
-            break;
-        case TokensTypes::TOKEN_PLUS: // Handle unary plus (optional)
-            if (consume(TokensTypes::TOKEN_PLUS).type != TokensTypes::TOKEN_PLUS)
-                return nullptr;
-            val = ParsePrimaryExpression(); // The operand of unary plus
-            if (!val)
-                return nullptr; // Error in operand
-            val = std::make_shared<UnaryOp>(TokensTypes::TOKEN_PLUS, val);
-            break;
         default:
-            LogErrors::getInstance().addError("Expected a number, identifier, or '(' for expression", 197, current().line, current().column);
+            LogErrors::getInstance().addError("Expected a number, identifier, or '(' for expression", 197, current().where);
             return nullptr; // Return nullptr for error progression
         }
         return val;
     }
 
-    // Parses multiplicative expressions (multiplication, division, modulo, bit_xor)
-    // Uses left-to-right associativity and calls ParsePrimaryExpression for operands.
-    ASTPtr Parser::ParseMultiplicativeExpression()
+    // Operator precedence parsing with explicit stacks (no call per precedence level or per '('),
+    // so the depth of the nesting only grows the vectors. The operators and their binding
+    // power come from Precedence::table.
+    ASTPtr Parser::ParseBinaryExpression()
     {
-        ASTPtr left = ParsePrimaryExpression();
-        if (!left)
-            return nullptr; // Error in left operand
+        // the stacks are shared by every call, each one works above what it found there
+        const std::size_t operand_base = operands.size();
+        const std::size_t operator_base = operators.size();
+        int open = 0; // '(' of this expression still on the operator stack
+        bool ok = true;
+
+        // pops the top operator and replaces its operands by the node
+        auto reduce = [&]()
+        {
+            PendingOp op = operators.back();
+            operators.pop_back();
+            ASTPtr right = operands.back();
+            if (op.form == PendingOp::PREFIX)
+            {
+                operands.back() = make<UnaryOp>(op.type, right);
+                return;
+            }
+            operands.pop_back();
+            operands.back() = make<BinOp>(operands.back(), op.type, right);
+        };
 
-        while (check(TokensTypes::TOKEN_MULTIPLY) || check(TokensTypes::TOKEN_DIVIDE) ||
-               check(TokensTypes::TOKEN_MODULO) || check(TokensTypes::TOKEN_BIT_XOR)) // Added MODULO and BIT_XOR
+        while (true)
         {
-            TokensTypes op = consume(current().type).type; // consume should log error but not exit
-            ASTPtr right = ParsePrimaryExpression();
-            if (!right)
-                return nullptr; // Error in right operand
-            left = std::make_shared<BinOp>(left, op, right);
+            // prefix operators and '(' before the operand
+            while (Precedence::isPrefix(current().type) || check(TokensTypes::TOKEN_LPAREN))
+            {
+                TokensTypes type = consume(current().type).type;
+                if (type == TokensTypes::TOKEN_LPAREN)
+                {
+                    operators.push_back(PendingOp{type, 0, PendingOp::PAREN});
+                    open++;
+                }
+                else
+                {
+                    operators.push_back(PendingOp{type, Precedence::prefix_power, PendingOp::PREFIX});
+                }
+            }
+
+            ASTPtr operand = ParsePrimaryExpression();
+            if (!operand)
+            {
+                ok = false; // Error in operand
+                break;
+            }
+            operands.push_back(operand);
+
+            // a ')' closes one of ours, the others belong to the caller (call args, conditions)
+            while (open > 0 && check(TokensTypes::TOKEN_RPAREN))
+            {
+                consume(TokensTypes::TOKEN_RPAREN);
+                while (operators.back().form != PendingOp::PAREN)
+                    reduce();
+                operators.pop_back();
+                open--;
+            }
+
+            const Precedence::Operator &op = Precedence::binary(current().type);
+            if (op.power == 0)
+                break; // the expression is over
+
+            // the operators that bind at least as tight are done before this one
+            while (operators.size() > operator_base)
+            {
+                const PendingOp &top = operators.back();
+                if (top.form == PendingOp::PAREN || top.power < op.power || (top.power == op.power && op.right))
+                    break;
+                reduce();
+            }
+            consume(current().type);
+            operators.push_back(PendingOp{op.type, op.power, PendingOp::BINARY});
         }
-        return left;
-    }
 
-    // Parses additive expressions (addition, subtraction)
-    // Uses left-to-right associativity and calls ParseMultiplicativeExpression for operands,
-    // ensuring correct operator precedence.
-    ASTPtr Parser::ParseAdditiveExpression()
-    {
-        ASTPtr left = ParseMultiplicativeExpression();
-        if (!left)
-            return nullptr; // Error in left operand
+        if (ok && open > 0)
+        {
+            consume(TokensTypes::TOKEN_RPAREN); // logs the missing ')'
+            ok = false;
+        }
 
-        while (check(TokensTypes::TOKEN_PLUS) || check(TokensTypes::TOKEN_MINUS))
+        ASTPtr result = nullptr;
+        if (ok)
         {
-            TokensTypes op = consume(current().type).type; // consume should log error but not exit
-            ASTPtr right = ParseMultiplicativeExpression();
-            if (!right)
-                return nullptr; // Error in right operand
-            left = std::make_shared<BinOp>(left, op, right);
+            while (operators.size() > operator_base)
+                reduce();
+            result = operands.back();
         }
-        return left;
+        operands.resize(operand_base);
+        operators.resize(operator_base);
+        return result;
     }
 
     // Renamed from ParseIntVal to reflect its new role as the entry point for
@@ -422,7 +510,7 @@ namespace Rythin
     // This function will now correctly parse chained operations and operator precedence.
     ASTPtr Parser::ParseIntVal()
     {
-        return ParseAdditiveExpression();
+        return ParseBinaryExpression();
     }
     // --- End Arithmetic Expression Parsing ---
 
@@ -432,19 +520,19 @@ namespace Rythin
         switch (current().type)
         {
         case TokensTypes::TOKEN_INT_32:
-            val = std::make_shared<i32Node>(std::stoi(consume(TokensTypes::TOKEN_INT_32).value));
+            val = make<i32Node>(static_cast<int32_t>(consume(TokensTypes::TOKEN_INT_32).number.integer));
             break;
         case TokensTypes::TOKEN_INT_64:
-            val = std::make_shared<i64Node>(std::stoll(consume(TokensTypes::TOKEN_INT_64).value));
+            val = make<i64Node>(consume(TokensTypes::TOKEN_INT_64).number.integer);
             break;
         case TokensTypes::TOKEN_FLOAT_32:
-            val = std::make_shared<f32Node>(std::stof(consume(TokensTypes::TOKEN_FLOAT_32).value));
+            val = make<f32Node>(static_cast<float>(consume(TokensTypes::TOKEN_FLOAT_32).number.real));
             break;
         case TokensTypes::TOKEN_FLOAT_64:
-            val = std::make_shared<f64Node>(std::stod(consume(TokensTypes::TOKEN_FLOAT_64).value));
+            val = make<f64Node>(consume(TokensTypes::TOKEN_FLOAT_64).number.real);
             break;
         default: // Added default case to catch non-numeral tokens
-            LogErrors::getInstance().addError("Expected a numeral literal (int32, float32, etc.)", 198, current().line, current().column);
+            LogErrors::getInstance().addError("Expected a numeral literal (int32, float32, etc.)", 198, current().where);
             // Removed LogErrors::getInstance().printAll(); and exit(198);
             return nullptr; // Return nullptr for error progression
         }
@@ -468,51 +556,43 @@ namespace Rythin
         if (consume(TokensTypes::TOKEN_ARROW_SET).type != TokensTypes::TOKEN_ARROW_SET)
             return nullptr;
 
-        auto ifBranch = ParseBlock(); // if body (ParseBlock handles brackets)
-        if (!ifBranch)
-            return nullptr; // Error in if branch parsing
-
-        ASTPtr butBranch = nullptr;
-        ASTPtr butCondition = nullptr;
+        // the if body is opened by ParseStatement, and the 'but' is parsed when it closes (closeBlock)
+        return make<IfStatement>(condition, nullptr, nullptr, nullptr);
+    }
 
-        if (check(TokensTypes::TOKEN_BUT))
+    bool Parser::ParseButHeader(IfStatement &node)
+    {
+        if (consume(TokensTypes::TOKEN_BUT).type != TokensTypes::TOKEN_BUT)
+            return false;
+        if (check(TokensTypes::TOKEN_LPAREN))
         {
-            if (consume(TokensTypes::TOKEN_BUT).type != TokensTypes::TOKEN_BUT)
-                return nullptr;
-            if (check(TokensTypes::TOKEN_LPAREN))
+            if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
+                return false;
+            if (!check(TokensTypes::TOKEN_RPAREN)) // Check if not immediately closing
             {
-                if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
-                    return nullptr;
-                if (!check(TokensTypes::TOKEN_RPAREN)) // Check if not immediately closing
-                {
-                    butCondition = ParseIfExpressions();
-                    if (!butCondition)
-                        return nullptr; // Error in but condition parsing
-                }
-                if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
-                    return nullptr;
+                node.butCondition = ParseIfExpressions();
+                if (!node.butCondition)
+                    return false; // Error in but condition parsing
             }
-            if (consume(TokensTypes::TOKEN_ARROW_SET).type != TokensTypes::TOKEN_ARROW_SET)
-                return nullptr;
-            if (consume(TokensTypes::TOKEN_LBRACKET).type != TokensTypes::TOKEN_LBRACKET)
-                return nullptr;       // ParseBlock already consumes LBRACKET, so this is redundant or indicative of a parse error. Keeping for now based on your previous code logic.
-            butBranch = ParseBlock(); // 'but' body (ParseBlock handles brackets)
-            if (!butBranch)
-                return nullptr; // Error in but branch parsing
+            if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
+                return false;
         }
-
-        return std::make_shared<IfStatement>(condition, ifBranch, butBranch, butCondition);
+        if (consume(TokensTypes::TOKEN_ARROW_SET).type != TokensTypes::TOKEN_ARROW_SET)
+            return false;
+        if (consume(TokensTypes::TOKEN_LBRACKET).type != TokensTypes::TOKEN_LBRACKET)
+            return false; // openBlock consumes LBRACKET too, so this is redundant or indicative of a parse error. Keeping for now based on your previous code logic.
+        return true;
     }
 
     ASTPtr Parser::ParseIfExpressions()
     {
-        auto exp_node = std::make_shared<IfExpressionNode>();
+        auto exp_node = make<IfExpressionNode>();
         // Assuming ParseIfExpressions parses a single comparison or boolean literal for now.
         // For more complex boolean logic (AND, OR), this function would need to be expanded.
         if (check(TokensTypes::TOKEN_IDENTIFIER))
         {
-            exp_node->var_name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-            if (exp_node->var_name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+            exp_node->var_name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+            if (exp_node->var_name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
                 return nullptr; // Consume failed
 
             if (isConditionOperator(current().type)) // check if current token is a condition operator
@@ -524,37 +604,41 @@ namespace Rythin
                 switch (current().type) // Check the type of the value after the operator
                 {
                 case TokensTypes::TOKEN_INT_32:
-                    exp_node->val = std::make_shared<i32Node>(std::stoi(consume(TokensTypes::TOKEN_INT_32).value));
+                    exp_node->val = make<i32Node>(static_cast<int32_t>(consume(TokensTypes::TOKEN_INT_32).number.integer));
                     break;
                 case TokensTypes::TOKEN_INT_64: // Added INT_64 support
-                    exp_node->val = std::make_shared<i64Node>(std::stoll(consume(TokensTypes::TOKEN_INT_64).value));
+                    exp_node->val = make<i64Node>(consume(TokensTypes::TOKEN_INT_64).number.integer);
                     break;
                 case TokensTypes::TOKEN_FLOAT_32:
-                    exp_node->val = std::make_shared<f32Node>(std::stof(consume(TokensTypes::TOKEN_FLOAT_32).value));
+                    exp_node->val = make<f32Node>(static_cast<float>(consume(TokensTypes::TOKEN_FLOAT_32).number.real));
                     break;
                 case TokensTypes::TOKEN_FLOAT_64:
-                    exp_node->val = std::make_shared<f64Node>(std::stod(consume(TokensTypes::TOKEN_FLOAT_64).value));
+                    exp_node->val = make<f64Node>(consume(TokensTypes::TOKEN_FLOAT_64).number.real);
                     break;
                 case TokensTypes::TOKEN_STRING_LITERAL: // Added string literal support for comparison
-                    exp_node->val = std::make_shared<LiteralNode>(consume(TokensTypes::TOKEN_STRING_LITERAL).value);
+                {
+                    FormatPlan plan;
+                    std::string val = ParseStringLiteral(plan);
+                    exp_node->val = make<LiteralNode>(std::move(val), std::move(plan));
                     break;
+                }
                 case TokensTypes::TOKEN_IDENTIFIER: // Added identifier support for comparison (variable vs variable)
                 {
-                    auto var = std::make_shared<VariableNode>();
-                    var->name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-                    if (var->name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+                    auto var = make<VariableNode>();
+                    var->name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+                    if (var->name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
                         return nullptr; // Consume failed
                     exp_node->val = var;
                     break;
                 }
                 default:
-                    LogErrors::getInstance().addError("Expected a value or identifier after conditional operator", 200, current().line, current().column);
+                    LogErrors::getInstance().addError("Expected a value or identifier after conditional operator", 200, current().where);
                     return nullptr;
                 }
             }
             else
             {
-                LogErrors::getInstance().addError("Expected a conditional operator (==, !=, >, etc.) after identifier in if expression", 201, current().line, current().column);
+                LogErrors::getInstance().addError("Expected a conditional operator (==, !=, >, etc.) after identifier in if expression", 201, current().where);
                 return nullptr;
             }
         }
@@ -566,11 +650,11 @@ namespace Rythin
 
             // If it's a direct boolean literal, val should likely be a TrueOrFalseNode directly.
             // Current setup uses 'type' for the boolean operator (TRUE/FALSE) which is fine for direct literals.
-            exp_node->val = std::make_shared<TrueOrFalseNode>(exp_node->type == TokensTypes::TOKEN_TRUE);
+            exp_node->val = make<TrueOrFalseNode>(exp_node->type == TokensTypes::TOKEN_TRUE);
         }
         else
         {
-            LogErrors::getInstance().addError("Invalid expression in 'if' condition. Expected identifier or boolean literal.", 202, current().line, current().column);
+            LogErrors::getInstance().addError("Invalid expression in 'if' condition. Expected identifier or boolean literal.", 202, current().where);
             return nullptr;
         }
         return exp_node;
@@ -578,7 +662,7 @@ namespace Rythin
 
     ASTPtr Parser::ParsePrint()
     {
-        auto node = std::make_shared<PrintNode>();
+        auto node = make<PrintNode>();
         if (consume(TokensTypes::TOKEN_PRINT).type != TokensTypes::TOKEN_PRINT)
             return nullptr;
         if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
@@ -588,7 +672,7 @@ namespace Rythin
         {
             if (check(TokensTypes::TOKEN_STRING_LITERAL))
             {
-                node->val = consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+                node->val = ParseStringLiteral(node->format);
                 if (node->val.empty() && current().type != TokensTypes::TOKEN_STRING_LITERAL)
                     return nullptr; // Consume failed
 
@@ -599,16 +683,18 @@ namespace Rythin
                     // Ensure the next token is also a string literal for concatenation
                     if (check(TokensTypes::TOKEN_STRING_LITERAL))
                     {
-                        node->val += consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+                        node->val += ParseStringLiteral(node->format);
                     }
                     else if (check(TokensTypes::TOKEN_IDENTIFIER)) // Allows string concatenation with variable
                     {
                         // TODO: semantic analysis will need to verify if the identifier is a charseq
-                        node->val += consume(TokensTypes::TOKEN_IDENTIFIER).value;
+                        TokenView name = consume(TokensTypes::TOKEN_IDENTIFIER);
+                        node->val += name.value;
+                        node->format.appendSlot(name.symbol, false);
                     }
                     else
                     {
-                        LogErrors::getInstance().addError("Only string literals or identifiers can be concatenated with '+' in print for now.", 3, current().line, current().column);
+                        LogErrors::getInstance().addError("Only string literals or identifiers can be concatenated with '+' in print for now.", 3, current().where);
                         return nullptr; // Return nullptr indicating an error in this AST subtree
                     }
                 }
@@ -617,28 +703,31 @@ namespace Rythin
             {
                 if (consume(TokensTypes::TOKEN_NIL).type != TokensTypes::TOKEN_NIL)
                     return nullptr;
-                return std::make_shared<NilNode>(); // Return NilNode if print(nil)
+                return make<NilNode>(); // Return NilNode if print(nil)
             }
             else if (check(TokensTypes::TOKEN_IDENTIFIER)) // Allow printing identifiers directly
             {
-                node->val = consume(TokensTypes::TOKEN_IDENTIFIER).value;
+                TokenView name = consume(TokensTypes::TOKEN_IDENTIFIER);
+                node->val = name.value;
+                node->format.appendSlot(name.symbol, false);
             }
             else if (current().type == TokensTypes::TOKEN_INT_32 || current().type == TokensTypes::TOKEN_INT_64 ||
                      current().type == TokensTypes::TOKEN_FLOAT_32 || current().type == TokensTypes::TOKEN_FLOAT_64) // Allow printing numbers directly
             {
                 node->val = current().value; // Store the string representation of the number
+                node->format.appendText(node->val);
                 consume(current().type);     // Consume the number token
             }
             else
             {
-                LogErrors::getInstance().addError("Print statement supports string literals, identifiers, numbers, or 'nil'", 3, current().line, current().column);
+                LogErrors::getInstance().addError("Print statement supports string literals, identifiers, numbers, or 'nil'", 3, current().where);
                 return nullptr;
             }
         }
         else
         {
             // Handle empty print()
-            LogErrors::getInstance().addWarning("Empty print statement. Consider printing a newline with printnl()", 300, current().line, current().column);
+            LogErrors::getInstance().addWarning("Empty print statement. Consider printing a newline with printnl()", 300, current().where);
         }
         if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
             return nullptr;
@@ -654,7 +743,8 @@ namespace Rythin
 
         if (check(TokensTypes::TOKEN_STRING_LITERAL))
         {
-            auto msg = consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+            FormatPlan prompt;
+            std::string msg = ParseStringLiteral(prompt);
             if (msg.empty() && current().type != TokensTypes::TOKEN_STRING_LITERAL)
                 return nullptr; // Consume failed
 
@@ -666,16 +756,16 @@ namespace Rythin
                     return nullptr;
                 if (check(TokensTypes::TOKEN_INT_32))
                 {
-                    std::string int_val_str = consume(TokensTypes::TOKEN_INT_32).value;
-                    if (int_val_str.empty() && current().type != TokensTypes::TOKEN_INT_32)
+                    TokenView int_val = consume(TokensTypes::TOKEN_INT_32);
+                    if (int_val.value.empty() && current().type != TokensTypes::TOKEN_INT_32)
                         return nullptr; // Consume failed
                     if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
                         return nullptr;
-                    return std::make_shared<CinputNode>(msg, std::stoi(int_val_str));
+                    return make<CinputNode>(std::move(msg), static_cast<int>(int_val.number.integer));
                 }
                 else
                 {
-                    LogErrors::getInstance().addError("Expected an integer after comma in cinput()", 301, current().line, current().column);
+                    LogErrors::getInstance().addError("Expected an integer after comma in cinput()", 301, current().where);
                     // Removed LogErrors::getInstance().printAll(); and exit(301);
                     return nullptr;
                 }
@@ -685,24 +775,24 @@ namespace Rythin
                 // No comma, so only message provided
                 if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
                     return nullptr;
-                return std::make_shared<CinputNode>(msg);
+                return make<CinputNode>(std::move(msg));
             }
         }
         else
         {
             // If no string literal, assume cinput() with no arguments
-            LogErrors::getInstance().addWarning("cinput() called without a message. Consider adding a prompt string.", 302, current().line, current().column);
+            LogErrors::getInstance().addWarning("cinput() called without a message. Consider adding a prompt string.", 302, current().where);
         }
 
         if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
             return nullptr;                    // Consume final RPAREN for the no-arg case
-        return std::make_shared<CinputNode>(); // Default cinput() if no specific arguments parsed (and no previous error)
+        return make<CinputNode>(); // Default cinput() if no specific arguments parsed (and no previous error)
     }
 
     ASTPtr Parser::ParsePrintE()
     {
         // TODO: remove the printe, print and cinput - This comment is from original code.
-        auto node = std::make_shared<PrintE>();
+        auto node = make<PrintE>();
         if (consume(TokensTypes::TOKEN_PRINT_ERROR).type != TokensTypes::TOKEN_PRINT_ERROR)
             return nullptr;
         if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
@@ -712,7 +802,7 @@ namespace Rythin
         {
             if (check(TokensTypes::TOKEN_STRING_LITERAL))
             {
-                node->val = consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+                node->val = ParseStringLiteral(node->format);
                 if (node->val.empty() && current().type != TokensTypes::TOKEN_STRING_LITERAL)
                     return nullptr; // Consume failed
 
@@ -722,15 +812,17 @@ namespace Rythin
                         return nullptr;
                     if (check(TokensTypes::TOKEN_STRING_LITERAL))
                     {
-                        node->val += consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+                        node->val += ParseStringLiteral(node->format);
                     }
                     else if (check(TokensTypes::TOKEN_IDENTIFIER))
                     {
-                        node->val += consume(TokensTypes::TOKEN_IDENTIFIER).value;
+                        TokenView name = consume(TokensTypes::TOKEN_IDENTIFIER);
+                        node->val += name.value;
+                        node->format.appendSlot(name.symbol, false);
                     }
                     else
                     {
-                        LogErrors::getInstance().addError("Only string literals or identifiers can be concatenated with '+' in print_error for now.", 3, current().line, current().column);
+                        LogErrors::getInstance().addError("Only string literals or identifiers can be concatenated with '+' in print_error for now.", 3, current().where);
                         return nullptr;
                     }
                 }
@@ -739,27 +831,30 @@ namespace Rythin
             {
                 if (consume(TokensTypes::TOKEN_NIL).type != TokensTypes::TOKEN_NIL)
                     return nullptr;
-                return std::make_shared<NilNode>();
+                return make<NilNode>();
             }
             else if (check(TokensTypes::TOKEN_IDENTIFIER))
             {
-                node->val = consume(TokensTypes::TOKEN_IDENTIFIER).value;
+                TokenView name = consume(TokensTypes::TOKEN_IDENTIFIER);
+                node->val = name.value;
+                node->format.appendSlot(name.symbol, false);
             }
             else if (current().type == TokensTypes::TOKEN_INT_32 || current().type == TokensTypes::TOKEN_INT_64 ||
                      current().type == TokensTypes::TOKEN_FLOAT_32 || current().type == TokensTypes::TOKEN_FLOAT_64)
             {
                 node->val = current().value;
+                node->format.appendText(node->val);
                 consume(current().type);
             }
             else
             {
-                LogErrors::getInstance().addError("Print_error statement supports string literals, identifiers, numbers, or 'nil'", 3, current().line, current().column);
+                LogErrors::getInstance().addError("Print_error statement supports string literals, identifiers, numbers, or 'nil'", 3, current().where);
                 return nullptr;
             }
         }
         else
         {
-            LogErrors::getInstance().addWarning("Empty print_error statement.", 303, current().line, current().column);
+            LogErrors::getInstance().addWarning("Empty print_error statement.", 303, current().where);
         }
         if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
             return nullptr;
@@ -768,7 +863,7 @@ namespace Rythin
 
     ASTPtr Parser::ParsePrintNl()
     {
-        auto node = std::make_shared<PrintNl>();
+        auto node = make<PrintNl>();
         if (consume(TokensTypes::TOKEN_PRINT_NEW_LINE).type != TokensTypes::TOKEN_PRINT_NEW_LINE)
             return nullptr;
         if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
@@ -778,7 +873,7 @@ namespace Rythin
         {
             if (check(TokensTypes::TOKEN_STRING_LITERAL))
             {
-                node->val = consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+                node->val = ParseStringLiteral(node->format);
                 if (node->val.empty() && current().type != TokensTypes::TOKEN_STRING_LITERAL)
                     return nullptr; // Consume failed
 
@@ -788,15 +883,17 @@ namespace Rythin
                         return nullptr;
                     if (check(TokensTypes::TOKEN_STRING_LITERAL))
                     {
-                        node->val += consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+                        node->val += ParseStringLiteral(node->format);
                     }
                     else if (check(TokensTypes::TOKEN_IDENTIFIER))
                     {
-                        node->val += consume(TokensTypes::TOKEN_IDENTIFIER).value;
+                        TokenView name = consume(TokensTypes::TOKEN_IDENTIFIER);
+                        node->val += name.value;
+                        node->format.appendSlot(name.symbol, false);
                     }
                     else
                     {
-                        LogErrors::getInstance().addError("Only string literals or identifiers can be concatenated with '+' in print_nl for now.", 3, current().line, current().column);
+                        LogErrors::getInstance().addError("Only string literals or identifiers can be concatenated with '+' in print_nl for now.", 3, current().where);
                         return nullptr;
                     }
                 }
@@ -805,27 +902,30 @@ namespace Rythin
             {
                 if (consume(TokensTypes::TOKEN_NIL).type != TokensTypes::TOKEN_NIL)
                     return nullptr;
-                return std::make_shared<NilNode>();
+                return make<NilNode>();
             }
             else if (check(TokensTypes::TOKEN_IDENTIFIER))
             {
-                node->val = consume(TokensTypes::TOKEN_IDENTIFIER).value;
+                TokenView name = consume(TokensTypes::TOKEN_IDENTIFIER);
+                node->val = name.value;
+                node->format.appendSlot(name.symbol, false);
             }
             else if (current().type == TokensTypes::TOKEN_INT_32 || current().type == TokensTypes::TOKEN_INT_64 ||
                      current().type == TokensTypes::TOKEN_FLOAT_32 || current().type == TokensTypes::TOKEN_FLOAT_64)
             {
                 node->val = current().value;
+                node->format.appendText(node->val);
                 consume(current().type);
             }
             else // Added else for comprehensive error handling
             {
-                LogErrors::getInstance().addError("Print_nl statement supports string literals, identifiers, numbers, or 'nil'", 3, current().line, current().column);
+                LogErrors::getInstance().addError("Print_nl statement supports string literals, identifiers, numbers, or 'nil'", 3, current().where);
                 return nullptr;
             }
         }
         else
         {
-            LogErrors::getInstance().addWarning("Empty print_nl statement.", 304, current().line, current().column);
+            LogErrors::getInstance().addWarning("Empty print_nl statement.", 304, current().where);
         }
         if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
             return nullptr;
@@ -838,13 +938,14 @@ namespace Rythin
         // consume the predominant value
         //  it need be a charseq literal ("on quotes") or a identifier
         std::string val;
+        FormatPlan plan;
 
-        val = consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+        val = ParseStringLiteral(plan);
         
         if (check(TokensTypes::TOKEN_PLUS))
         {
             consume(TokensTypes::TOKEN_PLUS);
-            val += consume(TokensTypes::TOKEN_STRING_LITERAL).value;
+            val += ParseStringLiteral(plan);
 
             // concatenation loop
             while (check(TokensTypes::TOKEN_PLUS))
@@ -856,26 +957,52 @@ namespace Rythin
                 switch (current().type)
                 {
                     case TokensTypes::TOKEN_STRING_LITERAL:
-                        val += consume(TokensTypes::TOKEN_STRING_LITERAL).value;       
+                        val += ParseStringLiteral(plan);
                         break;
                     case TokensTypes::TOKEN_IDENTIFIER:
                         // em breve adiciono suporte
                         break;
                     default:
-                        LogErrors::getInstance().addError("Invalid value for a charseq type", 51, current().line, current().column);
+                        LogErrors::getInstance().addError("Invalid value for a charseq type", 51, current().where);
                         return nullptr;
                 }
             }
         }
 
-        return std::make_shared<LiteralNode>(val);
+        return make<LiteralNode>(std::move(val), std::move(plan));
+    }
+
+    // a string literal and, if it has "$[name]" holes, the rest of its pieces:
+    // (INTERP_START IDENTIFIER INTERP_END STRING_LITERAL)*. The holes become slots of
+    // the plan, the returned text has the names in their place (like the old lexer gave)
+    std::string Parser::ParseStringLiteral(FormatPlan &plan)
+    {
+        TokenView text = consume(TokensTypes::TOKEN_STRING_LITERAL);
+        std::string val(text.value);
+        plan.appendText(text.value);
+        while (check(TokensTypes::TOKEN_INTERP_START))
+        {
+            consume(TokensTypes::TOKEN_INTERP_START);
+            if (check(TokensTypes::TOKEN_IDENTIFIER))
+            {
+                TokenView name = consume(TokensTypes::TOKEN_IDENTIFIER);
+                val += name.value;
+                plan.appendSlot(name.symbol, true);
+            }
+            // a hole without a name was reported by the lexer
+            consume(TokensTypes::TOKEN_INTERP_END);
+            text = consume(TokensTypes::TOKEN_STRING_LITERAL);
+            val += text.value;
+            plan.appendText(text.value);
+        }
+        return val;
     }
 
     ASTPtr Parser::ParseVarCall()
     {
-        auto var_node = std::make_shared<VariableNode>();
-        var_node->name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-        if (var_node->name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+        auto var_node = make<VariableNode>();
+        var_node->name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+        if (var_node->name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
             return nullptr; // Consume failed
         return var_node;
     }
@@ -884,8 +1011,8 @@ namespace Rythin
     {
         if (consume(TokensTypes::TOKEN_DEF).type != TokensTypes::TOKEN_DEF)
             return nullptr;
-        std::string name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-        if (name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+        Symbol name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+        if (name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
             return nullptr; // Consume failed
         if (consume(TokensTypes::TOKEN_COLON).type != TokensTypes::TOKEN_COLON)
             return nullptr;
@@ -894,7 +1021,7 @@ namespace Rythin
         auto type_token = consume(current().type);
         if (type_token.type == TokensTypes::TOKEN_EOF)
         { // Check if consume failed
-            LogErrors::getInstance().addError("Expected a type token after ':' in variable declaration.", 54, current().line, current().column);
+            LogErrors::getInstance().addError("Expected a type token after ':' in variable declaration.", 54, current().where);
             return nullptr;
         }
         tk = type_token.type;
@@ -907,27 +1034,27 @@ namespace Rythin
         auto val = ParseExpression(tk);
         if (!val)
             return nullptr; // Error in parsing expression
-        return std::make_shared<VariableDefinitionNode>(name, tk, val);
+        return make<VariableDefinitionNode>(name, tk, val);
     }
 
     ASTPtr Parser::ParseFuncExpressions()
     {
-        auto exp_node = std::make_shared<ExpressionNode>();
+        auto exp_node = make<ExpressionNode>();
         if (!check(TokensTypes::TOKEN_IDENTIFIER))
         { // Ensure identifier is present
-            LogErrors::getInstance().addError("Expected identifier for function argument name", 90, current().line, current().column);
+            LogErrors::getInstance().addError("Expected identifier for function argument name", 90, current().where);
             return nullptr;
         }
-        exp_node->var_name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-        if (exp_node->var_name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+        exp_node->var_name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+        if (exp_node->var_name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
             return nullptr; // Consume failed
         if (consume(TokensTypes::TOKEN_COLON).type != TokensTypes::TOKEN_COLON)
             return nullptr;
 
-        Tokens type_token = consume(current().type);
+        TokenView type_token = consume(current().type);
         if (type_token.type == TokensTypes::TOKEN_EOF)
         { // Check if consume failed
-            LogErrors::getInstance().addError("Expected a type token after ':' in function argument definition.", 91, current().line, current().column);
+            LogErrors::getInstance().addError("Expected a type token after ':' in function argument definition.", 91, current().where);
             return nullptr;
         }
         exp_node->type = type_token.type;
@@ -946,7 +1073,7 @@ namespace Rythin
         case TokensTypes::TOKEN_CHARSEQ:
             if (!check(TokensTypes::TOKEN_STRING_LITERAL))
             {
-                LogErrors::getInstance().addError("Expected a string literal for 'charseq' type", 98, current().line, current().column);
+                LogErrors::getInstance().addError("Expected a string literal for 'charseq' type", 98, current().where);
                 return nullptr;
             }
             parsed_val = ParseCharseqValues();
@@ -979,22 +1106,22 @@ namespace Rythin
             case TokensTypes::TOKEN_INT_64:
             case TokensTypes::TOKEN_FLOAT_32:
             case TokensTypes::TOKEN_FLOAT_64:
-                parsed_val = std::make_shared<ObjectNode>(ParseNumeralExpression());
+                parsed_val = make<ObjectNode>(ParseNumeralExpression());
                 break;
             case TokensTypes::TOKEN_TRUE:
             {
                 if (consume(TokensTypes::TOKEN_TRUE).type != TokensTypes::TOKEN_TRUE)
                     return nullptr;
-                auto ptr = std::make_shared<TrueOrFalseNode>(true);
-                parsed_val = std::make_shared<ObjectNode>(ptr);
+                auto ptr = make<TrueOrFalseNode>(true);
+                parsed_val = make<ObjectNode>(ptr);
                 break;
             }
             case TokensTypes::TOKEN_FALSE:
             {
                 if (consume(TokensTypes::TOKEN_FALSE).type != TokensTypes::TOKEN_FALSE)
                     return nullptr;
-                auto ptr = std::make_shared<TrueOrFalseNode>(false);
-                parsed_val = std::make_shared<ObjectNode>(ptr);
+                auto ptr = make<TrueOrFalseNode>(false);
+                parsed_val = make<ObjectNode>(ptr);
                 break;
             }
             case TokensTypes::TOKEN_STRING_LITERAL:
@@ -1002,7 +1129,7 @@ namespace Rythin
                 auto ptr = ParseCharseqValues();
                 if (!ptr)
                     return nullptr; // consume might return an invalid token or error
-                parsed_val = std::make_shared<ObjectNode>(ptr);
+                parsed_val = make<ObjectNode>(ptr);
                 break;
             }
             case TokensTypes::TOKEN_IDENTIFIER:
@@ -1010,9 +1137,9 @@ namespace Rythin
                 ASTPtr ptr;
                 if (peek(1).type == TokensTypes::TOKEN_LPAREN) // Check if it's a function call
                 {
-                    auto id = std::make_shared<IdentifierNode>(); // Assuming IdentifierNode for function calls with args
-                    id->name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-                    if (id->name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+                    auto id = make<IdentifierNode>(); // Assuming IdentifierNode for function calls with args
+                    id->name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+                    if (id->name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
                         return nullptr; // Consume failed
 
                     if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
@@ -1026,9 +1153,9 @@ namespace Rythin
                         case TokensTypes::TOKEN_IDENTIFIER:
                         {
                             // If it's just an identifier (variable passed as arg)
-                            auto var = std::make_shared<VariableNode>();
-                            var->name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-                            if (var->name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+                            auto var = make<VariableNode>();
+                            var->name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+                            if (var->name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
                                 return nullptr; // Consume failed
                             arg_val = var;
                             break;
@@ -1045,10 +1172,14 @@ namespace Rythin
                             arg_val = ParseLoopCondition(); // TrueOrFalseNode
                             break;
                         case TokensTypes::TOKEN_STRING_LITERAL: // Allow string literals as arguments
-                            arg_val = std::make_shared<LiteralNode>(consume(TokensTypes::TOKEN_STRING_LITERAL).value);
+                        {
+                            FormatPlan plan;
+                            std::string val = ParseStringLiteral(plan);
+                            arg_val = make<LiteralNode>(std::move(val), std::move(plan));
                             break;
+                        }
                         default:
-                            LogErrors::getInstance().addError("Invalid argument type in function call", 96, current().line, current().column);
+                            LogErrors::getInstance().addError("Invalid argument type in function call", 96, current().where);
                             // Attempt to skip this invalid argument to continue parsing
                             position++;        // Simple skip
                             arg_val = nullptr; // Explicitly set to nullptr to indicate parse error
@@ -1083,7 +1214,7 @@ namespace Rythin
                         }
                         else if (!check(TokensTypes::TOKEN_RPAREN))
                         { // If not comma and not end of args, then error
-                            LogErrors::getInstance().addError("Expected comma or ')' after function argument", 97, current().line, current().column);
+                            LogErrors::getInstance().addError("Expected comma or ')' after function argument", 97, current().where);
                             return nullptr;
                         }
                     }
@@ -1094,22 +1225,22 @@ namespace Rythin
                 else
                 {
                     // It's a variable call
-                    auto id = std::make_shared<VariableNode>();
-                    id->name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-                    if (id->name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+                    auto id = make<VariableNode>();
+                    id->name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+                    if (id->name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
                         return nullptr; // Consume failed
                     ptr = id;
                 }
-                parsed_val = std::make_shared<ObjectNode>(ptr);
+                parsed_val = make<ObjectNode>(ptr);
                 break;
             }
             default:
-                LogErrors::getInstance().addError("Invalid variable value for 'obj' type", 95, current().line, current().column);
+                LogErrors::getInstance().addError("Invalid variable value for 'obj' type", 95, current().where);
                 return nullptr;
             }
             break; // Break from the inner switch (TOKEN_OBJECT)
         default:
-            LogErrors::getInstance().addError("Invalid variable value type", 97, current().line, current().column);
+            LogErrors::getInstance().addError("Invalid variable value type", 97, current().where);
             return nullptr;
             // throw Excepts::CompilationException("Invalid Variable Value Type"); // This line was problematic
         }
@@ -1125,17 +1256,17 @@ namespace Rythin
         {
             if (consume(TokensTypes::TOKEN_TRUE).type != TokensTypes::TOKEN_TRUE)
                 return nullptr;
-            return std::make_shared<TrueOrFalseNode>(true);
+            return make<TrueOrFalseNode>(true);
         }
         else if (current().type == TokensTypes::TOKEN_FALSE)
         {
             if (consume(TokensTypes::TOKEN_FALSE).type != TokensTypes::TOKEN_FALSE)
                 return nullptr;
-            return std::make_shared<TrueOrFalseNode>(false);
+            return make<TrueOrFalseNode>(false);
         }
         else
         {
-            LogErrors::getInstance().addError("Expected 'true' or 'false' for loop condition literal.", 203, current().line, current().column);
+            LogErrors::getInstance().addError("Expected 'true' or 'false' for loop condition literal.", 203, current().where);
             return nullptr;
         }
     }
@@ -1147,8 +1278,8 @@ namespace Rythin
         if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
             return nullptr;
 
-        std::string var_name = consume(TokensTypes::TOKEN_IDENTIFIER).value;
-        if (var_name.empty() && current().type != TokensTypes::TOKEN_IDENTIFIER)
+        Symbol var_name = nameOf(consume(TokensTypes::TOKEN_IDENTIFIER));
+        if (var_name == Interner::empty && current().type != TokensTypes::TOKEN_IDENTIFIER)
             return nullptr; // Consume failed
 
         // consome o : para em seguida consumir o tipo da variavel
@@ -1156,10 +1287,10 @@ namespace Rythin
             return nullptr;
 
         TokensTypes type;
-        Tokens type_token = consume(current().type);
+        TokenView type_token = consume(current().type);
         if (type_token.type == TokensTypes::TOKEN_EOF)
         { // Check if consume failed
-            LogErrors::getInstance().addError("Expected a type token after ':' in loop expression variable definition.", 23, current().line, current().column);
+            LogErrors::getInstance().addError("Expected a type token after ':' in loop expression variable definition.", 23, current().where);
             return nullptr;
         }
         type = type_token.type;
@@ -1183,7 +1314,7 @@ namespace Rythin
                 return nullptr; // Error in variable call
             break;
         default:
-            LogErrors::getInstance().addError("Invalid type for 'in' value in loop expression. Expected numeral or a identifier.", 23, current().line, current().column);
+            LogErrors::getInstance().addError("Invalid type for 'in' value in loop expression. Expected numeral or a identifier.", 23, current().where);
             return nullptr;
         }
         if (consume(TokensTypes::TOKEN_RPAREN).type != TokensTypes::TOKEN_RPAREN)
@@ -1191,10 +1322,8 @@ namespace Rythin
         if (consume(TokensTypes::TOKEN_ARROW_SET).type != TokensTypes::TOKEN_ARROW_SET)
             return nullptr;
 
-        auto block = ParseBlock();
-        if (!block)
-            return nullptr; // Error in parsing block
-        return std::make_shared<LoopNode>(var_name, type, val, block);
+        // the block is opened by ParseStatement
+        return make<LoopNode>(var_name, type, val, nullptr);
     }
 
     ASTPtr Parser::ParseLoopCond()
@@ -1204,7 +1333,7 @@ namespace Rythin
         if (consume(TokensTypes::TOKEN_LPAREN).type != TokensTypes::TOKEN_LPAREN)
             return nullptr;
 
-        auto node = std::make_shared<LoopConditionNode>();
+        auto node = make<LoopConditionNode>();
 
         ASTPtr condition_node = nullptr;
         switch (current().type)
@@ -1227,7 +1356,7 @@ namespace Rythin
             condition_node = ParseIfExpressions(); // Reusing ParseIfExpressions might work if it supports direct comparisons without an initial IDENTIFIER
             break;
         default:
-            LogErrors::getInstance().addError("Invalid token for loop condition. Expected boolean literal, identifier, or expression.", 204, current().line, current().column);
+            LogErrors::getInstance().addError("Invalid token for loop condition. Expected boolean literal, identifier, or expression.", 204, current().where);
             return nullptr;
         }
 
@@ -1240,11 +1369,7 @@ namespace Rythin
         if (consume(TokensTypes::TOKEN_ARROW_SET).type != TokensTypes::TOKEN_ARROW_SET)
             return nullptr;
 
-        node->body = ParseBlock();
-        if (!node->body)
-            return nullptr; // Error in parsing block
-
-        return node;
+        return node; // the body is opened by ParseStatement
     }
 
     ASTPtr Parser::ParseByteVal()
@@ -1253,23 +1378,27 @@ namespace Rythin
         unsigned char val;
 
         // Ensure consume returns a valid token before accessing its value
-        Tokens num_token = current(); // Get current token before consuming
+        TokenView num_token = current(); // Get current token before consuming
         if (num_token.type == TokensTypes::TOKEN_INT_32 || num_token.type == TokensTypes::TOKEN_INT_64 ||
             num_token.type == TokensTypes::TOKEN_FLOAT_32 || num_token.type == TokensTypes::TOKEN_FLOAT_64)
         {
             // Assuming we only take the integer part for byte conversion
-            lit_val = std::stoll(consume(num_token.type).value);
+            TokenView num = consume(num_token.type);
+            if (num.type == TokensTypes::TOKEN_INT_32 || num.type == TokensTypes::TOKEN_INT_64)
+                lit_val = num.number.integer;
+            else
+                lit_val = static_cast<long long>(std::clamp(num.number.real, -9.2e18, 9.2e18));
         }
         else
         {
-            LogErrors::getInstance().addError("Expected a number literal for byte type", 88, current().line, current().column);
+            LogErrors::getInstance().addError("Expected a number literal for byte type", 88, current().where);
             // Removed LogErrors::getInstance().printAll(); and exit(88);
             return nullptr; // Return nullptr for error progression
         }
 
         if (lit_val < 0 || lit_val > 255)
         {
-            LogErrors::getInstance().addWarning("Value " + std::to_string(lit_val) + " is out of range for byte type. It will be truncated to: " + std::to_string(static_cast<unsigned char>(lit_val)), 5, current().line, current().column);
+            LogErrors::getInstance().addWarning("Value " + std::to_string(lit_val) + " is out of range for byte type. It will be truncated to: " + std::to_string(static_cast<unsigned char>(lit_val)), 5, current().where);
             val = static_cast<unsigned char>(lit_val);
         }
         else
@@ -1277,55 +1406,155 @@ namespace Rythin
             val = static_cast<unsigned char>(lit_val);
         }
 
-        return std::make_shared<ByteNode>(val);
+        return make<ByteNode>(val);
     }
 
     ASTPtr Parser::ParseBlock()
     {
-        auto block = std::make_shared<BlockNode>();
+        std::size_t base = open.size();
+        if (!openBlock(OpenBlock::BODY, nullptr))
+            return nullptr;
+        return ParseOpenBlocks(base);
+    }
+
+    ASTPtr Parser::openWith(ASTPtr node, OpenBlock::Owner owner)
+    {
+        if (!node || !openBlock(owner, node))
+            return nullptr; // Error in the header or in the '['
+        return node;
+    }
+
+    bool Parser::openBlock(OpenBlock::Owner owner, ASTPtr node)
+    {
+        auto block = make<BlockNode>();
+        if (open.size() >= max_depth)
+        {
+            LogErrors::getInstance().addError("Blocks nested more than " + std::to_string(max_depth) + " levels deep (see --max-nesting).", 58, current().where);
+            // skips the whole block, so the levels inside it are not reported again
+            int depth = 0;
+            do
+            {
+                if (current().type == TokensTypes::TOKEN_EOF)
+                    break;
+                if (check(TokensTypes::TOKEN_LBRACKET))
+                    depth++;
+                else if (check(TokensTypes::TOKEN_RBRACKET))
+                    depth--;
+                position++;
+            } while (depth > 0);
+            return false;
+        }
         if (consume(TokensTypes::TOKEN_LBRACKET).type != TokensTypes::TOKEN_LBRACKET)
-            return nullptr; // '['
+            return false; // '['
+        open.push_back({owner, node, block, pending.size()});
+        return true;
+    }
+
+    ASTPtr Parser::closeBlock()
+    {
+        OpenBlock top = open.back();
+        open.pop_back();
+        top.block->statements.assign(pending.begin() + top.mark, pending.end());
+        pending.resize(top.mark);
 
-        while (!check(TokensTypes::TOKEN_RBRACKET))
+        switch (top.owner)
+        {
+        case OpenBlock::BODY:
+            return top.block;
+        case OpenBlock::LOOP_COND:
+            static_cast<LoopConditionNode *>(top.node)->body = top.block;
+            return top.node;
+        case OpenBlock::LOOP:
+            static_cast<LoopNode *>(top.node)->block = top.block;
+            break;
+        case OpenBlock::FUNCTION:
+            static_cast<FunctionDefinitionNode *>(top.node)->block = top.block;
+            break;
+        case OpenBlock::BUT:
+            static_cast<IfStatement *>(top.node)->butBranch = top.block;
+            break;
+        case OpenBlock::IF:
         {
-            if (current().type == TokensTypes::TOKEN_EOF)
+            auto node = static_cast<IfStatement *>(top.node);
+            node->ifBranch = top.block;
+            if (check(TokensTypes::TOKEN_BUT))
             {
-                LogErrors::getInstance().addError("Unclosed block. Expected ']' but reached end of file.", 57, current().line, current().column);
-                // Removed LogErrors::getInstance().printAll(); and exit(57);
-                return nullptr; // Return nullptr for error progression
+                // the 'but' body takes the place of the if body
+                if (ParseButHeader(*node))
+                    openBlock(OpenBlock::BUT, node);
+                return nullptr;
             }
-            ASTPtr statement = ParseDeclarations();
-            if (statement)
+            break;
+        }
+        }
+        // stamped after its last block, where the recursive parser made it
+        top.node->token = static_cast<uint32_t>(position);
+        return top.node;
+    }
+
+    ASTPtr Parser::ParseOpenBlocks(std::size_t base)
+    {
+        while (open.size() > base)
+        {
+            std::size_t depth = open.size();
+            ASTPtr statement;
+            if (check(TokensTypes::TOKEN_RBRACKET))
+            {
+                consume(TokensTypes::TOKEN_RBRACKET);
+                statement = closeBlock();
+                if (open.size() == depth)
+                    continue; // the 'but' block was opened in its place
+                if (statement && open.size() == base)
+                    return statement;
+                if (!statement && open.size() == base)
+                    return nullptr; // a bad 'but', the caller recovers
+            }
+            else if (current().type == TokensTypes::TOKEN_EOF)
             {
-                block->statements.push_back(statement);
+                LogErrors::getInstance().addError("Unclosed block. Expected ']' but reached end of file.", 57, current().where);
+                break;
             }
             else
             {
-                // Error in parsing a statement within the block, attempt to synchronize
-                // by skipping tokens until a known statement start or block end.
-                // This is a simple recovery, might need more sophisticated skipping.
-                while (!check(TokensTypes::TOKEN_RBRACKET) &&
-                       current().type != TokensTypes::TOKEN_EOF &&
-                       current().type != TokensTypes::TOKEN_CINPUT &&
-                       current().type != TokensTypes::TOKEN_IF &&
-                       current().type != TokensTypes::TOKEN_LOOP &&
-                       current().type != TokensTypes::TOKEN_PRINT &&
-                       current().type != TokensTypes::TOKEN_PRINT_ERROR &&
-                       current().type != TokensTypes::TOKEN_PRINT_NEW_LINE &&
-                       current().type != TokensTypes::TOKEN_DEF &&
-                       current().type != TokensTypes::TOKEN_STRING_LITERAL) // Added STRING_LITERAL for recovery
-                {
-                    position++; // Skip current token
-                }
-                // If we skipped to EOF, or if the next token is RBRACKET, we can break or proceed.
-                if (current().type == TokensTypes::TOKEN_EOF)
-                {
-                    return nullptr; // Unclosed block reaching EOF
-                }
+                statement = ParseStatement();
+                if (open.size() > depth)
+                    continue; // a compound statement, its block is on top now
             }
+
+            if (statement)
+            {
+                pending.push_back(statement);
+            }
+            else if (!skipStatement())
+            {
+                break;
+            }
+        }
+        // reached the end of file: every block still open (and its statement) fails
+        pending.resize(open[base].mark);
+        open.resize(base);
+        return nullptr;
+    }
+
+    bool Parser::skipStatement()
+    {
+        // Error in parsing a statement within the block, attempt to synchronize
+        // by skipping tokens until a known statement start or block end.
+        // This is a simple recovery, might need more sophisticated skipping.
+        while (!check(TokensTypes::TOKEN_RBRACKET) &&
+               current().type != TokensTypes::TOKEN_EOF &&
+               current().type != TokensTypes::TOKEN_CINPUT &&
+               current().type != TokensTypes::TOKEN_IF &&
+               current().type != TokensTypes::TOKEN_LOOP &&
+               current().type != TokensTypes::TOKEN_PRINT &&
+               current().type != TokensTypes::TOKEN_PRINT_ERROR &&
+               current().type != TokensTypes::TOKEN_PRINT_NEW_LINE &&
+               current().type != TokensTypes::TOKEN_DEF &&
+               current().type != TokensTypes::TOKEN_STRING_LITERAL) // Added STRING_LITERAL for recovery
+        {
+            position++; // Skip current token
         }
-        if (consume(TokensTypes::TOKEN_RBRACKET).type != TokensTypes::TOKEN_RBRACKET)
-            return nullptr; // ']'
-        return block;
+        // If we skipped to EOF the block is unclosed
+        return current().type != TokensTypes::TOKEN_EOF;
     }
 }
@@ -18,8 +18,13 @@
 
 #include <vector>
 #include "../../src/tokens/t_tokens.hpp"
+#include "../../src/tokens/token_stream.hpp"
+#include "../../src/tokens/token_window.hpp"
 #include "../../src/includes/ast.hpp"
+#include "../../src/includes/ast_arena.hpp"
+#include "../../src/includes/flat_ast.hpp"
 #include "../../src/lexer/lex_types.hpp"
+#include "../../src/parser/precedence.hpp"
 
 
 namespace Rythin {
@@ -27,24 +32,71 @@ namespace Rythin {
     class Parser {
         private:
         int position;
-        std::vector<Tokens> tokens;
+        // where the tokens come from, not owned: the whole lexed file (batch mode)
+        // or the lexer itself through a ring of the last tokens (streaming mode)
+        const TokenStream *tokens;
+        TokenWindow *window;
+        AstArena &arena; // owner of the nodes made by the parser, outlives it
+        int limit;       // tokens from here on read as the EOF token (the end of a range)
+        // parses next to other parsers (ParallelParser): shared state is not written
+        // and the names of the error recovery are not interned
+        bool concurrent;
+        // lazy: the function bodies are skipped by bracket matching and only their token
+        // range is kept on the node, ParseBody parses them when they are needed.
+        // batch mode only (the window can't go back to the body) and not for Parse(FlatAst&)
+        bool lazy = false;
+        std::size_t max_depth; // blocks open at once before the nesting is reported (see openBlock)
+        TokenView tokenAt(int index);
+        // makes a node on the arena, stamped with the current token
+        template <typename T, typename... Args>
+        T *make(Args &&...args)
+        {
+            T *node = arena.make<T>(std::forward<Args>(args)...);
+            node->token = static_cast<uint32_t>(position);
+            return node;
+        }
+        // symbol of a name token
+        Symbol nameOf(const TokenView &tk);
         public:
-        inline static std::vector<std::string> codes;
-        Parser(std::vector<Tokens> tokens) : position(0), tokens(tokens){}
-        Tokens current();
-        Tokens peek(int offset); // Added: Peeks at a token without consuming it.
-        Tokens consume(TokensTypes tk);
+        // the blocks are parsed on an explicit stack, this only keeps the trees of generated
+        // code in a size the recursive passes after the parser (analyzer, type checker) can walk
+        static constexpr std::size_t default_max_depth = 1024;
+        // the most --max-nesting takes: those passes take ~600 bytes of stack per block in an
+        // unoptimized build, 4096 levels is ~2.5 MB, well inside the usual 8 MB
+        static constexpr std::size_t deepest_max_depth = 4096;
+
+        Parser(const TokenStream &tokens, AstArena &arena) : position(0), tokens(&tokens), window(nullptr), arena(arena), limit(static_cast<int>(tokens.size())), concurrent(false), max_depth(default_max_depth){}
+        Parser(TokenWindow &window, AstArena &arena) : position(0), tokens(nullptr), window(&window), arena(arena), limit(0), concurrent(false), max_depth(default_max_depth){}
+        // only the tokens [begin, end) of the stream (concurrent: on a worker thread, see above)
+        Parser(const TokenStream &tokens, AstArena &arena, int begin, int end, bool concurrent) : position(begin), tokens(&tokens), window(nullptr), arena(arena), limit(end), concurrent(concurrent), max_depth(default_max_depth){}
+        void deferBodies(bool on) { lazy = on && tokens != nullptr; }
+        // most blocks nested inside each other (at least 1), a deeper one is an error and is skipped
+        void maxDepth(std::size_t depth) { max_depth = depth ? depth : 1; }
+        // parses the body of a function a lazy parser skipped (nullptr on errors), its nodes go to arena
+        static ASTPtr ParseBody(const TokenStream &tokens, AstArena &arena, const FunctionDefinitionNode &func, std::size_t max_depth = default_max_depth);
+        // the source of the tokens [first, last] (by position), sliced when asked. empty in streaming mode
+        std::string_view code(int first, int last) const;
+        TokenView current();
+        TokenView peek(int offset); // Added: Peeks at a token without consuming it.
+        TokenView consume(TokensTypes tk);
         std::vector<ASTPtr> Parse();
+        // parses into the flat form: each top level item is copied to out as soon as it's parsed,
+        // and the arena is only scratch (cleared after every item, so it holds one item at a time)
+        void Parse(FlatAst &out);
         bool check(TokensTypes tk);
         bool lookAhead(TokensTypes tk);
         //private functions
         private:
+        ASTPtr ParseTopLevel();
+        ASTPtr ParseStatement(); // one statement, a compound one is left with its block open
         ASTPtr ParsePrint();
         ASTPtr ParsePrintE();
         ASTPtr ParsePrintNl();
         ASTPtr ParseIfStatement();
+        bool ParseButHeader(IfStatement &node);
         ASTPtr ParseIfExpressions();
         ASTPtr ParseBlock();
+        int matchingBracket(int open); // the ']' of the '[' at open, -1 if it's not closed
         ASTPtr ParseLoopExpression();
         ASTPtr ParseDeclarations();
         ASTPtr ParseExpression(TokensTypes types);
@@ -56,18 +108,59 @@ namespace Rythin {
         ASTPtr ParseVarDeclaration();
         ASTPtr ParseVarCall();
         ASTPtr ParseCharseqValues();
+        std::string ParseStringLiteral(FormatPlan &plan);
+
+        // expression parsing with the precedence table
+        ASTPtr ParsePrimaryExpression();  // Handles numbers and identifiers
+        ASTPtr ParseBinaryExpression();   // every operator of Precedence::table, prefixes and parentheses
+
+        // an operator of ParseBinaryExpression still waiting for its operands
+        struct PendingOp
+        {
+            enum Form : uint8_t { BINARY, PREFIX, PAREN };
+            TokensTypes type;
+            uint8_t power;
+            Form form;
+        };
+        std::vector<ASTPtr> operands;
+        std::vector<PendingOp> operators;
+
+        // the items of the lists being parsed (block statements, function parameters): the nested
+        // lists stack up on pending and each one is copied out once, at its exact size
+        std::vector<ASTPtr> pending;
 
-        // New functions for arithmetic expression parsing with precedence
-        ASTPtr ParsePrimaryExpression();      // Handles numbers, identifiers, and parenthesized expressions
-        ASTPtr ParseMultiplicativeExpression(); // Handles multiplication, division, modulo
-        ASTPtr ParseAdditiveExpression();     // Handles addition, subtraction
+        // the blocks being parsed, the innermost last. a compound statement only parses its
+        // header (up to the '['), its block goes on this stack and ParseOpenBlocks parses the
+        // statements of the top one, so no nesting of the source recurses on the native stack
+        struct OpenBlock
+        {
+            enum Owner : uint8_t { BODY, IF, BUT, LOOP, LOOP_COND, FUNCTION };
+            Owner owner;
+            ASTPtr node;      // the statement of the block, done when it closes (nullptr for a BODY)
+            BlockNode *block;
+            std::size_t mark; // its statements start here on pending
+        };
+        std::vector<OpenBlock> open;
+        ASTPtr openWith(ASTPtr node, OpenBlock::Owner owner); // opens the block of a parsed header
+        bool openBlock(OpenBlock::Owner owner, ASTPtr node);  // consumes the '[' and pushes the block
+        ASTPtr closeBlock();                                  // pops the top block into its statement
+        ASTPtr ParseOpenBlocks(std::size_t base);             // parses until the blocks over base are closed
+        bool skipStatement();                                 // error recovery inside a block, false at EOF
 
-        std::string getCode();
+        struct PendingList
+        {
+            std::vector<ASTPtr> &items;
+            std::size_t mark;
+            explicit PendingList(std::vector<ASTPtr> &items) : items(items), mark(items.size()) {}
+            ~PendingList() { items.resize(mark); }
+            void push(ASTPtr item) { items.push_back(item); }
+            std::vector<ASTPtr> take() const { return std::vector<ASTPtr>(items.begin() + mark, items.end()); }
+        };
 
         ASTPtr ParseByteVal();
         ASTPtr ParseNumeralExpression();
         //ASTPtr Parse
-        ASTPtr ParseIntVal(); /// This will now call ParseAdditiveExpression to handle full arithmetic expressions
+        ASTPtr ParseIntVal(); /// entry of the value expressions, calls ParseBinaryExpression
 
         bool isConditionOperator(TokensTypes type) {
             return type == TokensTypes::TOKEN_LESS_THAN || // < 
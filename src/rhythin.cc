@@ -13,20 +13,29 @@
 // You should have received a copy of the GNU General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <cstring>
 #include <ctype.h>
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <stdlib.h>
 #include <vector>
 
 // local includes
 #include "../src/tokens/t_tokens.hpp"
 #include "../src/lexer/r_lex.hpp"
+#include "../src/lexer/parallel_lex.hpp"
+#include "../src/parser/parallel_parse.hpp"
 #include "../src/parser/r_parser.hpp"
 #include "../src/includes/r_opcodes.hpp"
+#include "../src/includes/ast_cache.hpp"
+#include "../src/includes/const_folder.hpp"
 #include "../src/includes/log.hpp"
 #include "../src/includes/semantic_visitor.hpp"
+#include "../src/includes/source_buffer.hpp"
+#include "../src/includes/type_checker.hpp"
+#include "../src/tokens/token_window.hpp"
 
 #if defined(__linux__)
     #define BAD_COMP "\x1b[1m\x1b[31m[Bad execution]:>\x1b[0m "
@@ -41,45 +50,137 @@ std::fstream file;
 
 namespace Rythin
 {
+    // flags given after the file
+    struct RunOptions
+    {
+        bool stream = false; // --stream: the parser pulls the tokens from the lexer instead of lexing the whole file first
+        unsigned lex_threads = 1; // --lex-threads N: lexes the file on N threads (0 = one per core), ignored by --stream
+        unsigned parse_threads = 1; // --parse-threads N: parses the top level items on N threads (0 = one per core), ignored by --stream
+        bool lazy = false; // --lazy: function bodies are parsed and checked on their first call (and 'main' at the end), ignored by --stream
+        bool check_all = false; // --check-all: every body is parsed and checked, --lazy is ignored (for CI)
+        bool cache = true; // --no-cache: always lexes and parses, and doesn't write the AST cache
+        bool dump_symbols = false; // --dump-symbols: prints the variables and functions (and the literal values) after the semantic pass
+        bool dump_ir = false; // --dump-ir: prints the typed IR made by the type pass
+        unsigned max_nesting = Parser::default_max_depth; // --max-nesting N: most blocks nested inside each other (the analyzer and the type checker still recurse, so up to Parser::deepest_max_depth)
+    };
+
     class MainExecutor
     {
     public:
-        void Run(std::string file_name)
+        void Run(std::string file_name, const RunOptions &options)
         {
-            // open to read of file
-            std::fstream file(file_name, std::ios::in);
-            if (file.is_open())
+            // maps the file (or reads it once, for pipes); the lexer scans it in place
+            SourceBuffer source;
+            if (source.load(file_name))
             {
-                std::string code;
-                std::string line;
-                while (std::getline(file, line))
+                AstArena arena; // every node of the file, freed at once at the end of the run
+                std::vector<ASTPtr> nodes;
+
+                // a source already checked with no errors comes back with its warnings, not lexed or parsed again
+                // (the entries don't say under which nesting limit they were checked, another one skips the cache,
+                // and so do --dump-symbols and --dump-ir, they come from the passes)
+                bool cached = options.cache && !options.dump_symbols && !options.dump_ir && options.max_nesting == Parser::default_max_depth;
+                AstCache cache(cached ? AstCache::defaultDir() : std::filesystem::path());
+                FlatAst flat;
+                std::vector<LogErrors::Held> diagnostics;
+                if (cache.load(source.view(), flat, diagnostics))
                 {
-                    if (!line.empty())
-                        code += line + '\n';
+                    // nothing runs after the passes yet, the flat tree stays as it was read
+                    LogErrors::getInstance().replay(diagnostics);
+                    return;
                 }
 
-                file.close();
+                // a lazily checked unit reports less than an eager one, --check-all wants all of it
+                bool lazy = options.lazy && !options.check_all;
 
-                Lexer lexer(code);
+                Lexer lexer(source.view());
+                std::optional<TokenStream> tokens; // batch mode, kept for the lazy bodies
+                std::optional<TokenWindow> window; // stream mode
+                {
+                    // the diagnostics are logged after the passes, and stored with the tree
+                    LogErrors::Hold hold(diagnostics);
 
-                std::vector<Tokens> tokens;
+                    if (options.stream)
+                    {
+                        // constant memory for the tokens, lexing is interleaved with the parsing
+                        window.emplace(lexer, source.view());
+                        Rythin::Parser parser(*window, arena);
+                        parser.maxDepth(options.max_nesting);
+                        nodes = parser.Parse();
+                    }
+                    else
+                    {
+                        tokens.emplace(source.view());
+                        if (options.lex_threads != 1)
+                        {
+                            ParallelLexer plexer(source.view(), options.lex_threads);
+                            plexer.tokenize(*tokens);
+                        }
+                        else
+                        {
+                            lexer.tokenize(*tokens);
+                        }
 
-                while (true)
-                {
-                    Tokens token = lexer.next_tk();
+                        if (options.parse_threads != 1)
+                        {
+                            ParallelParser pparser(*tokens, arena, options.parse_threads);
+                            pparser.deferBodies(lazy);
+                            pparser.maxDepth(options.max_nesting);
+                            nodes = pparser.Parse();
+                        }
+                        else
+                        {
+                            Rythin::Parser parser(*tokens, arena);
+                            parser.deferBodies(lazy);
+                            parser.maxDepth(options.max_nesting);
+                            nodes = parser.Parse();
+                        }
+                    }
+
+                    // the constant expressions are done once here, not at every run of the code
+                    ConstantFolder folder(arena);
+                    for (ASTPtr &stmts : nodes)
+                    {
+                        stmts = folder.fold(stmts);
+                    }
 
-                    tokens.push_back(token);
+                    // a lazy body is folded when it's loaded, with the constants declared before its function
+                    Rythin::SemanticAnalyzer analyzer([&](FunctionDefinitionNode &func) {
+                        func.block = Parser::ParseBody(*tokens, arena, func, options.max_nesting);
+                        folder.foldBody(func);
+                        return func.block;
+                    });
+                    analyzer.keepSymbols(options.dump_symbols);
+                    for (ASTPtr stmts : nodes)
+                    {
+                        analyzer.VisitNode(stmts);
+                    }
+                    analyzer.checkDeferred(false);
+                    if (options.dump_symbols)
+                    {
+                        analyzer.dumpSymbols(std::cout);
+                    }
 
-                    if (token.type == TokensTypes::TOKEN_EOF)
-                        break;
+                    // every expression gets its static type, and the unit its typed IR
+                    IrUnit ir;
+                    TypeChecker checker(ir);
+                    checker.check(nodes);
+                    if (options.dump_ir)
+                    {
+                        ir.dump(std::cout);
+                    }
                 }
-                Rythin::Parser parser(tokens);
-                std::vector<ASTPtr> nodes = parser.Parse();
+                LogErrors::getInstance().replay(diagnostics);
 
-                Rythin::SemanticAnalyzer analyzer; 
-                for (ASTPtr &stmts : nodes)
+                // only a whole unit with no errors is cached, a lazy run is never stored (the bodies not called were not checked)
+                bool failed = std::any_of(diagnostics.begin(), diagnostics.end(), [](const LogErrors::Held &d) { return !d.warning; });
+                if (cache.enabled() && !failed && !lazy)
                 {
-                    analyzer.VisitNode(stmts);
+                    for (ASTPtr stmts : nodes)
+                    {
+                        flat.append(stmts);
+                    }
+                    cache.store(source.view(), flat, diagnostics);
                 }
             }
             else
@@ -97,14 +198,84 @@ void printHelp()
     std::cout << "\t[-f] [--file] [file-path/file-name] to execute a rhythin file." << std::endl;
     std::cout << "\t[-h] [--help] to see this list." << std::endl;
     std::cout << "\t[-v] [--version] to see the version of the Rhythin" << std::endl;
+    std::cout << "Options (after the file):" << std::endl;
+    std::cout << "\t[--stream] lexes the tokens on demand while parsing (constant memory for the tokens)." << std::endl;
+    std::cout << "\t[--lex-threads N] lexes big files on N threads (0 = one per core, default 1)." << std::endl;
+    std::cout << "\t[--parse-threads N] parses the top level items of big files on N threads (0 = one per core, default 1)." << std::endl;
+    std::cout << "\t[--lazy] parses and checks a function body only when the function is called (and 'main')." << std::endl;
+    std::cout << "\t[--check-all] parses and checks every body, even with --lazy (for CI)." << std::endl;
+    std::cout << "\t[--dump-symbols] prints the variables and functions found by the semantic pass." << std::endl;
+    std::cout << "\t[--dump-ir] prints the typed IR made by the type pass." << std::endl;
+    std::cout << "\t[--max-nesting N] most blocks nested inside each other (1 to " << Rythin::Parser::deepest_max_depth << ", default " << Rythin::Parser::default_max_depth << ")." << std::endl;
+    std::cout << "\t[--no-cache] doesn't use the cache of checked files ($RHYTHIN_CACHE_DIR, default ~/.cache/rhythin)." << std::endl;
+}
+
+// the N of "--flag N" at argv[i] (min to max), skipping it on argv. false if it's missing or not a number
+static bool numberOption(int argc, char *argv[], int &i, long min, long max, const char *what, unsigned &out)
+{
+    char *end = nullptr;
+    long n = (i + 1 < argc) ? strtol(argv[i + 1], &end, 10) : -1;
+    if (end == nullptr || end == argv[i + 1] || *end != '\0' || n < min || n > max)
+    {
+        LogErrors::getInstance().addWarning(std::string(argv[i]) + " needs " + what + " (" + std::to_string(min) + " to " + std::to_string(max) + "), ignored", 7, 0, 0);
+        return false;
+    }
+    out = static_cast<unsigned>(n);
+    i++;
+    return true;
 }
 
-int executeRun(char *argv[])
+int executeRun(int argc, char *argv[])
 {
     if (argv[2] != NULL)
     {
+        Rythin::RunOptions options;
+        for (int i = 3; i < argc; i++)
+        {
+            if (strcmp(argv[i], "--stream") == 0)
+            {
+                options.stream = true;
+            }
+            else if (strcmp(argv[i], "--no-cache") == 0)
+            {
+                options.cache = false;
+            }
+            else if (strcmp(argv[i], "--lazy") == 0)
+            {
+                options.lazy = true;
+            }
+            else if (strcmp(argv[i], "--check-all") == 0)
+            {
+                options.check_all = true;
+            }
+            else if (strcmp(argv[i], "--dump-symbols") == 0)
+            {
+                options.dump_symbols = true;
+            }
+            else if (strcmp(argv[i], "--dump-ir") == 0)
+            {
+                options.dump_ir = true;
+            }
+            else if (strcmp(argv[i], "--lex-threads") == 0)
+            {
+                numberOption(argc, argv, i, 0, 256, "a number of threads", options.lex_threads);
+            }
+            else if (strcmp(argv[i], "--parse-threads") == 0)
+            {
+                numberOption(argc, argv, i, 0, 256, "a number of threads", options.parse_threads);
+            }
+            else if (strcmp(argv[i], "--max-nesting") == 0)
+            {
+                numberOption(argc, argv, i, 1, static_cast<long>(Rythin::Parser::deepest_max_depth), "a number of levels", options.max_nesting);
+            }
+            else
+            {
+                LogErrors::getInstance().addWarning("Unknown option '" + std::string(argv[i]) + "' ignored", 7, 0, 0);
+            }
+        }
+
         Rythin::MainExecutor a;
-        a.Run(argv[2]);
+        a.Run(argv[2], options);
         if (LogErrors::getInstance().hasErrorsAndWarns() and LogErrors::getInstance().getErrSize() != 0)
         {
 
@@ -199,11 +370,11 @@ int main(int argc, char *argv[])
     }
     else if (argc > 1 && strcmp(argv[1], "-f") == 0)
     {
-        return executeRun(argv);
+        return executeRun(argc, argv);
     }
     else if (argc > 1 && strcmp(argv[1], "--file") == 0)
     {
-        return executeRun(argv);
+        return executeRun(argc, argv);
     }
     else if (argc > 1 && strcmp(argv[1], "-v") == 0)
     {
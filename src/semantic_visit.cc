@@ -14,7 +14,8 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include "../src/includes/semantic_visitor.hpp"
-#include <iostream>
+#include <algorithm>
+#include <ostream>
 
 // TODO: add more analyses for semantic analyzer!
 
@@ -22,74 +23,219 @@ namespace Rythin
 {
     void SemanticAnalyzer::Visit(VariableDefinitionNode &node)
     {
-        if (var_table.find(node.var_name) != var_table.end())
+        // a name can hide the one of an outer block, not another of its own block
+        Binding var;
+        var.type = node.type;
+        if (!scopes.declare(node.var_name, var))
         {
-            LogErrors::getInstance().addError("Variable name '" + node.var_name + "' already set!", 76, 0, 0);
+            LogErrors::getInstance().addError("Variable name '" + Interner::getInstance().str(node.var_name) + "' already set!", 76, 0, 0);
             return;
         }
 
-        var_table.insert(std::make_pair(node.var_name, node.type));
-        var_values.insert(std::make_pair(node.var_name, node.val));
+        if (keep_symbols)
+            symbols.push_back(&node);
         VisitNode(node.val);
     }
 
     void SemanticAnalyzer::Visit(VariableNode &node)
     {
-        if (var_table.find(node.name) == var_table.end())
+        const auto *var = scopes.find(node.name);
+        if (!var)
         {
-            LogErrors::getInstance().addError("Variable '" + node.name + "' not declared!", 67, 0, 0);
+            LogErrors::getInstance().addError("Variable '" + Interner::getInstance().str(node.name) + "' not declared!", 67, 0, 0);
             return;
         }
 
-        for (auto stmts : var_values) {
-            if (auto var = std::dynamic_pointer_cast<TrueOrFalseNode>(stmts.second))
-            {
-                std::cout << "Name: " << stmts.first << " value: " << var->val << std::endl;
-            }
-            if (auto var = std::dynamic_pointer_cast<LiteralNode>(stmts.second)) 
+        // the slots of a function start at its first argument, the ones of the top level at the first global
+        uint32_t base = 0;
+        auto func = std::upper_bound(function_frames.begin(), function_frames.end(), var->frame);
+        if (func != function_frames.begin())
+            base = scopes.first(*(func - 1));
+        node.slot = scopes.slot(*var) - base;
+        node.global = var->frame == 0;
+        node.type = var->value.type;
+    }
+
+    void SemanticAnalyzer::Visit(BinOp &node)
+    {
+        // the operands left to right on a stack, a generated chain of operators would nest
+        // a call per operator (only the ones that aren't operators are visited)
+        std::size_t base = operands.size();
+        operands.push_back(&node);
+        while (operands.size() > base)
+        {
+            ASTPtr next = operands.back();
+            operands.pop_back();
+            if (auto op = nodeAs<BinOp>(next))
             {
-                std::cout << "Name: " << stmts.first << " value: " << var->val << std::endl;
+                operands.push_back(op->right);
+                operands.push_back(op->left);
+                continue;
             }
-             if (auto var = std::dynamic_pointer_cast<InterpolationNode>(stmts.second)) 
-            {
-                std::cout << "Name: " << stmts.first << " Variable called: " << var->var_name << std::endl;
+            VisitNode(next);
+        }
+    }
 
-            }
-            if (auto var = std::dynamic_pointer_cast<f32Node>(stmts.second)) 
-            {
-                std::cout << "Name: " << stmts.first << " Value: " << var->val << std::endl;
+    void SemanticAnalyzer::Visit(FunctionDefinitionNode &node)
+    {
+        // bound before the body, so it can call itself
+        Binding func;
+        func.function = true;
+        func.type = node.type;
+        func.definition = &node;
+        if (!scopes.declare(node.var_name, func))
+        {
+            LogErrors::getInstance().addError("The name '" + Interner::getInstance().str(node.var_name) + "' already set and it's a " + Tokens::tokenTypeToString(node.type) + "!", 78, 0, 0);
+            return;
+        }
+        if (keep_symbols)
+            symbols.push_back(&node);
+        if (node.deferred())
+        {
+            deferred.push_back({&node, scopes.top(), static_cast<uint32_t>(scopes.size() - 1)});
+            return;
+        }
+        checkFunction(node, scopes.top());
+    }
 
-            }
-            if (auto var = std::dynamic_pointer_cast<BinOp>(stmts.second)) 
-            {
-                // std::cout << "Name: " << stmts.first << " Left value: " << Tokens::tokenTypeToString(var->op) << std::endl;
-                if (auto val_left = std::dynamic_pointer_cast<i32Node>(var->left))
-                {
-                    std::cout << "Value left: " << val_left->val << "\n";
-                }
-            }
+    void SemanticAnalyzer::checkFunction(FunctionDefinitionNode &node, uint32_t parent)
+    {
+        // the arguments and the top of the body share a frame, a local can't hide an argument
+        scopes.push(parent);
+        function_frames.push_back(scopes.top());
+        for (ASTPtr arg : node.args)
+        {
+            auto expr = nodeAs<ExpressionNode>(arg);
+            if (!expr)
+                continue;
+            Binding var;
+            var.type = expr->type;
+            if (!scopes.declare(expr->var_name, var))
+                LogErrors::getInstance().addError("Variable name '" + Interner::getInstance().str(expr->var_name) + "' already set!", 76, 0, 0);
+        }
+        if (auto block = nodeAs<BlockNode>(node.block))
+        {
+            for (ASTPtr stmt : block->statements)
+                VisitNode(stmt);
         }
-        
+        function_frames.pop_back();
+        scopes.pop();
     }
 
+    void SemanticAnalyzer::Visit(BlockNode &node)
+    {
+        scopes.push();
+        for (ASTPtr stmt : node.statements)
+            VisitNode(stmt);
+        scopes.pop();
+    }
 
-    void SemanticAnalyzer::Visit(BinOp &node)
+    void SemanticAnalyzer::Visit(IfStatement &node)
     {
-        VisitNode(node.left);
-        VisitNode(node.right);
-        
+        VisitNode(node.ifCondition);
+        VisitNode(node.ifBranch);
+        VisitNode(node.butCondition);
+        VisitNode(node.butBranch);
     }
 
-    void SemanticAnalyzer::Visit(FunctionDefinitionNode &node)
+    void SemanticAnalyzer::Visit(IfExpressionNode &node)
     {
-        if (var_table.find(node.var_name) != var_table.end())
-        {
-            LogErrors::getInstance().addError("The name '" + node.var_name + "' already set and it's a " + Tokens::tokenTypeToString(node.type) + "!", 78, 0, 0);
+        // `name op value`, or a bool literal with no name
+        if (node.var_name != Interner::empty && !scopes.find(node.var_name))
+            LogErrors::getInstance().addError("Variable '" + Interner::getInstance().str(node.var_name) + "' not declared!", 67, 0, 0);
+        VisitNode(node.val);
+    }
+
+    void SemanticAnalyzer::Visit(LoopNode &node)
+    {
+        VisitNode(node.value);
+        scopes.push();
+        Binding var;
+        var.type = node.type;
+        scopes.declare(node.var_name, var);
+        VisitNode(node.block);
+        scopes.pop();
+    }
+
+    void SemanticAnalyzer::Visit(LoopConditionNode &node)
+    {
+        VisitNode(node.condition);
+        VisitNode(node.body);
+    }
+
+    void SemanticAnalyzer::Visit(ObjectNode &node)
+    {
+        // only the calls for now, the other objects are not checked yet
+        if (auto call = nodeAs<IdentifierNode>(node.val))
+            Visit(*call);
+    }
+
+    void SemanticAnalyzer::Visit(IdentifierNode &node)
+    {
+        auto callee = scopes.find(node.name);
+        if (callee && callee->value.function && callee->value.definition)
+            checkBody(*callee->value.definition, callee->frame, scopes.slot(*callee));
+    }
+
+    void SemanticAnalyzer::checkBody(FunctionDefinitionNode &node, uint32_t parent, uint32_t slot)
+    {
+        if (!node.deferred())
             return;
+        ASTPtr block = load_body ? load_body(node) : nullptr;
+        // loaded once, even with errors, and a recursive call finds it not deferred anymore
+        node.block = block;
+        node.body_end = 0;
+        auto hidden = scopes.hide(slot + 1, static_cast<uint32_t>(scopes.size()));
+        checkFunction(node, parent);
+        scopes.hide(hidden.first, hidden.second);
+    }
+
+    void SemanticAnalyzer::checkDeferred(bool all)
+    {
+        for (const Deferred &d : deferred)
+        {
+            // (the frame of a nested declaration may be closed by now, its body sees the globals)
+            if (!all && Interner::getInstance().spelling(d.func->var_name) != "main")
+                continue;
+            if (d.frame <= scopes.top())
+                checkBody(*d.func, d.frame, d.slot);
+            else
+                checkBody(*d.func, 0, static_cast<uint32_t>(scopes.size()));
         }
+    }
 
-        var_table.insert(std::make_pair(node.var_name, node.type));
-        func_table.insert(std::make_pair(node.var_name, node.type));
-        VisitNode(node.block);
+    void SemanticAnalyzer::dumpSymbols(std::ostream &out) const
+    {
+        for (ASTPtr symbol : symbols)
+        {
+            if (auto func = nodeAs<FunctionDefinitionNode>(symbol))
+            {
+                out << "func " << Interner::getInstance().spelling(func->var_name) << ": " << Tokens::tokenTypeToString(func->type)
+                    << " (" << func->args.size() << " args)\n";
+                continue;
+            }
+            auto var = static_cast<VariableDefinitionNode *>(symbol);
+            out << "var  " << Interner::getInstance().spelling(var->var_name) << ": " << Tokens::tokenTypeToString(var->type);
+            ASTPtr value = var->val;
+            if (auto v = nodeAs<TrueOrFalseNode>(value))
+                out << " = " << (v->val ? "true" : "false");
+            else if (auto v = nodeAs<LiteralNode>(value))
+                out << " = \"" << v->val << "\"";
+            else if (auto v = nodeAs<i32Node>(value))
+                out << " = " << v->val;
+            else if (auto v = nodeAs<i64Node>(value))
+                out << " = " << v->val;
+            else if (auto v = nodeAs<f32Node>(value))
+                out << " = " << v->val;
+            else if (auto v = nodeAs<f64Node>(value))
+                out << " = " << v->val;
+            else if (auto v = nodeAs<ByteNode>(value))
+                out << " = " << static_cast<int>(v->byte);
+            else if (auto v = nodeAs<VariableNode>(value))
+                out << " = " << Interner::getInstance().spelling(v->name);
+            else if (auto v = nodeAs<InterpolationNode>(value))
+                out << " = $[" << Interner::getInstance().spelling(v->var_name) << "]";
+            out << "\n";
+        }
     }
-}
\ No newline at end of file
+}
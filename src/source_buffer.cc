@@ -0,0 +1,186 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <fstream>
+#include <utility>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// local includes
+#include "../src/includes/source_buffer.hpp"
+
+namespace Rythin
+{
+    SourceBuffer::~SourceBuffer()
+    {
+        release();
+    }
+
+    SourceBuffer::SourceBuffer(SourceBuffer &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    SourceBuffer &SourceBuffer::operator=(SourceBuffer &&other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        release();
+        from = other.from;
+        length = other.length;
+        owned = std::move(other.owned);
+        // the streamed storage may be on the small string buffer, so the pointer must be taken again
+        data = (from == Origin::STREAMED) ? owned.data() : other.data;
+#if defined(_WIN32)
+        file_handle = other.file_handle;
+        map_handle = other.map_handle;
+        other.file_handle = nullptr;
+        other.map_handle = nullptr;
+#endif
+        other.data = nullptr;
+        other.length = 0;
+        other.from = Origin::NONE;
+        return *this;
+    }
+
+    void SourceBuffer::release()
+    {
+        if (from == Origin::MAPPED && data != nullptr)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(data);
+            CloseHandle(static_cast<HANDLE>(map_handle));
+            CloseHandle(static_cast<HANDLE>(file_handle));
+            map_handle = nullptr;
+            file_handle = nullptr;
+#else
+            munmap(const_cast<char *>(data), length);
+#endif
+        }
+        owned.clear();
+        owned.shrink_to_fit();
+        data = nullptr;
+        length = 0;
+        from = Origin::NONE;
+    }
+
+    bool SourceBuffer::load(const std::string &path)
+    {
+        release();
+        if (map(path))
+            return true;
+        return loadStreamed(path);
+    }
+
+#if defined(_WIN32)
+    bool SourceBuffer::map(const std::string &path)
+    {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER file_size;
+        // only disk files can be mapped, and a zero sized mapping is rejected by the api
+        if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        data = static_cast<const char *>(view);
+        length = static_cast<std::size_t>(file_size.QuadPart);
+        file_handle = file;
+        map_handle = mapping;
+        from = Origin::MAPPED;
+        return true;
+    }
+#else
+    bool SourceBuffer::map(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        // pipes and devices have no fixed size, and mmap of 0 bytes is an error
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void *addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+        if (addr == MAP_FAILED)
+            return false;
+
+    #if defined(MADV_SEQUENTIAL)
+        // the lexer reads it front to back only once
+        madvise(addr, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+    #endif
+
+        data = static_cast<const char *>(addr);
+        length = static_cast<std::size_t>(st.st_size);
+        from = Origin::MAPPED;
+        return true;
+    }
+#endif
+
+    bool SourceBuffer::loadStreamed(const std::string &path)
+    {
+        release();
+
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        // the whole file is kept as is (blank lines included) so the line numbers stay right
+        char chunk[64 * 1024];
+        while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+        {
+            owned.append(chunk, static_cast<std::size_t>(file.gcount()));
+        }
+
+        data = owned.data();
+        length = owned.size();
+        from = Origin::STREAMED;
+        return true;
+    }
+}
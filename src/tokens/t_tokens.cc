@@ -14,6 +14,7 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include "t_tokens.hpp"
+#include "../lexer/keywords.hpp"
 #include <string>
 #include <cctype>
 #include <iostream>
@@ -108,89 +109,18 @@ std::string Tokens::tokenTypeToString(TokensTypes type)
         return "~";
     case TokensTypes::TOKEN_BIT_XOR:
         return "^";
+    case TokensTypes::TOKEN_INTERP_START:
+        return "$[";
+    case TokensTypes::TOKEN_INTERP_END:
+        return "interpolation end";
 
-    // keywords
-    case TokensTypes::TOKEN_PARALLEL:
-        return "parallel";
-    case TokensTypes::TOKEN_USING:
-        return "using";
-    case TokensTypes::TOKEN_CONST:
-        return "const";
-    case TokensTypes::TOKEN_FINISH:
-        return "finish";
-    case TokensTypes::TOKEN_DEF:
-        return "def";
-    case TokensTypes::TOKEN_LET:
-        return "let";
-    case TokensTypes::TOKEN_FROM:
-        return "from";
-    case TokensTypes::TOKEN_GET:
-        return "get";
-    case TokensTypes::TOKEN_LOOP:
-        return "loop";
-    case TokensTypes::TOKEN_IN:
-        return "in";
-    case TokensTypes::TOKEN_STOP:
-        return "stop";
-    case TokensTypes::TOKEN_CONTINUE:
-        return "continue";
-    case TokensTypes::TOKEN_IF:
-        return "if";
-    case TokensTypes::TOKEN_BUT:
-        return "but";
-    case TokensTypes::TOKEN_TRY:
-        return "try";
-    case TokensTypes::TOKEN_CATCH:
-        return "catch";
-    case TokensTypes::TOKEN_RETURN:
-        return "return";
-    case TokensTypes::TOKEN_ALLOC:
-        return "alloc";
-    case TokensTypes::TOKEN_FLUSH:
-        return "flush";
-    case TokensTypes::TOKEN_FWRITE:
-        return "fwrite";
-    case TokensTypes::TOKEN_FREAD:
-        return "fread";
-    case TokensTypes::TOKEN_MKDIR:
-        return "mkdir";
-    case TokensTypes::TOKEN_LEN:
-        return "len";
-    case TokensTypes::TOKEN_INT_32:
-        return "int32";
-    case TokensTypes::TOKEN_INT_64:
-        return "int64";
-    case TokensTypes::TOKEN_BOOL:
-        return "bool";
-    case TokensTypes::TOKEN_FUNC:
-        return "func";
-    case TokensTypes::TOKEN_CHARSEQ:
-        return "char";
-    case TokensTypes::TOKEN_FLOAT_32:
-        return "float32";
-    case TokensTypes::TOKEN_FLOAT_64:
-        return "float64";
-    case TokensTypes::TOKEN_OBJECT:
-        return "obj";
-    case TokensTypes::TOKEN_BYTES:
-        return "byte";
-    case TokensTypes::TOKEN_PRINT:
-        return "print";
-    case TokensTypes::TOKEN_PRINT_NEW_LINE:
-        return "printnl";
-    case TokensTypes::TOKEN_PRINT_ERROR:
-        return "printe";
-    case TokensTypes::TOKEN_CINPUT:
-        return "cinput";
-    case TokensTypes::TOKEN_TRUE:
-        return "true";
-    case TokensTypes::TOKEN_FALSE:
-        return "false";
-    case TokensTypes::TOKEN_HAS:
-        return "has";
-    case TokensTypes::TOKEN_NIL:
-        return "nil";
     default:
-        return "Unknown Token\n";
+        break;
     }
+
+    // keywords (the spelling comes from the keyword list of the lexer)
+    std::string_view keyword = Rythin::Keywords::spelling(type);
+    if (!keyword.empty())
+        return std::string(keyword);
+    return "Unknown Token\n";
 }
\ No newline at end of file
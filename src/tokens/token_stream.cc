@@ -0,0 +1,112 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <utility>
+
+#include "token_stream.hpp"
+
+namespace Rythin
+{
+    void TokenStream::reserve(std::size_t count)
+    {
+        types.reserve(count);
+        offsets.reserve(count);
+        lengths.reserve(count);
+    }
+
+    void TokenStream::push(RawToken &&tk)
+    {
+        types.push_back(static_cast<uint8_t>(tk.type));
+        offsets.push_back(tk.offset);
+
+        if (tk.type == TokensTypes::TOKEN_IDENTIFIER)
+        {
+            lengths.push_back(Interner::getInstance().intern(src.substr(tk.offset, tk.length)));
+        }
+        else if (hasPayload(tk.type))
+        {
+            lengths.push_back(static_cast<uint32_t>(payloads.size()));
+            payloads.push_back(Payload{tk.length, std::move(tk.text)});
+        }
+        else if (isNumber(tk.type, firstChar(tk.offset)))
+        {
+            lengths.push_back(static_cast<uint32_t>(numbers.size()));
+            numbers.push_back(Literal{tk.length, tk.number});
+        }
+        else
+        {
+            lengths.push_back(tk.length);
+        }
+    }
+
+    TokenView TokenStream::at(std::size_t i) const
+    {
+        TokensTypes tk = type(i);
+        std::string_view value;
+        Number number = {0};
+        Symbol symbol = Interner::empty;
+        uint32_t end = offsets[i];
+        if (tk == TokensTypes::TOKEN_IDENTIFIER)
+        {
+            symbol = lengths[i];
+            value = Interner::getInstance().spelling(symbol);
+            end += static_cast<uint32_t>(value.size());
+        }
+        else if (hasPayload(tk))
+        {
+            const Payload &p = payloads[lengths[i]];
+            value = p.text;
+            end += p.length;
+        }
+        else
+        {
+            uint32_t length = lengths[i];
+            if (isNumber(tk, firstChar(offsets[i])))
+            {
+                const Literal &lit = numbers[lengths[i]];
+                length = lit.length;
+                number = lit.number;
+            }
+            if (offsets[i] < src.size())
+                value = src.substr(offsets[i], length);
+            end += length;
+        }
+        return TokenView{tk, value, SourceLocation{&lines, end}, number, symbol};
+    }
+
+    std::string_view TokenStream::text(std::size_t first, std::size_t last) const
+    {
+        if (first > last || last >= size() || offsets[first] > src.size())
+            return {};
+        std::size_t end = std::min<std::size_t>(at(last).where.offset, src.size());
+        return src.substr(offsets[first], end - offsets[first]);
+    }
+
+    std::size_t TokenStream::memoryUsage() const
+    {
+        std::size_t bytes = types.capacity() * sizeof(uint8_t) +
+                            offsets.capacity() * sizeof(uint32_t) +
+                            lengths.capacity() * sizeof(uint32_t) +
+                            numbers.capacity() * sizeof(Literal);
+        for (const Payload &p : payloads)
+        {
+            bytes += sizeof(Payload);
+            if (p.text.capacity() > 15) // the text is out of the small string buffer
+                bytes += p.text.capacity() + 1;
+        }
+        return bytes;
+    }
+}
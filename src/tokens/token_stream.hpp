@@ -0,0 +1,131 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TOKEN_STREAM_HPP
+#define TOKEN_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../includes/interner.hpp"
+#include "../includes/line_index.hpp"
+#include "../lexer/lex_types.hpp"
+
+namespace Rythin
+{
+    // binary value of a numeric literal, decoded once by the lexer
+    union Number
+    {
+        int64_t integer; // TOKEN_INT_32 and TOKEN_INT_64
+        double real;     // TOKEN_FLOAT_32 and TOKEN_FLOAT_64 (float32 values are exact on the double)
+    };
+
+    // a token as it leaves the lexer, before going to the stream
+    struct RawToken
+    {
+        TokensTypes type;
+        uint32_t offset; // first byte of the token on the source
+        uint32_t length; // bytes of the source covered by the token
+        std::string text; // decoded value, only used by tokens with payload (string literals)
+        Number number = {0}; // only used by numeric literals
+    };
+
+    // cheap copyable view of one token of a TokenStream
+    struct TokenView
+    {
+        TokensTypes type;
+        std::string_view value; // slice of the source or of the payload table
+        SourceLocation where;   // end of the token, what the errors report
+        Number number = {0};    // decoded value of numeric literals
+        Symbol symbol = Interner::empty; // interned name of identifiers
+    };
+
+    /**
+     * @brief the token list of a source, stored as struct-of-arrays
+     *
+     * Each token costs a type byte, a 32-bit offset and a 32-bit length.
+     * Values are not copied: they are slices of the source, and line:column
+     * are only computed (through the LineIndex) when an error is reported.
+     * Tokens whose value differs from the source text (string literals with
+     * escapes) keep the decoded text in a side table, and numeric literals keep
+     * their binary value in another one. For both the length column holds the
+     * index on the table instead. Identifiers are interned when pushed and
+     * their length column holds the symbol id (the length is the spelling's).
+     * The source must outlive the stream.
+     **/
+    class TokenStream
+    {
+    public:
+        explicit TokenStream(std::string_view source) : src(source), lines(source) {}
+
+        void reserve(std::size_t count);
+        void push(RawToken &&tk);
+
+        std::size_t size() const { return types.size(); }
+        bool empty() const { return types.empty(); }
+        TokensTypes type(std::size_t i) const { return static_cast<TokensTypes>(types[i]); }
+        TokenView at(std::size_t i) const;
+        // the source text of the tokens [first, last], from the start of first to the end of last
+        std::string_view text(std::size_t first, std::size_t last) const;
+        std::string_view source() const { return src; }
+        const LineIndex &lineIndex() const { return lines; }
+
+        // bytes held by the stream (arrays capacity + payloads)
+        std::size_t memoryUsage() const;
+
+        static bool hasPayload(TokensTypes type)
+        {
+            return type == TokensTypes::TOKEN_STRING_LITERAL;
+        }
+
+        // the type keywords (int32, float64...) share these types with the literals,
+        // a literal is told apart by its first char
+        static bool isNumber(TokensTypes type, char first)
+        {
+            bool numeric = type == TokensTypes::TOKEN_INT_32 || type == TokensTypes::TOKEN_INT_64 ||
+                           type == TokensTypes::TOKEN_FLOAT_32 || type == TokensTypes::TOKEN_FLOAT_64;
+            return numeric && ((first >= '0' && first <= '9') || first == '.');
+        }
+
+    private:
+        char firstChar(uint32_t offset) const { return offset < src.size() ? src[offset] : '\0'; }
+
+        struct Payload
+        {
+            uint32_t length; // source length of the token
+            std::string text;
+        };
+
+        std::string_view src;
+        std::vector<uint8_t> types;
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> lengths; // payload index for tokens with payload
+        struct Literal
+        {
+            uint32_t length; // source length of the token
+            Number number;
+        };
+
+        std::deque<Payload> payloads; // deque: views into it stay valid while it grows
+        std::vector<Literal> numbers;
+        LineIndex lines;
+    };
+}
+
+#endif // TOKEN_STREAM_HPP
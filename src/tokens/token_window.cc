@@ -0,0 +1,101 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <utility>
+
+#include "token_window.hpp"
+#include "../lexer/r_lex.hpp"
+
+namespace Rythin
+{
+    namespace
+    {
+        std::size_t powerOfTwo(std::size_t n)
+        {
+            std::size_t size = 2;
+            while (size < n)
+                size <<= 1;
+            return size;
+        }
+    }
+
+    TokenWindow::TokenWindow(Lexer &lexer, std::string_view source, std::size_t capacity)
+        : lexer(lexer), src(source), lines(source), ring(powerOfTwo(capacity)), mask(ring.size() - 1)
+    {
+    }
+
+    void TokenWindow::pull()
+    {
+        // the slot of the new token still holds one the parser may go back to
+        if (pulled > keep && pulled - keep >= ring.size())
+            grow();
+
+        RawToken tk = lexer.next_tk();
+        Slot &slot = ring[pulled & mask];
+        slot.type = tk.type;
+        slot.offset = tk.offset;
+        slot.length = tk.length;
+        slot.text = std::move(tk.text);
+        slot.number = tk.number;
+        slot.symbol = (tk.type == TokensTypes::TOKEN_IDENTIFIER) ? Interner::getInstance().intern(src.substr(tk.offset, tk.length)) : Interner::empty;
+        if (tk.type == TokensTypes::TOKEN_EOF)
+            eof = pulled;
+        pulled++;
+    }
+
+    void TokenWindow::grow()
+    {
+        std::vector<Slot> bigger(ring.size() * 2);
+        std::size_t bigger_mask = bigger.size() - 1;
+        std::size_t first = pulled > ring.size() ? pulled - ring.size() : 0;
+        for (std::size_t i = first; i < pulled; i++)
+            bigger[i & bigger_mask] = std::move(ring[i & mask]);
+        ring = std::move(bigger);
+        mask = bigger_mask;
+    }
+
+    TokenView TokenWindow::at(std::size_t i)
+    {
+        while (pulled <= i && eof == SIZE_MAX)
+            pull();
+        if (i > eof)
+            i = eof;
+
+        const Slot &slot = ring[i & mask];
+        std::string_view value;
+        if (TokenStream::hasPayload(slot.type))
+            value = slot.text;
+        else if (slot.offset < src.size())
+            value = src.substr(slot.offset, slot.length);
+        return TokenView{slot.type, value, SourceLocation{&lines, slot.offset + static_cast<std::size_t>(slot.length)}, slot.number, slot.symbol};
+    }
+
+    void TokenWindow::keepFrom(std::size_t i)
+    {
+        if (i > keep)
+            keep = i;
+    }
+
+    std::size_t TokenWindow::memoryUsage() const
+    {
+        std::size_t bytes = ring.capacity() * sizeof(Slot);
+        for (const Slot &slot : ring)
+        {
+            if (slot.text.capacity() > 15) // the text is out of the small string buffer
+                bytes += slot.text.capacity() + 1;
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,89 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TOKEN_WINDOW_HPP
+#define TOKEN_WINDOW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../includes/line_index.hpp"
+#include "../lexer/lex_types.hpp"
+#include "token_stream.hpp"
+
+namespace Rythin
+{
+    class Lexer;
+
+    /**
+     * @brief the streaming mode of the token list: a ring of the last tokens
+     *
+     * Tokens are pulled from the lexer only when the parser asks for them, and
+     * are dropped once the parser moves past its backtracking point (keepFrom),
+     * so the memory doesn't depend on the file size and lexing is interleaved
+     * with parsing. The ring starts with the lookahead the grammar needs and
+     * only grows if the parser asks for a token past it.
+     * A TokenView taken from the window is valid until the slot is reused, so
+     * copy the value before asking for `capacity()` tokens more.
+     **/
+    class TokenWindow
+    {
+    public:
+        // deepest access of the grammar around the current token: consume() looks one
+        // back and the 'loop' case peeks five ahead
+        static constexpr std::size_t lookahead = 8;
+
+        TokenWindow(Lexer &lexer, std::string_view source, std::size_t capacity = lookahead);
+
+        // token i of the source, lexed on demand (past the end it's the EOF token)
+        TokenView at(std::size_t i);
+        // the parser won't go back before i, those tokens can be dropped
+        void keepFrom(std::size_t i);
+
+        std::size_t capacity() const { return ring.size(); }
+        // tokens pulled from the lexer so far
+        std::size_t lexed() const { return pulled; }
+        // bytes held by the ring (slots + payloads)
+        std::size_t memoryUsage() const;
+
+    private:
+        struct Slot
+        {
+            TokensTypes type;
+            uint32_t offset;
+            uint32_t length; // source length, even for tokens with payload
+            std::string text;
+            Number number;
+            Symbol symbol;
+        };
+
+        void pull();
+        void grow();
+
+        Lexer &lexer;
+        std::string_view src;
+        LineIndex lines;
+        std::vector<Slot> ring; // token i lives on ring[i & mask]
+        std::size_t mask;
+        std::size_t pulled = 0;
+        std::size_t keep = 0;
+        std::size_t eof = SIZE_MAX; // index of the EOF token, once lexed
+    };
+}
+
+#endif // TOKEN_WINDOW_HPP
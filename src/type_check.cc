@@ -0,0 +1,1044 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "../src/includes/type_checker.hpp"
+
+#include <algorithm>
+
+#include "../src/includes/log.hpp"
+#include "../src/tokens/t_tokens.hpp"
+
+using namespace Log;
+
+namespace Rythin
+{
+    static constexpr uint32_t none = IrInst::none;
+
+    // the type both operands are taken to (the order of ValueType is the promotion order)
+    static ValueType widest(ValueType a, ValueType b)
+    {
+        return std::max(a, b);
+    }
+
+    // arithmetic is done on int32 at least, as in C
+    static ValueType promoted(ValueType type)
+    {
+        return std::max(type, ValueType::INT);
+    }
+
+    static bool isNumericLiteral(ASTPtr node)
+    {
+        switch (node->kind)
+        {
+        case NodeKind::I32:
+        case NodeKind::I64:
+        case NodeKind::F32:
+        case NodeKind::F64:
+        case NodeKind::BYTE:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // the number of a literal on integer, or on real for F32 and F64 (then it returns true)
+    static bool literalOf(ASTPtr node, int64_t &integer, double &real)
+    {
+        switch (node->kind)
+        {
+        case NodeKind::I32: integer = static_cast<i32Node *>(node)->val; return false;
+        case NodeKind::I64: integer = static_cast<i64Node *>(node)->val; return false;
+        case NodeKind::BYTE: integer = static_cast<ByteNode *>(node)->byte; return false;
+        case NodeKind::F32: real = static_cast<f32Node *>(node)->val; return true;
+        default: real = static_cast<f64Node *>(node)->val; return true;
+        }
+    }
+
+    static IrOp binaryOp(TokensTypes op)
+    {
+        switch (op)
+        {
+        case TokensTypes::TOKEN_PLUS: return IrOp::ADD;
+        case TokensTypes::TOKEN_MINUS: return IrOp::SUB;
+        case TokensTypes::TOKEN_MULTIPLY: return IrOp::MUL;
+        case TokensTypes::TOKEN_DIVIDE: return IrOp::DIV;
+        case TokensTypes::TOKEN_MODULO: return IrOp::MOD;
+        case TokensTypes::TOKEN_REF: return IrOp::BIT_AND; // '&' after an operand
+        case TokensTypes::TOKEN_BIT_OR: return IrOp::BIT_OR;
+        case TokensTypes::TOKEN_BIT_XOR: return IrOp::BIT_XOR;
+        case TokensTypes::TOKEN_SHIFT_LEFT: return IrOp::SHL;
+        case TokensTypes::TOKEN_SHIFT_RIGHT: return IrOp::SHR;
+        case TokensTypes::TOKEN_EQUAL: return IrOp::EQ;
+        case TokensTypes::TOKEN_NOT_EQUAL: return IrOp::NE;
+        case TokensTypes::TOKEN_LESS_THAN: return IrOp::LT;
+        case TokensTypes::TOKEN_LESS_EQUAL: return IrOp::LE;
+        case TokensTypes::TOKEN_GREATER_THAN: return IrOp::GT;
+        case TokensTypes::TOKEN_GREATER_EQUAL: return IrOp::GE;
+        case TokensTypes::TOKEN_LOGICAL_AND: return IrOp::AND;
+        default: return IrOp::OR;
+        }
+    }
+
+    static bool isCompare(IrOp op)
+    {
+        return op >= IrOp::EQ && op <= IrOp::GE;
+    }
+
+    static std::string name(Symbol symbol)
+    {
+        return Interner::getInstance().str(symbol);
+    }
+
+    void TypeChecker::check(const std::vector<ASTPtr> &items)
+    {
+        if (unit.functions.empty())
+        {
+            unit.functions.emplace_back();
+            unit.functions[0].lowered = true;
+        }
+        current = 0;
+
+        // the functions of the top level are bound first, so a body can call the ones declared after it.
+        // As a value a name still means what it does on the analyzer, only from its declaration on
+        std::vector<uint32_t> functions(items.size(), none);
+        for (std::size_t i = 0; i < items.size(); i++)
+        {
+            if (auto func = nodeAs<FunctionDefinitionNode>(items[i]))
+                functions[i] = declare(*func);
+        }
+        ahead.assign(unit.functions.size(), false);
+        for (uint32_t index : functions)
+        {
+            if (index != none)
+                ahead[index] = true;
+        }
+        for (std::size_t i = 0; i < items.size(); i++)
+        {
+            if (auto func = nodeAs<FunctionDefinitionNode>(items[i]))
+            {
+                if (functions[i] != none)
+                {
+                    ahead[functions[i]] = false;
+                    function(*func, functions[i]);
+                }
+                continue;
+            }
+            statement(items[i]);
+        }
+        ahead.clear();
+    }
+
+    // --- types ---
+
+    // the type an operand was given, NONE when it's missing
+    static ValueType typeOf(ASTPtr node)
+    {
+        return node ? node->value_type : ValueType::NONE;
+    }
+
+    ValueType TypeChecker::infer(ASTPtr node)
+    {
+        if (!node)
+            return ValueType::NONE;
+
+        // post-order on a stack, a node is typed after its operands: a generated chain of
+        // operators would nest a call per operator
+        std::size_t base = typing.size();
+        typing.push_back(Typing{node, false});
+        while (typing.size() > base)
+        {
+            if (typing.back().ready)
+            {
+                ASTPtr done = typing.back().node;
+                typing.pop_back();
+                done->value_type = typeNode(done);
+                count++;
+                continue;
+            }
+            typing.back().ready = true;
+            ASTPtr at = typing.back().node;
+            // the operands go on the stack backwards, so the errors come out left to right
+            auto push = [this](ASTPtr operand)
+            {
+                if (operand)
+                    typing.push_back(Typing{operand, false});
+            };
+            switch (at->kind)
+            {
+            case NodeKind::BIN_OP:
+                push(static_cast<BinOp *>(at)->right);
+                push(static_cast<BinOp *>(at)->left);
+                break;
+            case NodeKind::UNARY_OP:
+                push(static_cast<UnaryOp *>(at)->operand);
+                break;
+            case NodeKind::IDENTIFIER:
+            {
+                const std::vector<ASTPtr> &args = static_cast<IdentifierNode *>(at)->args;
+                for (auto arg = args.rbegin(); arg != args.rend(); ++arg)
+                    push(*arg);
+                break;
+            }
+            case NodeKind::OBJECT:
+                push(static_cast<ObjectNode *>(at)->val);
+                break;
+            case NodeKind::IF_EXPRESSION:
+                push(static_cast<IfExpressionNode *>(at)->val);
+                break;
+            default:
+                break;
+            }
+        }
+        return node->value_type;
+    }
+
+    ValueType TypeChecker::typeNode(ASTPtr node)
+    {
+        ValueType type = ValueType::NONE;
+        switch (node->kind)
+        {
+        case NodeKind::I32: type = ValueType::INT; break;
+        case NodeKind::I64: type = ValueType::INT64; break;
+        case NodeKind::F32: type = ValueType::FLOAT; break;
+        case NodeKind::F64: type = ValueType::DOUBLE; break;
+        case NodeKind::BYTE: type = ValueType::BYTE; break;
+        case NodeKind::TRUE_OR_FALSE: type = ValueType::BOOL; break;
+        case NodeKind::NIL: type = ValueType::OBJ_PTR; break;
+        case NodeKind::CINPUT: type = ValueType::STR; break;
+        case NodeKind::LITERAL:
+            checkFormat(static_cast<LiteralNode *>(node)->format);
+            type = ValueType::STR;
+            break;
+        case NodeKind::INTERPOLATION:
+            inferVariable(static_cast<InterpolationNode *>(node)->var_name, Use::HOLE);
+            type = ValueType::STR;
+            break;
+        case NodeKind::VARIABLE:
+            type = inferVariable(static_cast<VariableNode *>(node)->name, Use::VALUE);
+            break;
+        case NodeKind::BIN_OP:
+            type = inferBinary(*static_cast<BinOp *>(node));
+            break;
+        case NodeKind::UNARY_OP:
+            type = inferUnary(*static_cast<UnaryOp *>(node));
+            break;
+        case NodeKind::IDENTIFIER:
+            type = inferCall(*static_cast<IdentifierNode *>(node));
+            break;
+        case NodeKind::OBJECT:
+            // any value can be boxed, a call gives an obj already
+            if (typeOf(static_cast<ObjectNode *>(node)->val) != ValueType::NONE)
+                type = ValueType::OBJ_PTR;
+            break;
+        case NodeKind::IF_EXPRESSION:
+            type = inferCondition(*static_cast<IfExpressionNode *>(node));
+            break;
+        default:
+            break;
+        }
+        return type;
+    }
+
+    ValueType TypeChecker::inferVariable(Symbol symbol, Use use)
+    {
+        const auto *binding = scopes.find(symbol);
+        // a function of the top level before its declaration, as the analyzer sees it
+        if (binding && binding->value.type == ValueType::FUNC && binding->value.reg < ahead.size() && ahead[binding->value.reg])
+            binding = nullptr;
+        if (!binding)
+        {
+            // the analyzer checks neither the strings nor the print operands, the other names were reported by it
+            if (use == Use::HOLE)
+                LogErrors::getInstance().addError("Variable '" + name(symbol) + "' of '$[" + name(symbol) + "]' not declared!", 84, 0, 0);
+            else if (use == Use::OPERAND)
+                LogErrors::getInstance().addError("Variable '" + name(symbol) + "' not declared!", 67, 0, 0);
+            return ValueType::NONE;
+        }
+        const Local &var = binding->value;
+        if (var.type == ValueType::FUNC)
+        {
+            if (use == Use::VALUE)
+                return var.type;
+            if (use == Use::HOLE)
+                LogErrors::getInstance().addError("'" + name(symbol) + "' is a function, it can't be on '$[" + name(symbol) + "]'", 84, 0, 0);
+            else
+                LogErrors::getInstance().addError("'" + name(symbol) + "' is a function, it can't be printed", 84, 0, 0);
+            return ValueType::NONE;
+        }
+        if (!var.global && var.function != current)
+        {
+            LogErrors::getInstance().addError("Variable '" + name(symbol) + "' is a local of an enclosing function, it can't be used here (no closures yet)", 83, 0, 0);
+            return ValueType::NONE;
+        }
+        return var.type;
+    }
+
+    void TypeChecker::checkFormat(const FormatPlan &plan)
+    {
+        for (const FormatPlan::Slot &slot : plan.slots)
+            inferVariable(slot.name, slot.hole ? Use::HOLE : Use::OPERAND);
+    }
+
+    ValueType TypeChecker::inferBinary(BinOp &node)
+    {
+        ValueType left = typeOf(node.left);
+        ValueType right = typeOf(node.right);
+        if (left == ValueType::NONE || right == ValueType::NONE)
+            return ValueType::NONE;
+
+        switch (node.op)
+        {
+        case TokensTypes::TOKEN_LOGICAL_AND:
+        case TokensTypes::TOKEN_LOGICAL_OR:
+            if (left == ValueType::BOOL && right == ValueType::BOOL)
+                return ValueType::BOOL;
+            break;
+        case TokensTypes::TOKEN_EQUAL:
+        case TokensTypes::TOKEN_NOT_EQUAL:
+            if (left == right && (left == ValueType::BOOL || left == ValueType::STR))
+                return ValueType::BOOL;
+            [[fallthrough]];
+        case TokensTypes::TOKEN_LESS_THAN:
+        case TokensTypes::TOKEN_LESS_EQUAL:
+        case TokensTypes::TOKEN_GREATER_THAN:
+        case TokensTypes::TOKEN_GREATER_EQUAL:
+            if (isNumeric(left) && isNumeric(right))
+                return ValueType::BOOL;
+            break;
+        case TokensTypes::TOKEN_PLUS:
+        case TokensTypes::TOKEN_MINUS:
+        case TokensTypes::TOKEN_MULTIPLY:
+        case TokensTypes::TOKEN_DIVIDE:
+        case TokensTypes::TOKEN_MODULO:
+            if (isNumeric(left) && isNumeric(right))
+                return promoted(widest(left, right));
+            break;
+        case TokensTypes::TOKEN_REF:
+        case TokensTypes::TOKEN_BIT_OR:
+        case TokensTypes::TOKEN_BIT_XOR:
+        case TokensTypes::TOKEN_SHIFT_LEFT:
+        case TokensTypes::TOKEN_SHIFT_RIGHT:
+            if (isIntegral(left) && isIntegral(right))
+                return promoted(widest(left, right));
+            break;
+        default:
+            break;
+        }
+        LogErrors::getInstance().addError("Operator '" + Tokens::tokenTypeToString(node.op) + "' can't take " + valueTypeName(left) + " and " + valueTypeName(right), 80, 0, 0);
+        return ValueType::NONE;
+    }
+
+    ValueType TypeChecker::inferUnary(UnaryOp &node)
+    {
+        ValueType type = typeOf(node.operand);
+        if (type == ValueType::NONE)
+            return type;
+        if (node.op == TokensTypes::TOKEN_BIT_NOT ? isIntegral(type) : isNumeric(type))
+            return promoted(type);
+        LogErrors::getInstance().addError("Operator '" + Tokens::tokenTypeToString(node.op) + "' can't take " + valueTypeName(type), 80, 0, 0);
+        return ValueType::NONE;
+    }
+
+    ValueType TypeChecker::inferCall(IdentifierNode &node)
+    {
+        const auto *binding = scopes.find(node.name);
+        if (!binding)
+        {
+            LogErrors::getInstance().addError("Function '" + name(node.name) + "' not declared!", 82, 0, 0);
+            return ValueType::NONE;
+        }
+        if (binding->value.type != ValueType::FUNC)
+        {
+            LogErrors::getInstance().addError("'" + name(node.name) + "' is a " + valueTypeName(binding->value.type) + ", not a function", 82, 0, 0);
+            return ValueType::NONE;
+        }
+
+        const std::vector<ValueType> &params = unit.functions[binding->value.reg].params;
+        if (node.args.size() != params.size())
+        {
+            LogErrors::getInstance().addError("Function '" + name(node.name) + "' takes " + std::to_string(params.size()) + " args, " +
+                                              std::to_string(node.args.size()) + " given", 82, 0, 0);
+            return ValueType::NONE;
+        }
+        for (std::size_t i = 0; i < params.size(); i++)
+        {
+            if (!assignable(node.args[i], params[i]))
+                mismatch("Argument " + std::to_string(i + 1) + " of '" + name(node.name) + "'", params[i], node.args[i]);
+        }
+        // the functions don't declare what they return
+        return ValueType::OBJ_PTR;
+    }
+
+    ValueType TypeChecker::inferCondition(IfExpressionNode &node)
+    {
+        ValueType right = typeOf(node.val);
+        if (node.var_name == Interner::empty)
+            return right; // `true`, `false` or a condition folded to one of them
+
+        ValueType left = inferVariable(node.var_name, Use::VALUE);
+        if (left == ValueType::NONE || right == ValueType::NONE)
+            return ValueType::NONE;
+        bool equality = node.type == TokensTypes::TOKEN_EQUAL || node.type == TokensTypes::TOKEN_NOT_EQUAL;
+        if ((isNumeric(left) && isNumeric(right)) || (equality && left == right && (left == ValueType::BOOL || left == ValueType::STR)))
+            return ValueType::BOOL;
+        LogErrors::getInstance().addError("Operator '" + Tokens::tokenTypeToString(node.type) + "' can't take " + valueTypeName(left) + " and " + valueTypeName(right), 80, 0, 0);
+        return ValueType::NONE;
+    }
+
+    bool TypeChecker::assignable(ASTPtr node, ValueType to)
+    {
+        ValueType from = node ? node->value_type : ValueType::NONE;
+        if (from == ValueType::NONE || to == ValueType::NONE || from == to)
+            return true;
+        if (to == ValueType::OBJ_PTR)
+            return from != ValueType::FUNC;
+        if (!isNumeric(from) || !isNumeric(to))
+            return false;
+
+        // a literal goes to any type it fits in, the other values only to a wider type
+        switch (node->kind)
+        {
+        case NodeKind::I32:
+        case NodeKind::I64:
+        {
+            int64_t integer = 0;
+            double real = 0;
+            literalOf(node, integer, real);
+            if (to == ValueType::BYTE)
+                return integer >= 0 && integer <= 255;
+            if (to == ValueType::INT)
+                return integer >= INT32_MIN && integer <= INT32_MAX;
+            return true;
+        }
+        case NodeKind::F32:
+        case NodeKind::F64:
+            return to == ValueType::FLOAT || to == ValueType::DOUBLE;
+        default:
+            return from < to;
+        }
+    }
+
+    void TypeChecker::mismatch(const std::string &what, ValueType to, ASTPtr value)
+    {
+        ValueType from = value->value_type;
+        // an integer literal only fails on a narrower integer
+        bool integer = value->kind == NodeKind::I32 || value->kind == NodeKind::I64;
+        std::string why = (integer && isIntegral(to)) ? " (out of range)" : "";
+        LogErrors::getInstance().addError("Type mismatch: " + what + " is " + valueTypeName(to) + " but the value is " + valueTypeName(from) + why, 79, 0, 0);
+    }
+
+    // --- code ---
+
+    uint32_t TypeChecker::emit(IrOp op, ValueType type, uint32_t dst, uint32_t a, uint32_t b)
+    {
+        IrInst inst;
+        inst.op = op;
+        inst.type = type;
+        inst.dst = dst;
+        inst.a = a;
+        inst.b = b;
+        code().push_back(inst);
+        return here() - 1;
+    }
+
+    uint32_t TypeChecker::temp()
+    {
+        uint32_t reg = next_reg++;
+        IrFunction &func = unit.functions[current];
+        func.registers = std::max(func.registers, next_reg);
+        return reg;
+    }
+
+    void TypeChecker::number(ValueType type, uint32_t dst, int64_t integer, double real)
+    {
+        IrInst &inst = code()[emit(IrOp::CONST, type, dst)];
+        if (type == ValueType::FLOAT)
+            inst.setReal(static_cast<float>(real));
+        else if (type == ValueType::DOUBLE)
+            inst.setReal(real);
+        else
+            inst.setInteger(integer);
+    }
+
+    uint32_t TypeChecker::declare(FunctionDefinitionNode &node)
+    {
+        Local func;
+        func.type = ValueType::FUNC;
+        func.global = scopes.top() == 0;
+        func.reg = static_cast<uint32_t>(unit.functions.size());
+        func.function = current;
+        if (!scopes.declare(node.var_name, func))
+            return none; // reported by the analyzer
+
+        IrFunction ir;
+        ir.name = node.var_name;
+        for (ASTPtr arg : node.args)
+        {
+            if (auto param = nodeAs<ExpressionNode>(arg))
+                ir.params.push_back(valueTypeOf(param->type));
+        }
+        unit.functions.push_back(std::move(ir));
+        node.value_type = ValueType::FUNC;
+        return func.reg;
+    }
+
+    void TypeChecker::function(FunctionDefinitionNode &node, uint32_t index)
+    {
+        auto body = nodeAs<BlockNode>(node.block);
+        if (!body)
+            return; // a lazy body that was never parsed
+
+        uint32_t outer = current, outer_reg = next_reg;
+        current = index;
+        next_reg = 0;
+        unit.functions[index].lowered = true;
+
+        // the arguments and the top of the body share a frame, as on the analyzer
+        scopes.push();
+        std::size_t p = 0;
+        for (ASTPtr arg : node.args)
+        {
+            auto param = nodeAs<ExpressionNode>(arg);
+            if (!param)
+                continue;
+            Local var;
+            var.type = unit.functions[index].params[p++];
+            var.reg = temp();
+            var.function = index;
+            scopes.declare(param->var_name, var);
+        }
+        for (ASTPtr stmt : body->statements)
+            statement(stmt);
+        emit(IrOp::RET, ValueType::NONE, none); // the end of the body returns nothing
+        scopes.pop();
+
+        current = outer;
+        next_reg = outer_reg;
+    }
+
+    void TypeChecker::statement(ASTPtr node)
+    {
+        if (!node)
+            return;
+
+        // the temporaries of a statement are free after it, a variable keeps its register until its block ends
+        uint32_t mark = next_reg;
+        switch (node->kind)
+        {
+        case NodeKind::VARIABLE_DEFINITION:
+            define(*static_cast<VariableDefinitionNode *>(node));
+            return;
+        case NodeKind::FUNCTION_DEFINITION:
+        {
+            auto func = static_cast<FunctionDefinitionNode *>(node);
+            uint32_t index = declare(*func);
+            if (index != none)
+                function(*func, index);
+            break;
+        }
+        case NodeKind::BLOCK:
+            block(node);
+            break;
+        case NodeKind::IF_STATEMENT:
+        {
+            auto n = static_cast<IfStatement *>(node);
+            uint32_t skip = emit(IrOp::BRANCH_FALSE, ValueType::BOOL, none, condition(n->ifCondition), 0);
+            block(n->ifBranch);
+            if (!n->butBranch && !n->butCondition)
+            {
+                code()[skip].b = here();
+                break;
+            }
+            uint32_t end = emit(IrOp::JUMP, ValueType::NONE, none, 0);
+            code()[skip].b = here();
+            uint32_t skip_but = none;
+            if (n->butCondition)
+                skip_but = emit(IrOp::BRANCH_FALSE, ValueType::BOOL, none, condition(n->butCondition), 0);
+            block(n->butBranch);
+            if (skip_but != none)
+                code()[skip_but].b = here();
+            code()[end].a = here();
+            break;
+        }
+        case NodeKind::LOOP_CONDITION:
+        {
+            auto n = static_cast<LoopConditionNode *>(node);
+            uint32_t top = here();
+            uint32_t exit = emit(IrOp::BRANCH_FALSE, ValueType::BOOL, none, condition(n->condition), 0);
+            block(n->body);
+            emit(IrOp::JUMP, ValueType::NONE, none, top);
+            code()[exit].b = here();
+            break;
+        }
+        case NodeKind::LOOP:
+            loop(*static_cast<LoopNode *>(node));
+            break;
+        case NodeKind::PRINT:
+            print(IrOp::PRINT, static_cast<PrintNode *>(node)->format);
+            break;
+        case NodeKind::PRINT_NL:
+            print(IrOp::PRINT_NL, static_cast<PrintNl *>(node)->format);
+            break;
+        case NodeKind::PRINT_E:
+            print(IrOp::PRINT_E, static_cast<PrintE *>(node)->format);
+            break;
+        case NodeKind::PRINT_ERROR_LOG:
+        {
+            FormatPlan plan;
+            plan.appendText(static_cast<PrintErrorLog *>(node)->val);
+            print(IrOp::PRINT_E, plan);
+            break;
+        }
+        case NodeKind::RETURN:
+        {
+            ASTPtr val = static_cast<ReturnNode *>(node)->val;
+            ValueType type = infer(val);
+            if (val)
+                emit(IrOp::RET, type, none, value(val));
+            else
+                emit(IrOp::RET, ValueType::NONE, none);
+            break;
+        }
+        case NodeKind::FINISH:
+        {
+            auto n = static_cast<FinishNode *>(node);
+            uint32_t reg = temp();
+            if (n->value)
+            {
+                infer(n->value);
+                if (!assignable(n->value, ValueType::INT))
+                    mismatch("The exit code", ValueType::INT, n->value);
+                lower(n->value, reg, ValueType::INT);
+            }
+            else
+            {
+                number(ValueType::INT, reg, n->val, 0);
+            }
+            emit(IrOp::FIN, ValueType::INT, none, reg);
+            break;
+        }
+        case NodeKind::USING:
+        case NodeKind::NIL:
+            break;
+        default:
+            // a value on its own (cinput() and the like)
+            infer(node);
+            value(node);
+            break;
+        }
+        next_reg = mark;
+    }
+
+    void TypeChecker::block(ASTPtr node)
+    {
+        auto n = nodeAs<BlockNode>(node);
+        if (!n)
+            return;
+        uint32_t mark = next_reg;
+        scopes.push();
+        for (ASTPtr stmt : n->statements)
+            statement(stmt);
+        scopes.pop();
+        next_reg = mark;
+    }
+
+    void TypeChecker::define(VariableDefinitionNode &node)
+    {
+        ValueType type = valueTypeOf(node.type);
+        Local var;
+        var.type = type;
+        var.global = scopes.top() == 0;
+        var.reg = var.global ? static_cast<uint32_t>(unit.globals.size()) : next_reg;
+        var.function = current;
+        // bound before its value is checked, as on the analyzer, so both agree on what each name is
+        if (!scopes.declare(node.var_name, var))
+            return; // reported by the analyzer
+
+        node.value_type = type;
+        infer(node.val);
+        if (!assignable(node.val, type))
+            mismatch("Variable '" + name(node.var_name) + "'", type, node.val);
+
+        if (var.global)
+        {
+            unit.globals.push_back(type);
+            uint32_t mark = next_reg;
+            uint32_t reg = temp();
+            lower(node.val, reg, type);
+            emit(IrOp::STORE_GLOBAL, type, none, var.reg, reg);
+            next_reg = mark;
+            return;
+        }
+        temp();
+        lower(node.val, var.reg, type);
+        next_reg = var.reg + 1;
+    }
+
+    void TypeChecker::loop(LoopNode &node)
+    {
+        // `loop (i:type in n)` counts i from 0 while it's less than n
+        ValueType type = valueTypeOf(node.type);
+        infer(node.value);
+        if (!assignable(node.value, type))
+            mismatch("The limit of '" + name(node.var_name) + "'", type, node.value);
+        if (!isNumeric(type))
+        {
+            LogErrors::getInstance().addError("The loop variable '" + name(node.var_name) + "' must be a number, not " + valueTypeName(type), 81, 0, 0);
+            type = ValueType::NONE;
+        }
+
+        uint32_t limit = temp();
+        lower(node.value, limit, type);
+
+        scopes.push();
+        Local var;
+        var.type = type;
+        var.reg = temp();
+        var.function = current;
+        scopes.declare(node.var_name, var);
+
+        number(type, var.reg, 0, 0);
+        uint32_t top = here();
+        uint32_t test = temp();
+        emit(IrOp::LT, type, test, var.reg, limit);
+        uint32_t exit = emit(IrOp::BRANCH_FALSE, ValueType::BOOL, none, test, 0);
+        block(node.block);
+        uint32_t one = temp();
+        number(type, one, 1, 1);
+        emit(IrOp::ADD, type, var.reg, var.reg, one);
+        emit(IrOp::JUMP, ValueType::NONE, none, top);
+        code()[exit].b = here();
+        scopes.pop();
+    }
+
+    void TypeChecker::print(IrOp op, const FormatPlan &plan)
+    {
+        checkFormat(plan);
+        uint32_t reg = temp();
+        text(plan, reg);
+        emit(op, ValueType::NONE, none, reg);
+    }
+
+    uint32_t TypeChecker::condition(ASTPtr node)
+    {
+        ValueType type = infer(node);
+        if (type != ValueType::BOOL && type != ValueType::NONE)
+            LogErrors::getInstance().addError(std::string("A condition must be a bool, not ") + valueTypeName(type), 81, 0, 0);
+        return value(node);
+    }
+
+    uint32_t TypeChecker::load(Symbol symbol, uint32_t dst)
+    {
+        const auto *binding = scopes.find(symbol);
+        if (binding && binding->value.type != ValueType::FUNC)
+        {
+            const Local &var = binding->value;
+            if (!var.global)
+            {
+                if (dst == none)
+                    return var.reg;
+                emit(IrOp::MOVE, var.type, dst, var.reg);
+                return dst;
+            }
+            if (dst == none)
+                dst = temp();
+            emit(IrOp::LOAD_GLOBAL, var.type, dst, var.reg);
+            return dst;
+        }
+        // an unknown name (already reported) or a function as a value
+        return dst == none ? temp() : dst;
+    }
+
+    uint32_t TypeChecker::text(const FormatPlan &plan, uint32_t dst)
+    {
+        if (!plan.hasSlots())
+        {
+            emit(IrOp::CONST, ValueType::STR, dst, static_cast<uint32_t>(unit.strings.size()));
+            unit.strings.push_back(plan.text);
+            return dst;
+        }
+
+        // the slots as charseqs, one after the other
+        uint32_t first = next_reg;
+        for (std::size_t i = 0; i < plan.slots.size(); i++)
+            temp();
+        for (std::size_t i = 0; i < plan.slots.size(); i++)
+        {
+            uint32_t reg = first + static_cast<uint32_t>(i);
+            const auto *binding = scopes.find(plan.slots[i].name);
+            ValueType type = binding ? binding->value.type : ValueType::NONE;
+            if (type == ValueType::STR || type == ValueType::NONE || type == ValueType::FUNC)
+            {
+                load(plan.slots[i].name, reg);
+                continue;
+            }
+            uint32_t src = load(plan.slots[i].name, none);
+            code()[emit(IrOp::CONVERT, ValueType::STR, reg, src)].from = type;
+        }
+        emit(IrOp::FORMAT, ValueType::STR, dst, static_cast<uint32_t>(unit.formats.size()), first);
+        unit.formats.push_back(plan);
+        return dst;
+    }
+
+    uint32_t TypeChecker::value(ASTPtr node)
+    {
+        if (auto var = nodeAs<VariableNode>(node))
+            return load(var->name, none);
+        uint32_t reg = temp();
+        emitInto(node, reg);
+        return reg;
+    }
+
+    uint32_t TypeChecker::operand(ASTPtr node, ValueType as)
+    {
+        Operand o;
+        start(node, as, none, o);
+        emitInto(o.node, o.into);
+        finish(o);
+        return o.reg;
+    }
+
+    void TypeChecker::lower(ASTPtr node, uint32_t dst, ValueType as)
+    {
+        Operand o;
+        start(node, as, dst, o);
+        emitInto(o.node, o.into);
+        finish(o);
+    }
+
+    void TypeChecker::start(ASTPtr node, ValueType as, uint32_t dst, Operand &o)
+    {
+        ValueType type = typeOf(node);
+        o.node = nullptr;
+        o.convert = false;
+        if (dst == none)
+        {
+            // an operand of its own type is its value, a local on its register
+            if (node && type == as)
+            {
+                if (auto var = nodeAs<VariableNode>(node))
+                {
+                    o.reg = load(var->name, none);
+                    return;
+                }
+                o.reg = o.into = temp();
+                o.node = node;
+                return;
+            }
+            dst = temp();
+        }
+        o.reg = dst;
+        if (type == ValueType::NONE || as == ValueType::NONE || type == as)
+        {
+            o.into = dst;
+            o.node = node;
+            return;
+        }
+        // a literal is made on the type it goes to, with no conversion at run time
+        if (isNumericLiteral(node) && isNumeric(as))
+        {
+            int64_t integer = 0;
+            double real = 0;
+            if (literalOf(node, integer, real))
+                integer = static_cast<int64_t>(real);
+            else
+                real = static_cast<double>(integer);
+            number(as, dst, integer, real);
+            return;
+        }
+        o.convert = true;
+        o.as = as;
+        o.from = type;
+        if (auto var = nodeAs<VariableNode>(node))
+        {
+            o.src = load(var->name, none);
+            return;
+        }
+        o.src = o.into = temp();
+        o.node = node;
+    }
+
+    void TypeChecker::finish(const Operand &o)
+    {
+        if (o.convert)
+            code()[emit(o.as == ValueType::OBJ_PTR ? IrOp::BOX : IrOp::CONVERT, o.as, o.reg, o.src)].from = o.from;
+    }
+
+    void TypeChecker::emitInto(ASTPtr node, uint32_t dst)
+    {
+        if (!node)
+            return;
+        if (node->kind != NodeKind::BIN_OP && node->kind != NodeKind::UNARY_OP)
+        {
+            emitValue(node, dst);
+            return;
+        }
+
+        // the operators on a stack, each one waits on the code of its operands: a generated
+        // chain of them would nest a few calls per operator
+        std::size_t base = lowering.size();
+        lowering.push_back(Lowering{node, dst, 0, ValueType::NONE, {}, {}});
+        while (lowering.size() > base)
+        {
+            Lowering &f = lowering.back();
+            Operand *next = nullptr;
+            if (f.node->kind == NodeKind::UNARY_OP)
+            {
+                auto n = static_cast<UnaryOp *>(f.node);
+                if (f.step++ == 0)
+                {
+                    start(n->operand, n->value_type, none, f.left);
+                    next = &f.left;
+                }
+                else
+                {
+                    finish(f.left);
+                    IrOp op = n->op == TokensTypes::TOKEN_MINUS ? IrOp::NEG : n->op == TokensTypes::TOKEN_BIT_NOT ? IrOp::BIT_NOT : IrOp::MOVE;
+                    emit(op, n->value_type, f.dst, f.left.reg);
+                    lowering.pop_back();
+                    continue;
+                }
+            }
+            else
+            {
+                auto n = static_cast<BinOp *>(f.node);
+                switch (f.step++)
+                {
+                case 0:
+                    // the compares work on the widest type of the two, the others on the type of the result
+                    f.type = n->value_type;
+                    if (isCompare(binaryOp(n->op)))
+                        f.type = widest(n->left->value_type, n->right->value_type);
+                    start(n->left, f.type, none, f.left);
+                    next = &f.left;
+                    break;
+                case 1:
+                    finish(f.left);
+                    start(n->right, f.type, none, f.right);
+                    next = &f.right;
+                    break;
+                default:
+                    finish(f.right);
+                    emit(binaryOp(n->op), f.type, f.dst, f.left.reg, f.right.reg);
+                    lowering.pop_back();
+                    continue;
+                }
+            }
+
+            // f goes stale here, the stack can grow
+            ASTPtr operand = next->node;
+            uint32_t into = next->into;
+            if (!operand)
+                continue;
+            if (operand->kind == NodeKind::BIN_OP || operand->kind == NodeKind::UNARY_OP)
+                lowering.push_back(Lowering{operand, into, 0, ValueType::NONE, {}, {}});
+            else
+                emitValue(operand, into);
+        }
+    }
+
+    void TypeChecker::emitValue(ASTPtr node, uint32_t dst)
+    {
+        switch (node->kind)
+        {
+        case NodeKind::I32:
+        case NodeKind::I64:
+        case NodeKind::F32:
+        case NodeKind::F64:
+        case NodeKind::BYTE:
+        {
+            int64_t integer = 0;
+            double real = 0;
+            literalOf(node, integer, real);
+            number(node->value_type, dst, integer, real);
+            break;
+        }
+        case NodeKind::TRUE_OR_FALSE:
+            number(ValueType::BOOL, dst, static_cast<TrueOrFalseNode *>(node)->val, 0);
+            break;
+        case NodeKind::NIL:
+            number(ValueType::OBJ_PTR, dst, 0, 0);
+            break;
+        case NodeKind::LITERAL:
+            text(static_cast<LiteralNode *>(node)->format, dst);
+            break;
+        case NodeKind::INTERPOLATION:
+        {
+            FormatPlan plan;
+            plan.appendSlot(static_cast<InterpolationNode *>(node)->var_name, true);
+            text(plan, dst);
+            break;
+        }
+        case NodeKind::CINPUT:
+        {
+            auto n = static_cast<CinputNode *>(node);
+            FormatPlan prompt;
+            prompt.appendText(n->msg);
+            emit(IrOp::INPUT, ValueType::STR, dst, text(prompt, temp()), static_cast<uint32_t>(n->time));
+            break;
+        }
+        case NodeKind::VARIABLE:
+            load(static_cast<VariableNode *>(node)->name, dst);
+            break;
+        case NodeKind::OBJECT:
+            lower(static_cast<ObjectNode *>(node)->val, dst, ValueType::OBJ_PTR);
+            break;
+        case NodeKind::IDENTIFIER:
+        {
+            auto n = static_cast<IdentifierNode *>(node);
+            const auto *binding = scopes.find(n->name);
+            if (!binding || binding->value.type != ValueType::FUNC)
+                break;
+            uint32_t callee = binding->value.reg;
+            // the arguments on consecutive registers, as the parameters of the callee
+            uint32_t first = next_reg;
+            for (std::size_t i = 0; i < n->args.size(); i++)
+                temp();
+            for (std::size_t i = 0; i < n->args.size(); i++)
+            {
+                const std::vector<ValueType> &params = unit.functions[callee].params;
+                ValueType as = i < params.size() ? params[i] : n->args[i]->value_type;
+                lower(n->args[i], first + static_cast<uint32_t>(i), as);
+            }
+            emit(IrOp::CALL, ValueType::OBJ_PTR, dst, callee, first);
+            break;
+        }
+        case NodeKind::IF_EXPRESSION:
+        {
+            auto n = static_cast<IfExpressionNode *>(node);
+            if (n->var_name == Interner::empty)
+            {
+                lower(n->val, dst, ValueType::BOOL);
+                break;
+            }
+            const auto *binding = scopes.find(n->var_name);
+            ValueType left = binding ? binding->value.type : ValueType::NONE;
+            ValueType type = widest(left, n->val ? n->val->value_type : ValueType::NONE);
+            uint32_t a = load(n->var_name, none);
+            if (left != type && isNumeric(left))
+            {
+                uint32_t wide = temp();
+                code()[emit(IrOp::CONVERT, type, wide, a)].from = left;
+                a = wide;
+            }
+            uint32_t b = operand(n->val, type);
+            emit(binaryOp(n->type), type, dst, a, b);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
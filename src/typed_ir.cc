@@ -0,0 +1,174 @@
+// Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "../src/includes/typed_ir.hpp"
+
+namespace Rythin
+{
+    const char *irOpName(IrOp op)
+    {
+        switch (op)
+        {
+        case IrOp::CONST: return "const";
+        case IrOp::MOVE: return "move";
+        case IrOp::LOAD_GLOBAL: return "load_global";
+        case IrOp::STORE_GLOBAL: return "store_global";
+        case IrOp::CONVERT: return "convert";
+        case IrOp::BOX: return "box";
+        case IrOp::NEG: return "neg";
+        case IrOp::BIT_NOT: return "bit_not";
+        case IrOp::ADD: return "add";
+        case IrOp::SUB: return "sub";
+        case IrOp::MUL: return "mul";
+        case IrOp::DIV: return "div";
+        case IrOp::MOD: return "mod";
+        case IrOp::BIT_AND: return "bit_and";
+        case IrOp::BIT_OR: return "bit_or";
+        case IrOp::BIT_XOR: return "bit_xor";
+        case IrOp::SHL: return "shl";
+        case IrOp::SHR: return "shr";
+        case IrOp::EQ: return "eq";
+        case IrOp::NE: return "ne";
+        case IrOp::LT: return "lt";
+        case IrOp::LE: return "le";
+        case IrOp::GT: return "gt";
+        case IrOp::GE: return "ge";
+        case IrOp::AND: return "and";
+        case IrOp::OR: return "or";
+        case IrOp::FORMAT: return "format";
+        case IrOp::PRINT: return "print";
+        case IrOp::PRINT_NL: return "print_nl";
+        case IrOp::PRINT_E: return "print_e";
+        case IrOp::INPUT: return "input";
+        case IrOp::CALL: return "call";
+        case IrOp::JUMP: return "jump";
+        case IrOp::BRANCH_FALSE: return "branch_false";
+        case IrOp::RET: return "ret";
+        case IrOp::FIN: return "fin";
+        }
+        return "?";
+    }
+
+    void IrUnit::clear()
+    {
+        functions.clear();
+        globals.clear();
+        strings.clear();
+        formats.clear();
+    }
+
+    std::size_t IrUnit::instructions() const
+    {
+        std::size_t count = 0;
+        for (const IrFunction &func : functions)
+            count += func.code.size();
+        return count;
+    }
+
+    static void constant(std::ostream &out, const IrUnit &unit, const IrInst &inst)
+    {
+        switch (inst.type)
+        {
+        case ValueType::BOOL: out << (inst.integer() ? "true" : "false"); break;
+        case ValueType::FLOAT:
+        case ValueType::DOUBLE: out << inst.real(); break;
+        case ValueType::STR: out << '"' << unit.strings[inst.a] << '"'; break;
+        default: out << inst.integer(); break;
+        }
+    }
+
+    static void instruction(std::ostream &out, const IrUnit &unit, const IrInst &inst)
+    {
+        out << irOpName(inst.op);
+        if (inst.type != ValueType::NONE)
+            out << '.' << valueTypeName(inst.type);
+        if (inst.op == IrOp::CONVERT || inst.op == IrOp::BOX)
+            out << " (from " << valueTypeName(inst.from) << ")";
+        out << ' ';
+
+        switch (inst.op)
+        {
+        case IrOp::CONST:
+            out << 'r' << inst.dst << ", ";
+            constant(out, unit, inst);
+            break;
+        case IrOp::LOAD_GLOBAL:
+            out << 'r' << inst.dst << ", g" << inst.a;
+            break;
+        case IrOp::STORE_GLOBAL:
+            out << 'g' << inst.a << ", r" << inst.b;
+            break;
+        case IrOp::FORMAT:
+            out << 'r' << inst.dst << ", \"" << unit.formats[inst.a].text << "\", r" << inst.b << "...";
+            break;
+        case IrOp::PRINT:
+        case IrOp::PRINT_NL:
+        case IrOp::PRINT_E:
+        case IrOp::RET:
+        case IrOp::FIN:
+            if (inst.a != IrInst::none)
+                out << 'r' << inst.a;
+            break;
+        case IrOp::INPUT:
+            out << 'r' << inst.dst << ", r" << inst.a << ", " << inst.b;
+            break;
+        case IrOp::CALL:
+            out << 'r' << inst.dst << ", " << Interner::getInstance().spelling(unit.functions[inst.a].name) << ", r" << inst.b << "...";
+            break;
+        case IrOp::JUMP:
+            out << inst.a;
+            break;
+        case IrOp::BRANCH_FALSE:
+            out << 'r' << inst.a << ", " << inst.b;
+            break;
+        default:
+            out << 'r' << inst.dst << ", r" << inst.a;
+            if (inst.b != IrInst::none)
+                out << ", r" << inst.b;
+            break;
+        }
+    }
+
+    void IrUnit::dump(std::ostream &out) const
+    {
+        for (std::size_t g = 0; g < globals.size(); g++)
+            out << "global g" << g << ": " << valueTypeName(globals[g]) << "\n";
+
+        for (std::size_t f = 0; f < functions.size(); f++)
+        {
+            const IrFunction &func = functions[f];
+            if (f == 0)
+                out << "top level";
+            else
+                out << "func " << Interner::getInstance().spelling(func.name);
+            out << " (";
+            for (std::size_t p = 0; p < func.params.size(); p++)
+                out << (p ? ", " : "") << valueTypeName(func.params[p]);
+            out << ")";
+            if (!func.lowered)
+            {
+                out << ": not parsed (lazy)\n";
+                continue;
+            }
+            out << ": " << func.registers << " registers\n";
+            for (std::size_t i = 0; i < func.code.size(); i++)
+            {
+                out << "    " << i << "\t";
+                instruction(out, *this, func.code[i]);
+                out << "\n";
+            }
+        }
+    }
+}
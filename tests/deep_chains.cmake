@@ -0,0 +1,59 @@
+# Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+# very long expressions through the whole of rhythin -f (parser, folder, semantic and type pass,
+# and the AST cache both ways): none of the passes may take a C++ call per operator.
+# run by ctest: cmake -DRHYTHIN=<rhythin> -DWORK_DIR=<dir for the sources> -P deep_chains.cmake
+
+if(NOT RHYTHIN OR NOT WORK_DIR)
+  message(FATAL_ERROR "usage: cmake -DRHYTHIN=<rhythin> -DWORK_DIR=<dir> -P deep_chains.cmake")
+endif()
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/cache")
+
+# runs the source with no cache, then twice on an empty cache (stored, then loaded), each one must exit with 0
+function(check name code)
+  set(source "${WORK_DIR}/${name}.ry")
+  file(WRITE "${source}" "${code}")
+  set(ENV{RHYTHIN_CACHE_DIR} "${WORK_DIR}/cache/${name}")
+  foreach(run "--no-cache" "--lazy" "" "")
+    execute_process(COMMAND "${RHYTHIN}" -f "${source}" ${run} RESULT_VARIABLE result OUTPUT_VARIABLE out ERROR_VARIABLE out)
+    if(NOT result STREQUAL "0")
+      message(FATAL_ERROR "${name} (${run}): ${result}\n${out}")
+    endif()
+  endforeach()
+  message(STATUS "${name}: ok")
+endfunction()
+
+# a constant chain, folded to one literal
+string(REPEAT "1 + " 29999 terms)
+check(constant_sum "def total:int32 := ${terms}1\nprint(\"$[total]\")\n")
+
+# the same on an argument, left for run time
+string(REPEAT "a + " 29999 terms)
+check(sum "def sum:func(a:int32) -> [\n    def total:int32 := ${terms}a\n    print(\"$[total]\")\n]\n")
+
+# prefix operators, a UnaryOp inside the other
+string(REPEAT "-" 50000 signs)
+check(negations "def negate:func(a:int32) -> [\n    def total:int32 := ${signs}a\n    print(\"$[total]\")\n]\n")
+
+# parentheses, each one the right operand of the one before
+string(REPEAT "(a + " 30000 open)
+string(REPEAT ")" 30000 close)
+check(parentheses "def nest:func(a:int32) -> [\n    def total:int32 := ${open}a${close}\n    print(\"$[total]\")\n]\n")
+
+# every kind of operator mixed, with conversions to float64 on the way
+string(REPEAT "-a * 2 - b / 3 << 1 | a & ~b ^ " 5000 terms)
+check(mixed "def mix:func(a:int32, b:byte) -> [\n    def total:int64 := ${terms}a\n    def ratio:float64 := ${terms}b\n]\n")
@@ -0,0 +1,72 @@
+# Copyright (C) 2025 Rafael de Sousa (el-rafa-dev)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+# blocks nested as deep as --max-nesting takes (Parser::deepest_max_depth), through the whole of
+# rhythin -f: the analyzer and the type checker still take a call per block, so this is what
+# the cap is measured on (it must pass on an unoptimized build too), and one level more is an error.
+# run by ctest: cmake -DRHYTHIN=<rhythin> -DWORK_DIR=<dir for the sources> -P deep_nesting.cmake
+
+if(NOT RHYTHIN OR NOT WORK_DIR)
+  message(FATAL_ERROR "usage: cmake -DRHYTHIN=<rhythin> -DWORK_DIR=<dir> -P deep_nesting.cmake")
+endif()
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/cache")
+
+set(deepest 4096)
+math(EXPR over "${deepest} + 1")
+
+# writes the header nested depth times around a print, and runs it with every mode of the driver
+function(check name header depth expected)
+  string(REPEAT "${header}" ${depth} open)
+  string(REPEAT "]\n" ${depth} close)
+  set(source "${WORK_DIR}/${name}_${depth}.ry")
+  file(WRITE "${source}" "${open}print(\"deep\")\n${close}")
+  foreach(run "--no-cache" "--lazy" "--stream" "--dump-ir")
+    if(run STREQUAL "--lazy" AND name STREQUAL "function" AND NOT expected STREQUAL "0")
+      continue() # a body never called isn't parsed on a lazy run, so it's never too deep
+    endif()
+    execute_process(COMMAND "${RHYTHIN}" -f "${source}" --max-nesting ${deepest} ${run}
+                    RESULT_VARIABLE result OUTPUT_VARIABLE out ERROR_VARIABLE out)
+    if(NOT result STREQUAL "${expected}")
+      message(FATAL_ERROR "${name} ${depth} deep (${run}): ${result}, expected ${expected}\n${out}")
+    endif()
+  endforeach()
+  message(STATUS "${name} ${depth} deep: ${expected}")
+endfunction()
+
+foreach(depth ${deepest} ${over})
+  # 58: nested more than --max-nesting
+  set(expected 0)
+  if(depth GREATER deepest)
+    set(expected 58)
+  endif()
+  check(if "if (true) -> [\n" ${depth} ${expected})
+  check(loop "loop (i:int32 in 3) -> [\n" ${depth} ${expected})
+  check(loop_condition "loop (false) -> [\n" ${depth} ${expected})
+  check(function "def inner:func(a:int32) -> [\n" ${depth} ${expected})
+endforeach()
+
+# the default limit, with the AST cache stored and then loaded
+string(REPEAT "if (true) -> [\nloop (i:int32 in 2) -> [\n" 512 open)
+string(REPEAT "]\n]\n" 512 close)
+file(WRITE "${WORK_DIR}/default.ry" "${open}print(\"deep\")\n${close}")
+set(ENV{RHYTHIN_CACHE_DIR} "${WORK_DIR}/cache")
+foreach(run 1 2)
+  execute_process(COMMAND "${RHYTHIN}" -f "${WORK_DIR}/default.ry" RESULT_VARIABLE result OUTPUT_VARIABLE out ERROR_VARIABLE out)
+  if(NOT result STREQUAL "0")
+    message(FATAL_ERROR "default limit (run ${run}): ${result}\n${out}")
+  endif()
+endforeach()
+message(STATUS "default limit: 0")